@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Minimal benchmark harness for the host build.
+ * Every benchmark receives the number of iterations it has to run, the harness scales the
+ * iteration count until a run takes at least the configured minimum time.
+ */
+
+class BenchState {
+public:
+    explicit BenchState(uint64_t iterations) : mIterations(iterations) {
+        ResetTimer();
+    }
+
+    uint64_t iterations() const {
+        return mIterations;
+    }
+
+    /**
+     * Discards the time measured so far, e.g. after an expensive setup.
+     */
+    void ResetTimer() {
+        mElapsed = std::chrono::nanoseconds::zero();
+        mStart   = std::chrono::steady_clock::now();
+        mRunning = true;
+    }
+
+    void PauseTiming() {
+        if (mRunning) {
+            mElapsed += std::chrono::steady_clock::now() - mStart;
+            mRunning = false;
+        }
+    }
+
+    void ResumeTiming() {
+        if (!mRunning) {
+            mStart   = std::chrono::steady_clock::now();
+            mRunning = true;
+        }
+    }
+
+    std::chrono::nanoseconds elapsed() {
+        PauseTiming();
+        return mElapsed;
+    }
+
+    /**
+     * Optional: number of bytes processed per iteration, used to print a throughput.
+     */
+    void SetBytesPerIteration(uint64_t bytes) {
+        mBytesPerIteration = bytes;
+    }
+
+    uint64_t bytesPerIteration() const {
+        return mBytesPerIteration;
+    }
+
+private:
+    uint64_t mIterations;
+    uint64_t mBytesPerIteration = 0;
+    std::chrono::steady_clock::time_point mStart;
+    std::chrono::nanoseconds mElapsed{};
+    bool mRunning = false;
+};
+
+typedef void (*BenchFunction)(BenchState &state);
+
+struct BenchRegistrar {
+    BenchRegistrar(const char *name, BenchFunction func);
+};
+
+[[noreturn]] void Bench_Fail(const char *file, int line, const char *expr);
+
+template<typename T>
+inline void Bench_DoNotOptimize(T const &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#define BENCH_CHECK(EXPR)                            \
+    do {                                             \
+        if (!(EXPR)) {                               \
+            Bench_Fail(__FILE__, __LINE__, #EXPR);   \
+        }                                            \
+    } while (0)
+
+#define RPXLOADER_BENCHMARK(NAME)                                          \
+    static void Bench_##NAME(BenchState &state);                           \
+    static BenchRegistrar sBenchRegistrar_##NAME(#NAME, &Bench_##NAME);    \
+    static void Bench_##NAME(BenchState &state)
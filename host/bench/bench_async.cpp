@@ -0,0 +1,241 @@
+#include "bench_corpus.h"
+#include "bench_fixture.h"
+#include <mutex>
+#include <rpxloader/async.h>
+#include <thread>
+#include <vector>
+
+#define ASYNC_BENCH_DIR      "bench/async/"
+#define ASYNC_LAUNCH_DELAY   20000000 // 20ms
+#define ASYNC_SLOW_RPX_SIZE  0x400000
+
+namespace {
+    struct CallbackRecord {
+        uint32_t id;
+        RPXLoaderStatus result;
+        RPXLoaderAsyncState state;
+    };
+
+    struct CallbackLog {
+        std::mutex mutex;
+        std::vector<CallbackRecord> records;
+    };
+
+    struct CallbackContext {
+        CallbackLog *log;
+        uint32_t id;
+    };
+
+    void RecordCallback(RPXLoaderAsyncLaunch *handle, RPXLoaderStatus result, void *context) {
+        auto ctx = (CallbackContext *) context;
+        std::lock_guard<std::mutex> lock(ctx->log->mutex);
+        ctx->log->records.push_back({ctx->id, result, RPXLoader_AsyncGetState(handle)});
+    }
+
+    void CreateAsyncFiles() {
+        static bool sCreated = false;
+        if (sCreated) {
+            return;
+        }
+        for (uint32_t i = 0; i < 3; i++) {
+            BENCH_CHECK(Corpus_WriteSDFile(ASYNC_BENCH_DIR "app" + std::to_string(i) + ".rpx", Corpus_BuildRPX(0x1000, i).data));
+        }
+        auto broken = Corpus_BuildRPX(0x1000, 5).data;
+        broken[7]   = 0;
+        BENCH_CHECK(Corpus_WriteSDFile(ASYNC_BENCH_DIR "broken.rpx", broken));
+        BENCH_CHECK(Corpus_WriteSDFile(ASYNC_BENCH_DIR "slow.rpx", Corpus_BuildRPX(ASYNC_SLOW_RPX_SIZE, 6).data));
+        sCreated = true;
+    }
+
+    void WaitForState(RPXLoaderAsyncLaunch *handle, RPXLoaderAsyncState state) {
+        while (RPXLoader_AsyncGetState(handle) < state) {
+            std::this_thread::yield();
+        }
+    }
+
+    RPXLoaderStatus GetResult(RPXLoaderAsyncLaunch *handle, RPXLoaderPreflightResult *outPreflight = nullptr) {
+        RPXLoaderStatus result = RPX_LOADER_RESULT_UNKNOWN_ERROR;
+        BENCH_CHECK(RPXLoader_AsyncGetResult(handle, &result, outPreflight) == RPX_LOADER_RESULT_SUCCESS);
+        return result;
+    }
+
+    void CheckOrdering() {
+        CallbackLog log;
+        CallbackContext contexts[3] = {{&log, 0}, {&log, 1}, {&log, 2}};
+        RPXLoaderAsyncLaunch *handles[3];
+        for (uint32_t i = 0; i < 3; i++) {
+            RPXLoaderAsyncOptions options = {RPX_LOADER_PREFLIGHT_MODE_FULL, 0, RecordCallback, &contexts[i]};
+            auto path                     = ASYNC_BENCH_DIR "app" + std::to_string(i) + ".rpx";
+            auto res                      = i < 2 ? RPXLoader_PrepareLaunchFromSDAsync(path.c_str(), &options, &handles[i])
+                                                  : RPXLoader_LaunchHomebrewAsync(path.c_str(), &options, &handles[i]);
+            BENCH_CHECK(res == RPX_LOADER_RESULT_SUCCESS);
+        }
+        for (auto handle : handles) {
+            BENCH_CHECK(RPXLoader_AsyncWait(handle) == RPX_LOADER_RESULT_SUCCESS);
+            BENCH_CHECK(RPXLoader_AsyncGetState(handle) == RPX_LOADER_ASYNC_STATE_COMPLETED);
+            BENCH_CHECK(GetResult(handle) == RPX_LOADER_RESULT_SUCCESS);
+            RPXLoader_AsyncFree(handle);
+        }
+        // Requests reach the module in the order they have been made, callbacks run after the request completed.
+        BENCH_CHECK(log.records.size() == 3);
+        for (uint32_t i = 0; i < 3; i++) {
+            BENCH_CHECK(log.records[i].id == i && log.records[i].result == RPX_LOADER_RESULT_SUCCESS);
+            BENCH_CHECK(log.records[i].state == RPX_LOADER_ASYNC_STATE_COMPLETED);
+        }
+        BENCH_CHECK(MockRPXLoader_GetCalls().prepareLaunchFromSD == 2);
+        BENCH_CHECK(MockRPXLoader_GetCalls().launchHomebrew == 1);
+        BENCH_CHECK(MockRPXLoader_GetPreparedPath() == ASYNC_BENCH_DIR "app2.rpx");
+    }
+
+    void CheckValidation() {
+        RPXLoaderAsyncLaunch *handle = nullptr;
+        RPXLoaderPreflightResult preflight;
+        BENCH_CHECK(RPXLoader_LaunchHomebrewAsync(ASYNC_BENCH_DIR "broken.rpx", nullptr, &handle) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_AsyncWait(handle) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+        BENCH_CHECK(GetResult(handle, &preflight) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+        BENCH_CHECK(preflight.error == RPX_LOADER_PREFLIGHT_BAD_HEADER);
+        RPXLoader_AsyncFree(handle);
+
+        BENCH_CHECK(RPXLoader_LaunchHomebrewAsync(ASYNC_BENCH_DIR "missing.rpx", nullptr, &handle) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_AsyncWait(handle) == RPX_LOADER_RESULT_NOT_FOUND);
+        RPXLoader_AsyncFree(handle);
+
+        // Without validation the module decides.
+        RPXLoaderAsyncOptions options = {RPX_LOADER_PREFLIGHT_MODE_HEADERS_ONLY, 1, nullptr, nullptr};
+        BENCH_CHECK(RPXLoader_LaunchHomebrewAsync(ASYNC_BENCH_DIR "broken.rpx", &options, &handle) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_AsyncWait(handle) == RPX_LOADER_RESULT_SUCCESS);
+        RPXLoader_AsyncFree(handle);
+        BENCH_CHECK(MockRPXLoader_GetCalls().launchHomebrew == 1);
+    }
+
+    void CheckCancellation() {
+        MockRPXLoader_SetCallDelay(ASYNC_LAUNCH_DELAY);
+        CallbackLog log;
+        CallbackContext contexts[2] = {{&log, 0}, {&log, 1}};
+        RPXLoaderAsyncOptions options[2] = {{RPX_LOADER_PREFLIGHT_MODE_HEADERS_ONLY, 0, RecordCallback, &contexts[0]},
+                                            {RPX_LOADER_PREFLIGHT_MODE_HEADERS_ONLY, 0, RecordCallback, &contexts[1]}};
+        RPXLoaderAsyncLaunch *first  = nullptr;
+        RPXLoaderAsyncLaunch *second = nullptr;
+        BENCH_CHECK(RPXLoader_PrepareLaunchFromSDAsync(ASYNC_BENCH_DIR "app0.rpx", &options[0], &first) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_PrepareLaunchFromSDAsync(ASYNC_BENCH_DIR "app1.rpx", &options[1], &second) == RPX_LOADER_RESULT_SUCCESS);
+
+        // The worker is stuck in the module call of the first request, the second one is still queued.
+        WaitForState(first, RPX_LOADER_ASYNC_STATE_LAUNCHING);
+        BENCH_CHECK(RPXLoader_AsyncGetState(second) == RPX_LOADER_ASYNC_STATE_QUEUED);
+        BENCH_CHECK(RPXLoader_AsyncCancel(first) == RPX_LOADER_RESULT_NOT_AVAILABLE);
+        BENCH_CHECK(RPXLoader_AsyncCancel(second) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_AsyncCancel(second) == RPX_LOADER_RESULT_NOT_AVAILABLE);
+        BENCH_CHECK(RPXLoader_AsyncGetState(second) == RPX_LOADER_ASYNC_STATE_CANCELLED);
+
+        // The caller keeps running while the module call is in progress.
+        uint32_t frames = 0;
+        RPXLoaderStatus result;
+        while (RPXLoader_AsyncGetResult(first, &result, nullptr) == RPX_LOADER_RESULT_NOT_AVAILABLE) {
+            frames++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        BENCH_CHECK(frames > 0 && result == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_AsyncWait(second) == RPX_LOADER_RESULT_CANCELLED);
+        BENCH_CHECK(RPXLoader_AsyncGetState(first) == RPX_LOADER_ASYNC_STATE_COMPLETED);
+        BENCH_CHECK(RPXLoader_AsyncCancel(first) == RPX_LOADER_RESULT_NOT_AVAILABLE);
+        RPXLoader_AsyncFree(first);
+        RPXLoader_AsyncFree(second);
+
+        BENCH_CHECK(MockRPXLoader_GetCalls().prepareLaunchFromSD == 1);
+        BENCH_CHECK(MockRPXLoader_GetPreparedPath() == ASYNC_BENCH_DIR "app0.rpx");
+        BENCH_CHECK(log.records.size() == 2);
+        BENCH_CHECK(log.records[0].id == 0 && log.records[0].result == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(log.records[1].id == 1 && log.records[1].result == RPX_LOADER_RESULT_CANCELLED && log.records[1].state == RPX_LOADER_ASYNC_STATE_CANCELLED);
+        MockRPXLoader_SetCallDelay(0);
+
+        // Cancelling during the validation of a large file stops the validation, the module isn't called.
+        RPXLoaderAsyncOptions fullOptions = {RPX_LOADER_PREFLIGHT_MODE_FULL, 0, nullptr, nullptr};
+        RPXLoaderAsyncLaunch *slow        = nullptr;
+        BENCH_CHECK(RPXLoader_LaunchHomebrewAsync(ASYNC_BENCH_DIR "slow.rpx", &fullOptions, &slow) == RPX_LOADER_RESULT_SUCCESS);
+        WaitForState(slow, RPX_LOADER_ASYNC_STATE_VALIDATING);
+        if (RPXLoader_AsyncCancel(slow) == RPX_LOADER_RESULT_SUCCESS) {
+            RPXLoaderPreflightResult preflight;
+            BENCH_CHECK(RPXLoader_AsyncWait(slow) == RPX_LOADER_RESULT_CANCELLED);
+            GetResult(slow, &preflight);
+            BENCH_CHECK(preflight.error == RPX_LOADER_PREFLIGHT_CANCELLED || preflight.error == RPX_LOADER_PREFLIGHT_OK);
+            BENCH_CHECK(MockRPXLoader_GetCalls().launchHomebrew == 0);
+        } else {
+            // The validation was faster than this thread.
+            BENCH_CHECK(RPXLoader_AsyncWait(slow) == RPX_LOADER_RESULT_SUCCESS);
+        }
+        RPXLoader_AsyncFree(slow);
+    }
+
+    void CheckDeInit() {
+        MockRPXLoader_SetCallDelay(ASYNC_LAUNCH_DELAY);
+        RPXLoaderAsyncLaunch *first  = nullptr;
+        RPXLoaderAsyncLaunch *second = nullptr;
+        BENCH_CHECK(RPXLoader_LaunchHomebrewAsync(ASYNC_BENCH_DIR "app0.rpx", nullptr, &first) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_LaunchHomebrewAsync(ASYNC_BENCH_DIR "app1.rpx", nullptr, &second) == RPX_LOADER_RESULT_SUCCESS);
+        WaitForState(first, RPX_LOADER_ASYNC_STATE_LAUNCHING);
+        // Waits for the launch in progress and cancels the queued one.
+        RPXLoader_DeInitLibrary();
+        BENCH_CHECK(GetResult(first) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(GetResult(second) == RPX_LOADER_RESULT_CANCELLED);
+        BENCH_CHECK(MockRPXLoader_GetCalls().launchHomebrew == 1);
+        RPXLoader_AsyncFree(first);
+        RPXLoader_AsyncFree(second);
+        MockRPXLoader_SetCallDelay(0);
+
+        BENCH_CHECK(RPXLoader_LaunchHomebrewAsync(ASYNC_BENCH_DIR "app0.rpx", nullptr, &first) == RPX_LOADER_RESULT_LIB_UNINITIALIZED);
+    }
+} // namespace
+
+RPXLOADER_BENCHMARK(Async_OrderingAndCancellation) {
+    CreateAsyncFiles();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BenchFixture_Init();
+        CheckOrdering();
+        BenchFixture_Init();
+        CheckValidation();
+        BenchFixture_Init();
+        CheckCancellation();
+        BenchFixture_Init();
+        CheckDeInit();
+
+        RPXLoaderAsyncLaunch *handle = nullptr;
+        BenchFixture_Init();
+        MockRPXLoader_SetExportMissing("RL_LaunchHomebrew", true);
+        BENCH_CHECK(RPXLoader_LaunchHomebrewAsync(ASYNC_BENCH_DIR "app0.rpx", nullptr, &handle) == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND);
+        BENCH_CHECK(RPXLoader_PrepareLaunchFromSDAsync(nullptr, nullptr, &handle) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+        BENCH_CHECK(handle == nullptr);
+        BenchFixture_Reset();
+    }
+}
+
+// Time the UI thread spends to start a launch, compare with LaunchHomebrew.
+RPXLOADER_BENCHMARK(Async_LaunchHomebrew_Submit) {
+    CreateAsyncFiles();
+    BenchFixture_Init();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        RPXLoaderAsyncLaunch *handle = nullptr;
+        BENCH_CHECK(RPXLoader_LaunchHomebrewAsync(ASYNC_BENCH_DIR "app0.rpx", nullptr, &handle) == RPX_LOADER_RESULT_SUCCESS);
+        state.PauseTiming();
+        BENCH_CHECK(RPXLoader_AsyncWait(handle) == RPX_LOADER_RESULT_SUCCESS);
+        RPXLoader_AsyncFree(handle);
+        state.ResumeTiming();
+    }
+    state.PauseTiming();
+    BenchFixture_Reset();
+}
+
+// Submit until the result is available, including the header validation on the worker.
+RPXLOADER_BENCHMARK(Async_LaunchHomebrew_RoundTrip) {
+    CreateAsyncFiles();
+    BenchFixture_Init();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        RPXLoaderAsyncLaunch *handle = nullptr;
+        BENCH_CHECK(RPXLoader_LaunchHomebrewAsync(ASYNC_BENCH_DIR "app0.rpx", nullptr, &handle) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_AsyncWait(handle) == RPX_LOADER_RESULT_SUCCESS);
+        RPXLoader_AsyncFree(handle);
+    }
+    state.PauseTiming();
+    BenchFixture_Reset();
+}
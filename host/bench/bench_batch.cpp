@@ -0,0 +1,146 @@
+#include "bench_fixture.h"
+#include <cstring>
+
+// Rough cost of a call from an application RPL into the module on the console.
+#define BENCH_MODELED_CALL_DELAY_NS 1000
+
+struct LaunchSequence {
+    uint32_t version;
+    char savePath[256];
+    RPXLoaderCommand commands[5];
+};
+
+static void SetupLaunchSequence(LaunchSequence &sequence, const char *path) {
+    memset(&sequence, 0, sizeof(sequence));
+    auto &commands = sequence.commands;
+
+    commands[0].type                       = RPX_LOADER_COMMAND_GET_VERSION;
+    commands[0].args.getVersion.outVersion = &sequence.version;
+    commands[1].type                       = RPX_LOADER_COMMAND_DISABLE_CONTENT_REDIRECTION;
+    commands[2].type                       = RPX_LOADER_COMMAND_PREPARE_LAUNCH_FROM_SD;
+    commands[2].args.launch.path           = path;
+    commands[3].type                       = RPX_LOADER_COMMAND_GET_PATH_OF_SAVE_REDIRECTION;
+    commands[3].args.getPath.outBuffer     = sequence.savePath;
+    commands[3].args.getPath.outSize       = sizeof(sequence.savePath);
+    commands[4].type                       = RPX_LOADER_COMMAND_LAUNCH_PREPARED_HOMEBREW;
+    for (auto &command : commands) {
+        command.status = RPX_LOADER_RESULT_UNKNOWN_ERROR;
+    }
+}
+
+static void CheckLaunchSequence(const LaunchSequence &sequence, RPXLoaderVersion expectedVersion) {
+    for (auto &command : sequence.commands) {
+        BENCH_CHECK(command.status == RPX_LOADER_RESULT_SUCCESS);
+    }
+    BENCH_CHECK(sequence.version == expectedVersion);
+    BENCH_CHECK(strcmp(sequence.savePath, "wiiu/apps/save/00050000/mock") == 0);
+    BENCH_CHECK(MockRPXLoader_GetPreparedPath() == "wiiu/apps/bench/bench.wuhb");
+}
+
+RPXLOADER_BENCHMARK(LaunchSequence_Individual_ModeledCallCost) {
+    BenchFixture_Init();
+    MockRPXLoader_SetCallDelay(BENCH_MODELED_CALL_DELAY_NS);
+    uint32_t version = 0;
+    char savePath[256];
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BENCH_CHECK(RPXLoader_GetVersion(&version) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_DisableContentRedirection() == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_PrepareLaunchFromSD("wiiu/apps/bench/bench.wuhb") == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_GetPathOfSaveRedirection(savePath, sizeof(savePath)) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_LaunchPreparedHomebrew() == RPX_LOADER_RESULT_SUCCESS);
+    }
+    state.PauseTiming();
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(LaunchSequence_Batch_ModeledCallCost) {
+    BenchFixture_Init();
+    MockRPXLoader_SetCallDelay(BENCH_MODELED_CALL_DELAY_NS);
+    LaunchSequence sequence;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        state.PauseTiming();
+        SetupLaunchSequence(sequence, "wiiu/apps/bench/bench.wuhb");
+        state.ResumeTiming();
+        BENCH_CHECK(RPXLoader_ExecuteBatch(sequence.commands, 5, RPX_LOADER_BATCH_FLAG_STOP_ON_FAILURE) == RPX_LOADER_RESULT_SUCCESS);
+    }
+    state.PauseTiming();
+    CheckLaunchSequence(sequence, MOCK_RPX_LOADER_API_VERSION);
+    BENCH_CHECK(MockRPXLoader_GetCalls().executeBatch == state.iterations());
+    BenchFixture_Reset();
+}
+
+// Module API version 3 has no RL_ExecuteBatch, every command goes through the regular functions.
+RPXLOADER_BENCHMARK(LaunchSequence_BatchFallback_ModeledCallCost) {
+    BenchFixture_Reset();
+    MockRPXLoader_SetAPIVersion(3);
+    BENCH_CHECK(RPXLoader_InitLibrary() == RPX_LOADER_RESULT_SUCCESS);
+    MockRPXLoader_SetCallDelay(BENCH_MODELED_CALL_DELAY_NS);
+    LaunchSequence sequence;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        state.PauseTiming();
+        SetupLaunchSequence(sequence, "wiiu/apps/bench/bench.wuhb");
+        state.ResumeTiming();
+        BENCH_CHECK(RPXLoader_ExecuteBatch(sequence.commands, 5, RPX_LOADER_BATCH_FLAG_STOP_ON_FAILURE) == RPX_LOADER_RESULT_SUCCESS);
+    }
+    state.PauseTiming();
+    CheckLaunchSequence(sequence, 3);
+    BENCH_CHECK(MockRPXLoader_GetCalls().executeBatch == 0);
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(Batch_StopOnFailure) {
+    BenchFixture_Init();
+    LaunchSequence sequence;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        SetupLaunchSequence(sequence, nullptr);
+        BENCH_CHECK(RPXLoader_ExecuteBatch(sequence.commands, 5, RPX_LOADER_BATCH_FLAG_STOP_ON_FAILURE) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+    }
+    state.PauseTiming();
+    BENCH_CHECK(sequence.commands[1].status == RPX_LOADER_RESULT_SUCCESS);
+    BENCH_CHECK(sequence.commands[2].status == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+    BENCH_CHECK(sequence.commands[3].status == RPX_LOADER_RESULT_UNKNOWN_ERROR);
+    BENCH_CHECK(sequence.commands[4].status == RPX_LOADER_RESULT_UNKNOWN_ERROR);
+
+    // Without the flag the remaining commands are still executed.
+    SetupLaunchSequence(sequence, nullptr);
+    BENCH_CHECK(RPXLoader_ExecuteBatch(sequence.commands, 5, 0) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+    BENCH_CHECK(sequence.commands[2].status == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+    BENCH_CHECK(sequence.commands[3].status == RPX_LOADER_RESULT_SUCCESS);
+    BENCH_CHECK(sequence.commands[4].status == RPX_LOADER_RESULT_NOT_FOUND);
+    BenchFixture_Reset();
+}
+
+// The module batches, but doesn't know one of the commands: it is retried in place via the regular function.
+RPXLOADER_BENCHMARK(Batch_UnsupportedCommandInBatch) {
+    BenchFixture_Init();
+    MockRPXLoader_SetExportMissing("RL_GetPathOfSaveRedirection", true);
+    LaunchSequence sequence;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        SetupLaunchSequence(sequence, "wiiu/apps/bench/bench.wuhb");
+        BENCH_CHECK(RPXLoader_ExecuteBatch(sequence.commands, 5, 0) == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND);
+    }
+    state.PauseTiming();
+    BENCH_CHECK(sequence.commands[2].status == RPX_LOADER_RESULT_SUCCESS);
+    BENCH_CHECK(sequence.commands[3].status == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND);
+    BENCH_CHECK(sequence.commands[4].status == RPX_LOADER_RESULT_SUCCESS);
+    BENCH_CHECK(MockRPXLoader_GetCalls().executeBatch == 2 * state.iterations());
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(Batch_Fail_Uninitialized) {
+    BenchFixture_Reset();
+    LaunchSequence sequence;
+    SetupLaunchSequence(sequence, "wiiu/apps/bench/bench.wuhb");
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_ExecuteBatch(sequence.commands, 5, 0));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(RPXLoader_ExecuteBatch(sequence.commands, 5, 0) == RPX_LOADER_RESULT_LIB_UNINITIALIZED);
+    BENCH_CHECK(sequence.commands[0].status == RPX_LOADER_RESULT_UNKNOWN_ERROR);
+}
@@ -0,0 +1,187 @@
+#include "bench_corpus.h"
+#include "bench_fixture.h"
+#include "romfs.h"
+#include "sd_file.h"
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <rpxloader/bundle.h>
+
+#define BUNDLE_BENCH_PATH  "bench/bundle/assets.wuhb"
+#define BUNDLE_SMALL_FILES 4096
+#define BUNDLE_LARGE_SIZE  0x800000
+
+namespace {
+    std::string GetAssetPath(uint32_t index) {
+        return "content/level" + std::to_string(index % 64) + "/asset" + std::to_string(index) + ".bin";
+    }
+
+    // An asset heavy bundle: thousands of small files spread over many directories and one large file.
+    const std::vector<CorpusFile> &GetBundleFiles() {
+        static std::vector<CorpusFile> sFiles = [] {
+            auto files = Corpus_DefaultBundleFiles("assets", "bench", 1);
+            for (uint32_t i = 0; i < BUNDLE_SMALL_FILES; i++) {
+                files.push_back({GetAssetPath(i), Corpus_RandomData(0x100 + (i * 37) % 0xF00, i, false)});
+            }
+            files.push_back({"content/movie.bin", Corpus_RandomData(BUNDLE_LARGE_SIZE, 99, false)});
+            BENCH_CHECK(Corpus_WriteSDFile(BUNDLE_BENCH_PATH, Corpus_BuildWUHB(files)));
+            return files;
+        }();
+        return sFiles;
+    }
+
+    RPXLoaderBundle *OpenBundle() {
+        GetBundleFiles();
+        RPXLoaderBundle *bundle = nullptr;
+        BENCH_CHECK(RPXLoader_BundleOpen(BUNDLE_BENCH_PATH, &bundle) == RPX_LOADER_RESULT_SUCCESS);
+        return bundle;
+    }
+
+    // Paths in the order a title would look them up, not in table order.
+    std::vector<std::string> GetLookupOrder() {
+        std::vector<std::string> paths;
+        for (uint32_t i = 0; i < BUNDLE_SMALL_FILES; i++) {
+            paths.push_back(GetAssetPath((i * 2654435761u) % BUNDLE_SMALL_FILES));
+        }
+        return paths;
+    }
+
+    using AlignedBuffer = std::unique_ptr<uint8_t, decltype(&free)>;
+
+    AlignedBuffer AllocBuffer(uint32_t size) {
+        return AlignedBuffer((uint8_t *) SDFile_AllocBuffer(size), &free);
+    }
+} // namespace
+
+// Checks every file of the generated bundle, partial reads and error cases.
+RPXLOADER_BENCHMARK(Bundle_Contents) {
+    auto &files  = GetBundleFiles();
+    auto buffer  = AllocBuffer(BUNDLE_LARGE_SIZE);
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        auto bundle = OpenBundle();
+        BENCH_CHECK(RPXLoader_BundleGetFileCount(bundle) == files.size());
+        for (auto &file : files) {
+            RPXLoaderBundleFileInfo info;
+            BENCH_CHECK(RPXLoader_BundleFindFile(bundle, file.path.c_str(), &info) == RPX_LOADER_RESULT_SUCCESS);
+            BENCH_CHECK(info.path == file.path && info.size == file.data.size());
+            uint32_t read = 0;
+            BENCH_CHECK(RPXLoader_BundleReadFile(bundle, info.index, 0, buffer.get(), BUNDLE_LARGE_SIZE, &read) == RPX_LOADER_RESULT_SUCCESS);
+            BENCH_CHECK(read == file.data.size() && memcmp(buffer.get(), file.data.data(), read) == 0);
+
+            RPXLoaderBundleFileInfo byIndex;
+            BENCH_CHECK(RPXLoader_BundleGetFileInfo(bundle, info.index, &byIndex) == RPX_LOADER_RESULT_SUCCESS);
+            BENCH_CHECK(byIndex.path == info.path && byIndex.offset == info.offset);
+        }
+
+        RPXLoaderBundleFileInfo info;
+        BENCH_CHECK(RPXLoader_BundleFindFile(bundle, "/content/movie.bin", &info) == RPX_LOADER_RESULT_SUCCESS);
+        uint32_t read = 0;
+        BENCH_CHECK(RPXLoader_BundleReadFile(bundle, info.index, BUNDLE_LARGE_SIZE - 0x10, buffer.get(), 0x40, &read) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(read == 0x10 && memcmp(buffer.get(), files.back().data.data() + BUNDLE_LARGE_SIZE - 0x10, 0x10) == 0);
+        BENCH_CHECK(RPXLoader_BundleReadFile(bundle, info.index, BUNDLE_LARGE_SIZE + 1, buffer.get(), 0x40, &read) == RPX_LOADER_RESULT_SUCCESS && read == 0);
+        BENCH_CHECK(RPXLoader_BundleReadFile(bundle, RPXLoader_BundleGetFileCount(bundle), 0, buffer.get(), 0x40, &read) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+
+        BENCH_CHECK(RPXLoader_BundleFindFile(bundle, "content/level1", &info) == RPX_LOADER_RESULT_NOT_FOUND);
+        BENCH_CHECK(RPXLoader_BundleFindFile(bundle, "content/level1/asset2.bin", &info) == RPX_LOADER_RESULT_NOT_FOUND);
+        BENCH_CHECK(RPXLoader_BundleFindFile(bundle, "", &info) == RPX_LOADER_RESULT_NOT_FOUND);
+        RPXLoader_BundleClose(bundle);
+    }
+
+    RPXLoaderBundle *bundle = nullptr;
+    BENCH_CHECK(RPXLoader_BundleOpen("bench/bundle/missing.wuhb", &bundle) == RPX_LOADER_RESULT_NOT_FOUND);
+    BENCH_CHECK(Corpus_WriteSDFile("bench/bundle/app.rpx", Corpus_BuildRPX(0x100, 1).data));
+    BENCH_CHECK(RPXLoader_BundleOpen("bench/bundle/app.rpx", &bundle) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+    BENCH_CHECK(bundle == nullptr);
+
+    // The mounted bundle is taken from the running executable path of the module.
+    BENCH_CHECK(RPXLoader_BundleOpenMounted(&bundle) == RPX_LOADER_RESULT_LIB_UNINITIALIZED);
+    BenchFixture_Init();
+    MockRPXLoader_SetRunningExecutablePath(BUNDLE_BENCH_PATH);
+    BENCH_CHECK(RPXLoader_BundleOpenMounted(&bundle) == RPX_LOADER_RESULT_SUCCESS);
+    BENCH_CHECK(RPXLoader_BundleGetFileCount(bundle) == files.size());
+    RPXLoader_BundleClose(bundle);
+    MockRPXLoader_SetRunningExecutablePath("bench/bundle/app.rpx");
+    RPXLoader_UnmountCurrentRunningBundle();
+    BENCH_CHECK(RPXLoader_BundleOpenMounted(&bundle) == RPX_LOADER_RESULT_NOT_AVAILABLE);
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(Bundle_Open) {
+    GetBundleFiles();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        RPXLoader_BundleClose(OpenBundle());
+    }
+}
+
+RPXLOADER_BENCHMARK(Bundle_Lookup_Index) {
+    auto bundle = OpenBundle();
+    auto paths  = GetLookupOrder();
+    RPXLoaderBundleFileInfo info;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BENCH_CHECK(RPXLoader_BundleFindFile(bundle, paths[i % paths.size()].c_str(), &info) == RPX_LOADER_RESULT_SUCCESS);
+    }
+    state.PauseTiming();
+    RPXLoader_BundleClose(bundle);
+}
+
+// Baseline: resolving every path component through the RomFS hash tables.
+RPXLOADER_BENCHMARK(Bundle_Lookup_RomFSTables) {
+    GetBundleFiles();
+    SDFile file;
+    RomFSTables tables;
+    BENCH_CHECK(file.Open(BUNDLE_BENCH_PATH) && RomFS_LoadTables(file, &tables));
+    auto paths = GetLookupOrder();
+    RomFSFileEntry entry;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BENCH_CHECK(RomFS_FindFile(tables, paths[i % paths.size()].c_str(), &entry));
+    }
+}
+
+RPXLOADER_BENCHMARK(Bundle_Lookup_Miss) {
+    auto bundle = OpenBundle();
+    RPXLoaderBundleFileInfo info;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BENCH_CHECK(RPXLoader_BundleFindFile(bundle, "content/level7/missing.bin", &info) == RPX_LOADER_RESULT_NOT_FOUND);
+    }
+    state.PauseTiming();
+    RPXLoader_BundleClose(bundle);
+}
+
+// Lookup + complete read of small assets, like a title loading its data on startup.
+RPXLOADER_BENCHMARK(Bundle_ReadSmallFiles) {
+    auto bundle = OpenBundle();
+    auto paths  = GetLookupOrder();
+    auto buffer = AllocBuffer(0x1000);
+    uint64_t bytes = 0;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        RPXLoaderBundleFileInfo info;
+        uint32_t read = 0;
+        BENCH_CHECK(RPXLoader_BundleFindFile(bundle, paths[i % paths.size()].c_str(), &info) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_BundleReadFile(bundle, info.index, 0, buffer.get(), 0x1000, &read) == RPX_LOADER_RESULT_SUCCESS);
+        bytes += read;
+    }
+    state.PauseTiming();
+    state.SetBytesPerIteration(bytes / state.iterations());
+    RPXLoader_BundleClose(bundle);
+}
+
+RPXLOADER_BENCHMARK(Bundle_ReadLargeFile) {
+    auto bundle = OpenBundle();
+    auto buffer = AllocBuffer(RPX_LOADER_IO_CHUNK_SIZE);
+    RPXLoaderBundleFileInfo info;
+    BENCH_CHECK(RPXLoader_BundleFindFile(bundle, "content/movie.bin", &info) == RPX_LOADER_RESULT_SUCCESS);
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        for (uint64_t offset = 0; offset < info.size; offset += RPX_LOADER_IO_CHUNK_SIZE) {
+            BENCH_CHECK(RPXLoader_BundleReadFile(bundle, info.index, offset, buffer.get(), RPX_LOADER_IO_CHUNK_SIZE, nullptr) == RPX_LOADER_RESULT_SUCCESS);
+        }
+    }
+    state.PauseTiming();
+    state.SetBytesPerIteration(info.size);
+    RPXLoader_BundleClose(bundle);
+}
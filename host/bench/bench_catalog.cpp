@@ -0,0 +1,176 @@
+#include "bench_corpus.h"
+#include "bench_fixture.h"
+#include <cstring>
+#include <rpxloader/catalog.h>
+
+#define CATALOG_BENCH_DIR   "bench/catalog/wiiu/apps"
+#define CATALOG_BENCH_CACHE "bench/catalog/catalog.bin"
+#define CATALOG_BUNDLES     200
+#define CATALOG_RPX_FILES   20
+
+namespace {
+    std::string GetBundlePath(uint32_t index) {
+        // Some bundles live in their own folder, like most apps on the sd card.
+        if (index % 2 == 0) {
+            return std::string(CATALOG_BENCH_DIR) + "/app" + std::to_string(index) + "/app" + std::to_string(index) + ".wuhb";
+        }
+        return std::string(CATALOG_BENCH_DIR) + "/app" + std::to_string(index) + ".wuhb";
+    }
+
+    void CreateCatalogFiles() {
+        static bool sCreated = false;
+        if (sCreated) {
+            return;
+        }
+        Corpus_RemoveSDPath("bench/catalog");
+        for (uint32_t i = 0; i < CATALOG_BUNDLES; i++) {
+            auto files = Corpus_DefaultBundleFiles("App " + std::to_string(i), "Author " + std::to_string(i % 7), i);
+            BENCH_CHECK(Corpus_WriteSDFile(GetBundlePath(i), Corpus_BuildWUHB(files)));
+        }
+        for (uint32_t i = 0; i < CATALOG_RPX_FILES; i++) {
+            BENCH_CHECK(Corpus_WriteSDFile(std::string(CATALOG_BENCH_DIR) + "/tools/tool" + std::to_string(i) + ".rpx", Corpus_BuildRPX(0x1000, i).data));
+        }
+        BENCH_CHECK(Corpus_WriteSDFile(std::string(CATALOG_BENCH_DIR) + "/readme.txt", {'h', 'i'}));
+        sCreated = true;
+    }
+
+    RPXLoaderCatalogStats Scan(RPXLoaderCatalog **outCatalog, const char *cachePath = CATALOG_BENCH_CACHE) {
+        RPXLoaderCatalogStats stats;
+        BENCH_CHECK(RPXLoader_CatalogScan(CATALOG_BENCH_DIR, cachePath, outCatalog, &stats) == RPX_LOADER_RESULT_SUCCESS);
+        return stats;
+    }
+
+    const RPXLoaderCatalogEntry *FindEntry(const RPXLoaderCatalog *catalog, const std::string &path) {
+        for (uint32_t i = 0; i < RPXLoader_CatalogGetCount(catalog); i++) {
+            auto entry = RPXLoader_CatalogGetEntry(catalog, i);
+            if (path == entry->path) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
+    void CheckBundleEntry(const RPXLoaderCatalog *catalog, uint32_t index) {
+        auto entry = FindEntry(catalog, GetBundlePath(index));
+        BENCH_CHECK(entry != nullptr);
+        BENCH_CHECK(entry->type == RPX_LOADER_CATALOG_FILE_TYPE_WUHB);
+        BENCH_CHECK(entry->name == "App " + std::to_string(index));
+        BENCH_CHECK(entry->author == "Author " + std::to_string(index % 7));
+
+        // The icon location has to point at the icon data inside the bundle.
+        auto icon = Corpus_RandomData(128 * 128 * 4 + 18, index, false);
+        BENCH_CHECK(entry->iconSize == icon.size());
+        std::vector<uint8_t> data(entry->iconSize);
+        auto file = fopen(Corpus_SDPath(entry->path).c_str(), "rb");
+        BENCH_CHECK(file != nullptr);
+        fseek(file, entry->iconOffset, SEEK_SET);
+        BENCH_CHECK(fread(data.data(), 1, data.size(), file) == data.size());
+        fclose(file);
+        BENCH_CHECK(data == icon);
+    }
+
+    void CheckCatalog(const RPXLoaderCatalog *catalog) {
+        BENCH_CHECK(RPXLoader_CatalogGetCount(catalog) == CATALOG_BUNDLES + CATALOG_RPX_FILES);
+        BENCH_CHECK(RPXLoader_CatalogGetEntry(catalog, CATALOG_BUNDLES + CATALOG_RPX_FILES) == nullptr);
+        for (uint32_t i = 1; i < RPXLoader_CatalogGetCount(catalog); i++) {
+            BENCH_CHECK(strcmp(RPXLoader_CatalogGetEntry(catalog, i - 1)->path, RPXLoader_CatalogGetEntry(catalog, i)->path) < 0);
+        }
+        for (auto index : {0u, 1u, 57u, CATALOG_BUNDLES - 1u}) {
+            CheckBundleEntry(catalog, index);
+        }
+        auto tool = FindEntry(catalog, std::string(CATALOG_BENCH_DIR) + "/tools/tool3.rpx");
+        BENCH_CHECK(tool != nullptr && tool->type == RPX_LOADER_CATALOG_FILE_TYPE_RPX);
+        BENCH_CHECK(strcmp(tool->name, "tool3") == 0 && strcmp(tool->author, "") == 0 && tool->iconSize == 0);
+    }
+} // namespace
+
+RPXLOADER_BENCHMARK(Catalog_Incremental) {
+    CreateCatalogFiles();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Corpus_RemoveSDPath(CATALOG_BENCH_CACHE);
+        RPXLoaderCatalog *catalog = nullptr;
+
+        auto stats = Scan(&catalog);
+        BENCH_CHECK(!stats.cacheLoaded && stats.cacheWritten && stats.parsed == stats.entries && stats.reused == 0);
+        CheckCatalog(catalog);
+        RPXLoader_CatalogFree(catalog);
+
+        stats = Scan(&catalog);
+        BENCH_CHECK(stats.cacheLoaded && !stats.cacheWritten && stats.parsed == 0 && stats.reused == stats.entries);
+        CheckCatalog(catalog);
+        RPXLoader_CatalogFree(catalog);
+
+        // A changed bundle is the only one that gets parsed again.
+        auto changed = Corpus_DefaultBundleFiles("App 57", "Author 1", 57);
+        changed.push_back({"content/new.bin", Corpus_RandomData(0x100, 1, false)});
+        BENCH_CHECK(Corpus_WriteSDFile(GetBundlePath(57), Corpus_BuildWUHB(changed)));
+        stats = Scan(&catalog);
+        BENCH_CHECK(stats.cacheLoaded && stats.cacheWritten && stats.parsed == 1 && stats.reused == stats.entries - 1 && stats.removed == 0);
+        CheckCatalog(catalog);
+        RPXLoader_CatalogFree(catalog);
+
+        // Paths can be passed to the launch functions as they are.
+        BenchFixture_Init();
+        Scan(&catalog);
+        auto entry = RPXLoader_CatalogGetEntry(catalog, 3);
+        BENCH_CHECK(RPXLoader_LaunchHomebrew(entry->path) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(MockRPXLoader_GetPreparedPath() == entry->path);
+        RPXLoader_CatalogFree(catalog);
+        BenchFixture_Reset();
+
+        auto removedPath = std::string(CATALOG_BENCH_DIR) + "/tools/tool19.rpx";
+        Corpus_RemoveSDPath(removedPath);
+        stats = Scan(&catalog);
+        BENCH_CHECK(stats.cacheWritten && stats.removed == 1 && stats.parsed == 0 && stats.entries == CATALOG_BUNDLES + CATALOG_RPX_FILES - 1);
+        RPXLoader_CatalogFree(catalog);
+        BENCH_CHECK(Corpus_WriteSDFile(removedPath, Corpus_BuildRPX(0x1000, 19).data));
+
+        // A broken cache file is ignored and replaced.
+        BENCH_CHECK(Corpus_WriteSDFile(CATALOG_BENCH_CACHE, Corpus_RandomData(0x400, 5, false)));
+        stats = Scan(&catalog);
+        BENCH_CHECK(!stats.cacheLoaded && stats.cacheWritten && stats.parsed == stats.entries);
+        CheckCatalog(catalog);
+        RPXLoader_CatalogFree(catalog);
+    }
+
+    RPXLoaderCatalog *catalog = nullptr;
+    BENCH_CHECK(RPXLoader_CatalogScan("bench/catalog/missing", nullptr, &catalog, nullptr) == RPX_LOADER_RESULT_NOT_FOUND);
+    BENCH_CHECK(RPXLoader_CatalogScan(nullptr, nullptr, &catalog, nullptr) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+    BENCH_CHECK(catalog == nullptr);
+
+    // Entries of the sd card root don't start with a '/' either.
+    BENCH_CHECK(Corpus_WriteSDFile("bench/catalog/root.rpx", Corpus_BuildRPX(0x1000, 0).data));
+    BENCH_CHECK(RPXLoader_CatalogScan("/", nullptr, &catalog, nullptr) == RPX_LOADER_RESULT_SUCCESS);
+    BENCH_CHECK(FindEntry(catalog, "bench/catalog/root.rpx") != nullptr);
+    for (uint32_t i = 0; i < RPXLoader_CatalogGetCount(catalog); i++) {
+        BENCH_CHECK(RPXLoader_CatalogGetEntry(catalog, i)->path[0] != '/');
+    }
+    RPXLoader_CatalogFree(catalog);
+    Corpus_RemoveSDPath("bench/catalog/root.rpx");
+}
+
+// Start of a launcher without a cache: every bundle is opened.
+RPXLOADER_BENCHMARK(Catalog_ColdScan) {
+    CreateCatalogFiles();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        RPXLoaderCatalog *catalog = nullptr;
+        auto stats                = Scan(&catalog, nullptr);
+        BENCH_CHECK(stats.parsed == CATALOG_BUNDLES + CATALOG_RPX_FILES);
+        RPXLoader_CatalogFree(catalog);
+    }
+}
+
+// Start of a launcher with an up to date cache: only directories are listed.
+RPXLOADER_BENCHMARK(Catalog_WarmScan) {
+    CreateCatalogFiles();
+    RPXLoaderCatalog *catalog = nullptr;
+    Scan(&catalog);
+    RPXLoader_CatalogFree(catalog);
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        auto stats = Scan(&catalog);
+        BENCH_CHECK(stats.reused == CATALOG_BUNDLES + CATALOG_RPX_FILES && !stats.cacheWritten);
+        RPXLoader_CatalogFree(catalog);
+    }
+}
@@ -0,0 +1,123 @@
+#include "bench_fixture.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// The console has three cores, oversubscribe a bit to provoke interleavings on the host.
+#define BENCH_THREAD_COUNT 8
+
+template<typename Func>
+static void RunOnThreads(uint32_t threadCount, Func func) {
+    std::atomic<uint32_t> ready{0};
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++) {
+        threads.emplace_back([&, i] {
+            // Start all threads at once so the first calls actually overlap.
+            ready.fetch_add(1);
+            while (ready.load() < threadCount) {
+                std::this_thread::yield();
+            }
+            func(i);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+static bool RunMixedCalls(uint32_t seed) {
+    char buffer[256];
+    uint32_t version = 0;
+    bool ok          = true;
+    switch (seed % 6) {
+        case 0:
+            ok = RPXLoader_GetVersion(&version) == RPX_LOADER_RESULT_SUCCESS && version == MOCK_RPX_LOADER_API_VERSION;
+            break;
+        case 1:
+            ok = RPXLoader_PrepareLaunchFromSD("wiiu/apps/bench/bench.wuhb") == RPX_LOADER_RESULT_SUCCESS;
+            break;
+        case 2:
+            ok = RPXLoader_EnableContentRedirection() == RPX_LOADER_RESULT_SUCCESS;
+            break;
+        case 3:
+            ok = RPXLoader_DisableContentRedirection() == RPX_LOADER_RESULT_SUCCESS;
+            break;
+        case 4:
+            ok = RPXLoader_GetPathOfRunningExecutable(buffer, sizeof(buffer)) == RPX_LOADER_RESULT_SUCCESS;
+            break;
+        case 5:
+            ok = RPXLoader_GetPathOfSaveRedirection(buffer, sizeof(buffer)) == RPX_LOADER_RESULT_SUCCESS;
+            break;
+    }
+    return ok;
+}
+
+// All threads race RPXLoader_InitLibrary, RPXLoader_GetVersion and the first (resolving) call of every wrapper.
+RPXLOADER_BENCHMARK(Concurrency_ColdStartRace) {
+    BenchFixture_Reset();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        std::atomic<uint32_t> failures{0};
+        RunOnThreads(BENCH_THREAD_COUNT, [&](uint32_t threadIndex) {
+            uint32_t version = 0;
+            if (RPXLoader_GetVersion(&version) != RPX_LOADER_RESULT_SUCCESS || version != MOCK_RPX_LOADER_API_VERSION) {
+                failures++;
+            }
+            if (RPXLoader_InitLibrary() != RPX_LOADER_RESULT_SUCCESS) {
+                failures++;
+            }
+            for (uint32_t j = 0; j < 6; j++) {
+                if (!RunMixedCalls(threadIndex + j)) {
+                    failures++;
+                }
+            }
+        });
+        state.PauseTiming();
+        BENCH_CHECK(failures == 0);
+        RPXLoader_DeInitLibrary();
+        state.ResumeTiming();
+    }
+    state.PauseTiming();
+    BenchFixture_Reset();
+}
+
+// Threads keep using the library while others call RPXLoader_InitLibrary again, which must be a no-op.
+RPXLOADER_BENCHMARK(Concurrency_ReinitWhileCalling) {
+    BenchFixture_Init();
+    std::atomic<uint32_t> failures{0};
+    uint64_t perThread = state.iterations() / BENCH_THREAD_COUNT + 1;
+    state.ResetTimer();
+    RunOnThreads(BENCH_THREAD_COUNT, [&](uint32_t threadIndex) {
+        for (uint64_t j = 0; j < perThread; j++) {
+            if (threadIndex == 0) {
+                if (RPXLoader_InitLibrary() != RPX_LOADER_RESULT_SUCCESS) {
+                    failures++;
+                }
+            } else if (!RunMixedCalls((uint32_t) j + threadIndex)) {
+                failures++;
+            }
+        }
+    });
+    state.PauseTiming();
+    BENCH_CHECK(failures == 0);
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(Concurrency_HotPathThroughput) {
+    BenchFixture_Init();
+    BENCH_CHECK(RPXLoader_ResolveAllExports() == RPX_LOADER_RESULT_SUCCESS);
+    std::atomic<uint32_t> failures{0};
+    uint64_t perThread = state.iterations() / BENCH_THREAD_COUNT + 1;
+    state.ResetTimer();
+    RunOnThreads(BENCH_THREAD_COUNT, [&](uint32_t threadIndex) {
+        for (uint64_t j = 0; j < perThread; j++) {
+            if (RPXLoader_EnableContentRedirection() != RPX_LOADER_RESULT_SUCCESS) {
+                failures++;
+            }
+        }
+    });
+    state.PauseTiming();
+    BENCH_CHECK(failures == 0);
+    BenchFixture_Reset();
+}
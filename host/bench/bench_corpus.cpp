@@ -0,0 +1,321 @@
+#include "bench_corpus.h"
+#include "byte_order.h"
+#include "romfs.h"
+#include "sd_file.h"
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <zlib.h>
+
+std::vector<uint8_t> Corpus_RandomData(uint32_t size, uint32_t seed, bool compressible) {
+    std::vector<uint8_t> data(size);
+    uint32_t state = seed * 2654435761u + 1;
+    uint32_t word  = 0;
+    for (uint32_t i = 0; i < size; i++) {
+        if (!compressible || (i % 64) == 0) {
+            state = state * 1664525u + 1013904223u;
+            word  = state;
+        }
+        data[i] = (uint8_t) (word >> ((i % 4) * 8));
+    }
+    return data;
+}
+
+namespace {
+    struct RPXSection {
+        std::string name;
+        uint32_t type;
+        uint32_t flags;
+        std::vector<uint8_t> data; // uncompressed
+        uint32_t bssSize;
+        uint32_t nameOffset;
+        uint32_t fileOffset;
+        uint32_t fileSize;
+    };
+
+    std::vector<uint8_t> Deflate(const std::vector<uint8_t> &data) {
+        uLongf size = compressBound(data.size());
+        std::vector<uint8_t> out(4 + size);
+        StoreBE32(out.data(), data.size());
+        compress2(out.data() + 4, &size, data.data(), data.size(), Z_BEST_SPEED);
+        out.resize(4 + size);
+        return out;
+    }
+
+    void Align(std::vector<uint8_t> &data, uint32_t alignment) {
+        data.resize((data.size() + alignment - 1) / alignment * alignment);
+    }
+} // namespace
+
+CorpusRPX Corpus_BuildRPX(uint32_t textSize, uint32_t seed) {
+    std::vector<RPXSection> sections = {
+            {"", 0, 0, {}, 0, 0, 0, 0},
+            {".text", 1, 0x6 | 0x08000000, Corpus_RandomData(textSize, seed, true), 0, 0, 0, 0},
+            {".rodata", 1, 0x2 | 0x08000000, Corpus_RandomData(textSize / 4 + 16, seed + 1, true), 0, 0, 0, 0},
+            {".data", 1, 0x3, Corpus_RandomData(textSize / 8 + 16, seed + 2, false), 0, 0, 0, 0},
+            {".bss", 8, 0x3, {}, 0x1000, 0, 0, 0},
+            {".shstrtab", 3, 0, {}, 0, 0, 0, 0},
+            {".rpl_crcs", 0x80000003, 0, {}, 0, 0, 0, 0},
+            {".rpl_fileinfo", 0x80000004, 0, Corpus_RandomData(0x60, seed + 3, false), 0, 0, 0, 0},
+    };
+    const uint32_t shstrndx = 5;
+    const uint32_t crcIndex = 6;
+
+    auto &shstrtab = sections[shstrndx].data;
+    shstrtab.push_back(0);
+    for (auto &section : sections) {
+        if (section.name.empty()) {
+            continue;
+        }
+        section.nameOffset = shstrtab.size();
+        shstrtab.insert(shstrtab.end(), section.name.begin(), section.name.end());
+        shstrtab.push_back(0);
+    }
+
+    auto &crcs = sections[crcIndex].data;
+    crcs.resize(sections.size() * 4);
+    for (uint32_t i = 0; i < sections.size(); i++) {
+        auto &data = sections[i].data;
+        uint32_t crc = (i == crcIndex || data.empty()) ? 0 : (uint32_t) crc32(0, data.data(), data.size());
+        StoreBE32(crcs.data() + i * 4, crc);
+    }
+
+    CorpusRPX rpx{};
+    auto &out              = rpx.data;
+    rpx.sectionTableOffset = 0x40;
+    out.resize(rpx.sectionTableOffset + sections.size() * 0x28);
+    for (auto &section : sections) {
+        if (section.data.empty()) {
+            continue;
+        }
+        Align(out, 0x40);
+        auto stored        = (section.flags & 0x08000000) ? Deflate(section.data) : section.data;
+        section.fileOffset = out.size();
+        section.fileSize   = stored.size();
+        out.insert(out.end(), stored.begin(), stored.end());
+    }
+
+    uint8_t *header = out.data();
+    const uint8_t ident[] = {0x7F, 'E', 'L', 'F', 1, 2, 1, 0xCA, 0xFE};
+    std::copy(std::begin(ident), std::end(ident), header);
+    StoreBE16(header + 0x10, 0xFE01);
+    StoreBE16(header + 0x12, 0x14);
+    StoreBE32(header + 0x14, 1);
+    StoreBE32(header + 0x18, 0x02000000);
+    StoreBE32(header + 0x20, rpx.sectionTableOffset);
+    StoreBE16(header + 0x28, 0x34);
+    StoreBE16(header + 0x2E, 0x28);
+    StoreBE16(header + 0x30, sections.size());
+    StoreBE16(header + 0x32, shstrndx);
+
+    for (uint32_t i = 0; i < sections.size(); i++) {
+        auto &section = sections[i];
+        auto entry    = out.data() + rpx.sectionTableOffset + i * 0x28;
+        StoreBE32(entry + 0x00, section.nameOffset);
+        StoreBE32(entry + 0x04, section.type);
+        StoreBE32(entry + 0x08, section.flags);
+        StoreBE32(entry + 0x10, section.fileOffset);
+        StoreBE32(entry + 0x14, section.type == 8 ? section.bssSize : section.fileSize);
+    }
+
+    rpx.crcSectionIndex = crcIndex;
+    rpx.crcOffset       = sections[crcIndex].fileOffset;
+    rpx.textIndex       = 1;
+    rpx.textOffset      = sections[1].fileOffset;
+    rpx.textSize        = sections[1].fileSize;
+    rpx.dataIndex       = 3;
+    rpx.dataOffset      = sections[3].fileOffset;
+    rpx.dataSize        = sections[3].fileSize;
+    return rpx;
+}
+
+namespace {
+    struct BuildDir {
+        std::string name;
+        uint32_t parent;
+        std::vector<uint32_t> dirs;
+        std::vector<uint32_t> files;
+        uint32_t offset;
+    };
+
+    struct BuildFile {
+        std::string name;
+        uint32_t parent;
+        const std::vector<uint8_t> *data;
+        uint32_t offset;
+        uint64_t dataOffset;
+    };
+
+    uint32_t GetBucketCount(uint32_t entries) {
+        return entries < 3 ? 3 : (entries | 1);
+    }
+
+    void PutEntryName(std::vector<uint8_t> &table, uint32_t offset, uint32_t baseSize, const std::string &name) {
+        std::copy(name.begin(), name.end(), table.begin() + offset + baseSize);
+    }
+} // namespace
+
+std::vector<uint8_t> Corpus_BuildWUHB(const std::vector<CorpusFile> &files) {
+    std::vector<BuildDir> dirs = {{"", 0, {}, {}, 0}};
+    std::vector<BuildFile> buildFiles;
+    std::map<std::string, uint32_t> dirByPath = {{"", 0}};
+
+    for (auto &file : files) {
+        uint32_t parent   = 0;
+        std::string path  = "";
+        size_t start      = 0;
+        size_t separator  = 0;
+        while ((separator = file.path.find('/', start)) != std::string::npos) {
+            auto name = file.path.substr(start, separator - start);
+            path += "/" + name;
+            auto it = dirByPath.find(path);
+            if (it == dirByPath.end()) {
+                dirs.push_back({name, parent, {}, {}, 0});
+                dirs[parent].dirs.push_back(dirs.size() - 1);
+                it = dirByPath.emplace(path, dirs.size() - 1).first;
+            }
+            parent = it->second;
+            start  = separator + 1;
+        }
+        buildFiles.push_back({file.path.substr(start), parent, &file.data, 0, 0});
+        dirs[parent].files.push_back(buildFiles.size() - 1);
+    }
+
+    // Breadth first, so siblings are next to each other in the table.
+    std::vector<uint32_t> dirOrder = {0};
+    for (size_t i = 0; i < dirOrder.size(); i++) {
+        for (auto child : dirs[dirOrder[i]].dirs) {
+            dirOrder.push_back(child);
+        }
+    }
+    uint32_t dirTableSize = 0;
+    for (auto index : dirOrder) {
+        dirs[index].offset = dirTableSize;
+        dirTableSize += RomFS_EntrySize(ROMFS_DIR_ENTRY_SIZE, dirs[index].name.size());
+    }
+    std::vector<uint32_t> fileOrder;
+    uint32_t fileTableSize = 0;
+    uint64_t dataSize      = 0;
+    for (auto index : dirOrder) {
+        for (auto fileIndex : dirs[index].files) {
+            auto &file      = buildFiles[fileIndex];
+            file.offset     = fileTableSize;
+            file.dataOffset = dataSize;
+            fileTableSize += RomFS_EntrySize(ROMFS_FILE_ENTRY_SIZE, file.name.size());
+            dataSize = (dataSize + file.data->size() + 0x3F) & ~0x3Full;
+            fileOrder.push_back(fileIndex);
+        }
+    }
+
+    std::vector<uint8_t> dirTable(dirTableSize);
+    std::vector<uint8_t> fileTable(fileTableSize);
+    std::vector<uint32_t> dirBuckets(GetBucketCount(dirs.size()), ROMFS_ENTRY_EMPTY);
+    std::vector<uint32_t> fileBuckets(GetBucketCount(buildFiles.size()), ROMFS_ENTRY_EMPTY);
+
+    for (auto index : dirOrder) {
+        auto &dir       = dirs[index];
+        auto &parent    = dirs[dir.parent];
+        uint32_t parentOffset = index == 0 ? 0 : parent.offset;
+        uint32_t sibling      = ROMFS_ENTRY_EMPTY;
+        if (index != 0) {
+            for (size_t i = 0; i + 1 < parent.dirs.size(); i++) {
+                if (parent.dirs[i] == index) {
+                    sibling = dirs[parent.dirs[i + 1]].offset;
+                }
+            }
+        }
+        auto bucket = RomFS_CalcHash(parentOffset, dir.name.data(), dir.name.size(), dirBuckets.size());
+        auto entry  = dirTable.data() + dir.offset;
+        StoreBE32(entry + 0x00, parentOffset);
+        StoreBE32(entry + 0x04, sibling);
+        StoreBE32(entry + 0x08, dir.dirs.empty() ? ROMFS_ENTRY_EMPTY : dirs[dir.dirs[0]].offset);
+        StoreBE32(entry + 0x0C, dir.files.empty() ? ROMFS_ENTRY_EMPTY : buildFiles[dir.files[0]].offset);
+        StoreBE32(entry + 0x10, dirBuckets[bucket]);
+        StoreBE32(entry + 0x14, dir.name.size());
+        PutEntryName(dirTable, dir.offset, ROMFS_DIR_ENTRY_SIZE, dir.name);
+        dirBuckets[bucket] = dir.offset;
+    }
+
+    for (auto fileIndex : fileOrder) {
+        auto &file   = buildFiles[fileIndex];
+        auto &parent = dirs[file.parent];
+        uint32_t sibling = ROMFS_ENTRY_EMPTY;
+        for (size_t i = 0; i + 1 < parent.files.size(); i++) {
+            if (parent.files[i] == fileIndex) {
+                sibling = buildFiles[parent.files[i + 1]].offset;
+            }
+        }
+        auto bucket = RomFS_CalcHash(parent.offset, file.name.data(), file.name.size(), fileBuckets.size());
+        auto entry  = fileTable.data() + file.offset;
+        StoreBE32(entry + 0x00, parent.offset);
+        StoreBE32(entry + 0x04, sibling);
+        StoreBE64(entry + 0x08, file.dataOffset);
+        StoreBE64(entry + 0x10, file.data->size());
+        StoreBE32(entry + 0x18, fileBuckets[bucket]);
+        StoreBE32(entry + 0x1C, file.name.size());
+        PutEntryName(fileTable, file.offset, ROMFS_FILE_ENTRY_SIZE, file.name);
+        fileBuckets[bucket] = file.offset;
+    }
+
+    RomFSHeader header{};
+    header.magic               = ROMFS_WUHB_MAGIC;
+    header.headerSize          = ROMFS_HEADER_SIZE;
+    header.dirHashTableOffset  = ROMFS_HEADER_SIZE;
+    header.dirHashTableSize    = dirBuckets.size() * 4;
+    header.dirTableOffset      = header.dirHashTableOffset + header.dirHashTableSize;
+    header.dirTableSize        = dirTable.size();
+    header.fileHashTableOffset = header.dirTableOffset + header.dirTableSize;
+    header.fileHashTableSize   = fileBuckets.size() * 4;
+    header.fileTableOffset     = header.fileHashTableOffset + header.fileHashTableSize;
+    header.fileTableSize       = fileTable.size();
+    header.fileDataOffset      = (header.fileTableOffset + header.fileTableSize + 0x3F) & ~0x3Full;
+
+    std::vector<uint8_t> out(header.fileDataOffset + dataSize);
+    RomFS_WriteHeader(out.data(), header);
+    for (size_t i = 0; i < dirBuckets.size(); i++) {
+        StoreBE32(out.data() + header.dirHashTableOffset + i * 4, dirBuckets[i]);
+    }
+    std::copy(dirTable.begin(), dirTable.end(), out.begin() + header.dirTableOffset);
+    for (size_t i = 0; i < fileBuckets.size(); i++) {
+        StoreBE32(out.data() + header.fileHashTableOffset + i * 4, fileBuckets[i]);
+    }
+    std::copy(fileTable.begin(), fileTable.end(), out.begin() + header.fileTableOffset);
+    for (auto &file : buildFiles) {
+        std::copy(file.data->begin(), file.data->end(), out.begin() + header.fileDataOffset + file.dataOffset);
+    }
+    // The last file isn't padded.
+    uint64_t end = header.fileDataOffset;
+    for (auto &file : buildFiles) {
+        end = std::max<uint64_t>(end, header.fileDataOffset + file.dataOffset + file.data->size());
+    }
+    out.resize(end);
+    return out;
+}
+
+std::vector<CorpusFile> Corpus_DefaultBundleFiles(const std::string &name, const std::string &author, uint32_t seed) {
+    std::string metaIni = "[menu]\nlongname=" + name + "\nshortname=" + name + "\nauthor=" + author + "\n";
+    return {
+            {"meta/meta.ini", std::vector<uint8_t>(metaIni.begin(), metaIni.end())},
+            {"meta/iconTex.tga", Corpus_RandomData(128 * 128 * 4 + 18, seed, false)},
+            {"code/" + name + ".rpx", Corpus_BuildRPX(0x4000, seed).data},
+            {"content/data.bin", Corpus_RandomData(0x1000, seed + 1, false)},
+    };
+}
+
+std::string Corpus_SDPath(const std::string &relativePath) {
+    return std::string(RPX_LOADER_SD_ROOT) + relativePath;
+}
+
+bool Corpus_WriteSDFile(const std::string &relativePath, const std::vector<uint8_t> &data) {
+    std::filesystem::path path(Corpus_SDPath(relativePath));
+    std::error_code err;
+    std::filesystem::create_directories(path.parent_path(), err);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write((const char *) data.data(), data.size());
+    return out.good();
+}
+
+void Corpus_RemoveSDPath(const std::string &relativePath) {
+    std::error_code err;
+    std::filesystem::remove_all(Corpus_SDPath(relativePath), err);
+}
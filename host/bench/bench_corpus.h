@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Generators for the .rpx/.wuhb files used by the benchmarks. Everything is written below RPX_LOADER_SD_ROOT.
+ */
+
+struct CorpusFile {
+    std::string path; // e.g. "meta/meta.ini", without leading slash
+    std::vector<uint8_t> data;
+};
+
+struct CorpusRPX {
+    std::vector<uint8_t> data;
+    uint32_t sectionTableOffset;
+    uint32_t crcSectionIndex;
+    uint32_t crcOffset;
+    // Compressed .text section
+    uint32_t textIndex;
+    uint32_t textOffset;
+    uint32_t textSize;
+    // Uncompressed .data section
+    uint32_t dataIndex;
+    uint32_t dataOffset;
+    uint32_t dataSize;
+};
+
+/**
+ * Deterministic pseudo random data. Compressible data consists of repeated words, so zlib has something to do.
+ */
+std::vector<uint8_t> Corpus_RandomData(uint32_t size, uint32_t seed, bool compressible);
+
+/**
+ * Builds a RPL with a zlib compressed .text/.rodata, an uncompressed .data, .bss, CRC and file info section.
+ */
+CorpusRPX Corpus_BuildRPX(uint32_t textSize, uint32_t seed);
+
+/**
+ * Builds a WUHB RomFS containing the given files. File data is 0x40 aligned and stored after the tables.
+ */
+std::vector<uint8_t> Corpus_BuildWUHB(const std::vector<CorpusFile> &files);
+
+/**
+ * A minimal bundle with meta/meta.ini, an icon and a rpx in code/, like wuhbtool creates them.
+ */
+std::vector<CorpusFile> Corpus_DefaultBundleFiles(const std::string &name, const std::string &author, uint32_t seed);
+
+std::string Corpus_SDPath(const std::string &relativePath);
+
+/**
+ * Writes the file below the sd root, missing directories are created.
+ */
+bool Corpus_WriteSDFile(const std::string &relativePath, const std::vector<uint8_t> &data);
+
+void Corpus_RemoveSDPath(const std::string &relativePath);
@@ -0,0 +1,285 @@
+#include "bench_fixture.h"
+#include <coreinit/dynload.h>
+
+// Rough per-lookup cost of the console loader, used to make startup numbers comparable to the real thing.
+#define BENCH_MODELED_LOOKUP_DELAY_NS 2000
+
+static void BenchInitLibrary(BenchState &state, uint32_t lookupDelayNs, RPXLoaderStatus expected) {
+    MockDynLoad_SetLookupDelay(lookupDelayNs);
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        auto res = RPXLoader_InitLibrary();
+        state.PauseTiming();
+        BENCH_CHECK(res == expected);
+        RPXLoader_DeInitLibrary();
+        state.ResumeTiming();
+    }
+    state.PauseTiming();
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(InitLibrary) {
+    BenchFixture_Reset();
+    BenchInitLibrary(state, 0, RPX_LOADER_RESULT_SUCCESS);
+}
+
+RPXLOADER_BENCHMARK(InitLibrary_ModeledLoaderCost) {
+    BenchFixture_Reset();
+    BenchInitLibrary(state, BENCH_MODELED_LOOKUP_DELAY_NS, RPX_LOADER_RESULT_SUCCESS);
+}
+
+// Init + resolving every export up front, equivalent to the old eager RPXLoader_InitLibrary.
+RPXLOADER_BENCHMARK(InitLibrary_ResolveAllExports_ModeledLoaderCost) {
+    BenchFixture_Reset();
+    MockDynLoad_SetLookupDelay(BENCH_MODELED_LOOKUP_DELAY_NS);
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        auto res = RPXLoader_InitLibrary();
+        auto resolveRes = RPXLoader_ResolveAllExports();
+        state.PauseTiming();
+        BENCH_CHECK(res == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(resolveRes == RPX_LOADER_RESULT_SUCCESS);
+        RPXLoader_DeInitLibrary();
+        state.ResumeTiming();
+    }
+    state.PauseTiming();
+    BenchFixture_Reset();
+}
+
+// Typical launcher startup: init + a single API call.
+RPXLOADER_BENCHMARK(InitLibrary_FirstCall_ModeledLoaderCost) {
+    BenchFixture_Reset();
+    MockDynLoad_SetLookupDelay(BENCH_MODELED_LOOKUP_DELAY_NS);
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        auto res = RPXLoader_InitLibrary();
+        auto launchRes = RPXLoader_LaunchHomebrew("wiiu/apps/bench/bench.wuhb");
+        state.PauseTiming();
+        BENCH_CHECK(res == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(launchRes == RPX_LOADER_RESULT_SUCCESS);
+        RPXLoader_DeInitLibrary();
+        state.ResumeTiming();
+    }
+    state.PauseTiming();
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(ResolveAllExports_Fail_MissingExport) {
+    BenchFixture_Reset();
+    MockRPXLoader_SetExportMissing("RL_GetPathOfSaveRedirection", true);
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        auto res = RPXLoader_InitLibrary();
+        auto resolveRes = RPXLoader_ResolveAllExports();
+        state.PauseTiming();
+        BENCH_CHECK(res == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(resolveRes == RPX_LOADER_RESULT_MODULE_MISSING_EXPORT);
+        RPXLoader_DeInitLibrary();
+        state.ResumeTiming();
+    }
+    state.PauseTiming();
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(InitLibrary_OldModuleMissingExports) {
+    BenchFixture_Reset();
+    MockRPXLoader_SetAPIVersion(1);
+    MockRPXLoader_SetExportMissing("RL_GetPathOfRunningExecutable", true);
+    MockRPXLoader_SetExportMissing("RL_GetPathOfSaveRedirection", true);
+    BenchInitLibrary(state, 0, RPX_LOADER_RESULT_SUCCESS);
+}
+
+RPXLOADER_BENCHMARK(InitLibrary_Fail_ModuleNotFound) {
+    BenchFixture_Reset();
+    MockRPXLoader_SetLoaded(false);
+    BenchInitLibrary(state, 0, RPX_LOADER_RESULT_MODULE_NOT_FOUND);
+}
+
+RPXLOADER_BENCHMARK(InitLibrary_Fail_MissingGetVersion) {
+    BenchFixture_Reset();
+    MockRPXLoader_SetExportMissing("RL_GetVersion", true);
+    BenchInitLibrary(state, 0, RPX_LOADER_RESULT_MODULE_MISSING_EXPORT);
+}
+
+RPXLOADER_BENCHMARK(Baseline_DirectModuleCall) {
+    BenchFixture_Init();
+    OSDynLoad_Module module = nullptr;
+    BENCH_CHECK(OSDynLoad_Acquire("homebrew_rpx_loader", &module) == OS_DYNLOAD_OK);
+    RPXLoaderStatus (*func)() = nullptr;
+    BENCH_CHECK(OSDynLoad_FindExport(module, OS_DYNLOAD_EXPORT_FUNC, "RL_EnableContentRedirection", (void **) &func) == OS_DYNLOAD_OK);
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(func());
+    }
+    state.PauseTiming();
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(GetStatusStr) {
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_GetStatusStr((RPXLoaderStatus) -(int32_t) (i & 0x3F)));
+    }
+}
+
+RPXLOADER_BENCHMARK(GetVersion) {
+    BenchFixture_Init();
+    uint32_t version = 0;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_GetVersion(&version));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(version == MOCK_RPX_LOADER_API_VERSION);
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(GetVersion_Uninitialized) {
+    BenchFixture_Reset();
+    uint32_t version = 0;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_GetVersion(&version));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(version == MOCK_RPX_LOADER_API_VERSION);
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(PrepareLaunchFromSD) {
+    BenchFixture_Init();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_PrepareLaunchFromSD("wiiu/apps/bench/bench.wuhb"));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(MockRPXLoader_GetPreparedPath() == "wiiu/apps/bench/bench.wuhb");
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(LaunchPreparedHomebrew) {
+    BenchFixture_Init();
+    BENCH_CHECK(RPXLoader_PrepareLaunchFromSD("wiiu/apps/bench/bench.wuhb") == RPX_LOADER_RESULT_SUCCESS);
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_LaunchPreparedHomebrew());
+    }
+    state.PauseTiming();
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(LaunchHomebrew) {
+    BenchFixture_Init();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_LaunchHomebrew("wiiu/apps/bench/bench.wuhb"));
+    }
+    state.PauseTiming();
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(EnableContentRedirection) {
+    BenchFixture_Init();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_EnableContentRedirection());
+    }
+    state.PauseTiming();
+    BENCH_CHECK(MockRPXLoader_IsContentRedirectionEnabled());
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(DisableContentRedirection) {
+    BenchFixture_Init();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_DisableContentRedirection());
+    }
+    state.PauseTiming();
+    BENCH_CHECK(!MockRPXLoader_IsContentRedirectionEnabled());
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(UnmountCurrentRunningBundle) {
+    BenchFixture_Init();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_UnmountCurrentRunningBundle());
+    }
+    state.PauseTiming();
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(GetPathOfRunningExecutable) {
+    BenchFixture_Init();
+    char buffer[256];
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_GetPathOfRunningExecutable(buffer, sizeof(buffer)));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(RPXLoader_GetPathOfRunningExecutable(buffer, sizeof(buffer)) == RPX_LOADER_RESULT_SUCCESS);
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(GetPathOfSaveRedirection) {
+    BenchFixture_Init();
+    char buffer[256];
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_GetPathOfSaveRedirection(buffer, sizeof(buffer)));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(RPXLoader_GetPathOfSaveRedirection(buffer, sizeof(buffer)) == RPX_LOADER_RESULT_SUCCESS);
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(Fail_LibUninitialized) {
+    BenchFixture_Reset();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_EnableContentRedirection());
+    }
+    state.PauseTiming();
+    BENCH_CHECK(RPXLoader_EnableContentRedirection() == RPX_LOADER_RESULT_LIB_UNINITIALIZED);
+}
+
+RPXLOADER_BENCHMARK(Fail_UnsupportedApiVersion) {
+    BenchFixture_Reset();
+    MockRPXLoader_SetAPIVersion(2);
+    BENCH_CHECK(RPXLoader_InitLibrary() == RPX_LOADER_RESULT_SUCCESS);
+    char buffer[256];
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_GetPathOfSaveRedirection(buffer, sizeof(buffer)));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(RPXLoader_GetPathOfSaveRedirection(buffer, sizeof(buffer)) == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND);
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(Fail_MissingExport) {
+    BenchFixture_Reset();
+    MockRPXLoader_SetExportMissing("RL_LaunchHomebrew", true);
+    BENCH_CHECK(RPXLoader_InitLibrary() == RPX_LOADER_RESULT_SUCCESS);
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_LaunchHomebrew("wiiu/apps/bench/bench.wuhb"));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(RPXLoader_LaunchHomebrew("wiiu/apps/bench/bench.wuhb") == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND);
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(Fail_NotAvailable) {
+    BenchFixture_Init();
+    MockRPXLoader_SetRunningExecutablePath(nullptr);
+    char buffer[256];
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_GetPathOfRunningExecutable(buffer, sizeof(buffer)));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(RPXLoader_GetPathOfRunningExecutable(buffer, sizeof(buffer)) == RPX_LOADER_RESULT_NOT_AVAILABLE);
+    BenchFixture_Reset();
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "bench.h"
+#include "mock_dynload.h"
+#include "mock_rpxloader.h"
+#include <rpxloader/rpxloader.h>
+#include <rpxloader/trace.h>
+
+/**
+ * Brings library and mock module back into their default state: module loaded, latest API version,
+ * all exports present, library not initialized, launch tracing disabled.
+ */
+inline void BenchFixture_Reset() {
+    RPXLoader_DeInitLibrary();
+    RPXLoader_DisableLaunchTrace();
+    MockDynLoad_SetLookupDelay(0);
+    MockRPXLoader_Reset();
+}
+
+inline void BenchFixture_Init() {
+    BenchFixture_Reset();
+    BENCH_CHECK(RPXLoader_InitLibrary() == RPX_LOADER_RESULT_SUCCESS);
+}
@@ -0,0 +1,206 @@
+#include "bench_fixture.h"
+#include "logger.h"
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The synchronous macros the lib used before the ring buffer, for comparison.
+#define LEGACY_FILENAME ({ const char *__filename = __FILE__; const char *__pos = strrchr(__filename, '/'); if (!__pos) __pos = strrchr(__filename, '\\'); __pos ? __pos + 1 : __filename; })
+#define LEGACY_LOG_EX(FILENAME, FUNCTION, LINE, LOG_FUNC, LOG_LEVEL, LINE_END, FMT, ARGS...) \
+    do {                                                                                     \
+        LOG_FUNC("[(%s)%18s][%23s]%30s@L%04d: " LOG_LEVEL "" FMT "" LINE_END,                \
+                 LOG_APP_TYPE, LOG_APP_NAME, FILENAME, FUNCTION, LINE, ##ARGS);              \
+    } while (0)
+#define LEGACY_FUNCTION_LINE_WARN(FMT, ARGS...) LEGACY_LOG_EX(LEGACY_FILENAME, __FUNCTION__, __LINE__, OSReport, "##WARNING## ", "\n", FMT, ##ARGS)
+
+namespace {
+    struct DrainedLine {
+        RPXLoaderLogLevel level;
+        uint32_t tick;
+        std::string line;
+    };
+
+    void CollectLine(RPXLoaderLogLevel level, uint32_t tick, const char *line, void *context) {
+        ((std::vector<DrainedLine> *) context)->push_back({level, tick, line});
+    }
+
+    void DiscardLine(RPXLoaderLogLevel, uint32_t, const char *, void *) {
+    }
+
+    std::vector<DrainedLine> Drain() {
+        std::vector<DrainedLine> lines;
+        RPXLoader_DrainLog(CollectLine, &lines);
+        return lines;
+    }
+
+    std::string Expected(const char *function, int line, const char *prefix, const std::string &message) {
+        char buffer[512];
+        snprintf(buffer, sizeof(buffer), "[(%s)%18s][%23s]%30s@L%04d: %s%s\n", LOG_APP_TYPE, LOG_APP_NAME, "bench_logger.cpp", function, line, prefix, message.c_str());
+        return buffer;
+    }
+
+    // Same arguments as the most common message of the lib, a failed export lookup.
+    void LogExportMissing(const char *name) {
+        DEBUG_FUNCTION_LINE_WARN("FindExport %s failed.", name);
+    }
+} // namespace
+
+RPXLOADER_BENCHMARK(Log_Records) {
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        RPXLoader_FlushLog();
+        RPXLoader_SetLogLevel(RPX_LOADER_LOG_LEVEL_WARN);
+        BENCH_CHECK(RPXLoader_GetLogLevel() == RPX_LOADER_LOG_LEVEL_WARN);
+
+        // Text, order and level of the records. The arguments are copied, the string may be gone before the drain.
+        {
+            std::string temporary = "wiiu/apps/a.wuhb";
+            int line              = __LINE__ + 1;
+            DEBUG_FUNCTION_LINE_WARN("%s: %d %u %08X %c %.2f %p", temporary.c_str(), -5, 7u, 0xABCDu, 'x', 1.5f, (void *) 0x1000);
+            temporary.assign(temporary.size(), '#');
+            DEBUG_FUNCTION_LINE_ERR("no arguments");
+            auto lines = Drain();
+            BENCH_CHECK(lines.size() == 2);
+            char message[128];
+            snprintf(message, sizeof(message), "%s: %d %u %08X %c %.2f %p", "wiiu/apps/a.wuhb", -5, 7u, 0xABCDu, 'x', 1.5f, (void *) 0x1000);
+            BENCH_CHECK(lines[0].line == Expected(__FUNCTION__, line, "##WARNING## ", message));
+            BENCH_CHECK(lines[0].level == RPX_LOADER_LOG_LEVEL_WARN);
+            BENCH_CHECK(lines[1].line == Expected(__FUNCTION__, line + 2, "##ERROR## ", "no arguments"));
+            BENCH_CHECK(lines[1].level == RPX_LOADER_LOG_LEVEL_ERROR);
+            BENCH_CHECK(lines[1].tick - lines[0].tick < 0x80000000);
+            BENCH_CHECK(Drain().empty());
+        }
+
+        // Long strings are truncated, the arguments after them are kept.
+        {
+            std::string path(200, 'p');
+            DEBUG_FUNCTION_LINE_WARN("%s|%s|%d", path.c_str(), "short", 42);
+            auto lines = Drain();
+            BENCH_CHECK(lines.size() == 1);
+            auto message = lines[0].line.substr(lines[0].line.find("##WARNING## ") + 12);
+            BENCH_CHECK(message.size() < 100 && message.find("|short|42\n") != std::string::npos);
+        }
+
+        // Disabled levels are discarded at the call site without evaluating the arguments.
+        {
+            uint32_t evaluated = 0;
+            RPXLoader_SetLogLevel(RPX_LOADER_LOG_LEVEL_ERROR);
+            DEBUG_FUNCTION_LINE_WARN("%u", ++evaluated);
+            DEBUG_FUNCTION_LINE_ERR("%u", ++evaluated);
+            RPXLoader_SetLogLevel(RPX_LOADER_LOG_LEVEL_NONE);
+            DEBUG_FUNCTION_LINE_ERR("%u", ++evaluated);
+            BENCH_CHECK(evaluated == 1);
+            BENCH_CHECK(Drain().size() == 1);
+            RPXLoader_SetLogLevel(RPX_LOADER_LOG_LEVEL_WARN);
+        }
+
+        // A full ring drops new messages, the old ones are kept.
+        {
+            auto dropped = RPXLoader_GetDroppedLogCount();
+            for (uint32_t j = 0; j < RPX_LOADER_LOG_BUFFER_RECORDS + 10; j++) {
+                DEBUG_FUNCTION_LINE_WARN("%u", j);
+            }
+            BENCH_CHECK(RPXLoader_GetDroppedLogCount() - dropped == 10);
+            auto lines = Drain();
+            BENCH_CHECK(lines.size() == RPX_LOADER_LOG_BUFFER_RECORDS);
+            BENCH_CHECK(lines.back().line.find(": ##WARNING## " + std::to_string(RPX_LOADER_LOG_BUFFER_RECORDS - 1) + "\n") != std::string::npos);
+        }
+
+        // Concurrent writers: nothing is lost or torn, the messages of each thread keep their order.
+        {
+            const uint32_t threadCount = 4;
+            std::vector<std::thread> threads;
+            for (uint32_t t = 0; t < threadCount; t++) {
+                threads.emplace_back([t] {
+                    for (uint32_t j = 0; j < RPX_LOADER_LOG_BUFFER_RECORDS / threadCount; j++) {
+                        DEBUG_FUNCTION_LINE_WARN("thread %u message %u", t, j);
+                    }
+                });
+            }
+            for (auto &thread : threads) {
+                thread.join();
+            }
+            auto lines = Drain();
+            BENCH_CHECK(lines.size() == RPX_LOADER_LOG_BUFFER_RECORDS);
+            uint32_t next[threadCount] = {};
+            for (auto &cur : lines) {
+                uint32_t t, j;
+                BENCH_CHECK(sscanf(cur.line.c_str() + cur.line.find("thread "), "thread %u message %u", &t, &j) == 2);
+                BENCH_CHECK(t < threadCount && j == next[t]);
+                next[t]++;
+            }
+        }
+
+        // The lib logs a missing export, DeInit writes it via OSReport.
+        {
+            BenchFixture_Init();
+            MockRPXLoader_SetExportMissing("RL_EnableContentRedirection", true);
+            BENCH_CHECK(RPXLoader_EnableContentRedirection() == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND);
+            MockDynLoad_ResetCounters();
+            BenchFixture_Reset();
+            BENCH_CHECK(MockDynLoad_GetCounters().reportCalls == 1);
+        }
+
+        // Messages of the wrappers name the API function, not the lambda that is measured by Stats_Measure.
+        {
+            MockRPXLoader_SetLoaded(false);
+            uint32_t version = 0;
+            BENCH_CHECK(RPXLoader_GetVersion(&version) == RPX_LOADER_RESULT_MODULE_NOT_FOUND);
+            auto lines = Drain();
+            BENCH_CHECK(lines.size() == 1 && lines[0].line.find(" RPXLoader_GetVersion@L") != std::string::npos);
+            BenchFixture_Reset();
+        }
+    }
+}
+
+// Hot path of the macros the lib used before: file name lookup and formatting via OSReport on the calling thread.
+// The host OSReport only formats into a buffer, on the console it also writes the text to the log.
+RPXLOADER_BENCHMARK(Log_Legacy_Warn) {
+    const char *name = "RL_EnableContentRedirection";
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        LEGACY_FUNCTION_LINE_WARN("FindExport %s failed.", name);
+    }
+}
+
+// Hot path of the ring buffer, the ring is drained outside of the measurement before it gets full.
+RPXLOADER_BENCHMARK(Log_Deferred_Warn) {
+    RPXLoader_SetLogLevel(RPX_LOADER_LOG_LEVEL_WARN);
+    RPXLoader_DrainLog(DiscardLine, nullptr);
+    auto dropped = RPXLoader_GetDroppedLogCount();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        if ((i % RPX_LOADER_LOG_BUFFER_RECORDS) == RPX_LOADER_LOG_BUFFER_RECORDS - 1) {
+            state.PauseTiming();
+            RPXLoader_DrainLog(DiscardLine, nullptr);
+            state.ResumeTiming();
+        }
+        LogExportMissing("RL_EnableContentRedirection");
+    }
+    state.PauseTiming();
+    RPXLoader_DrainLog(DiscardLine, nullptr);
+    BENCH_CHECK(RPXLoader_GetDroppedLogCount() == dropped);
+}
+
+RPXLOADER_BENCHMARK(Log_Deferred_Disabled) {
+    RPXLoader_SetLogLevel(RPX_LOADER_LOG_LEVEL_ERROR);
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        LogExportMissing("RL_EnableContentRedirection");
+    }
+    state.PauseTiming();
+    RPXLoader_SetLogLevel(RPX_LOADER_LOG_LEVEL_WARN);
+}
+
+// Formatting cost that has been moved out of the hot path, per message.
+RPXLOADER_BENCHMARK(Log_Drain) {
+    RPXLoader_SetLogLevel(RPX_LOADER_LOG_LEVEL_WARN);
+    RPXLoader_DrainLog(DiscardLine, nullptr);
+    state.PauseTiming();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        LogExportMissing("RL_EnableContentRedirection");
+        if ((i % RPX_LOADER_LOG_BUFFER_RECORDS) == RPX_LOADER_LOG_BUFFER_RECORDS - 1 || i == state.iterations() - 1) {
+            state.ResumeTiming();
+            RPXLoader_DrainLog(DiscardLine, nullptr);
+            state.PauseTiming();
+        }
+    }
+}
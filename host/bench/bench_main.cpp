@@ -0,0 +1,94 @@
+#include "bench.h"
+#include "mock_dynload.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+    struct BenchCase {
+        const char *name;
+        BenchFunction func;
+    };
+
+    std::vector<BenchCase> &GetBenchCases() {
+        static std::vector<BenchCase> sCases;
+        return sCases;
+    }
+
+    const char *sCurrentBench = nullptr;
+
+    void PrintUsage(const char *argv0) {
+        printf("Usage: %s [--filter <substring>] [--min-time <ms>] [--quick] [--list] [--verbose]\n", argv0);
+    }
+} // namespace
+
+BenchRegistrar::BenchRegistrar(const char *name, BenchFunction func) {
+    GetBenchCases().push_back({name, func});
+}
+
+void Bench_Fail(const char *file, int line, const char *expr) {
+    fprintf(stderr, "FAILED: %s: %s:%d: BENCH_CHECK(%s)\n", sCurrentBench ? sCurrentBench : "<none>", file, line, expr);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv) {
+    const char *filter = nullptr;
+    uint64_t minTimeNs = 200ull * 1000 * 1000;
+    bool listOnly      = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            minTimeNs = strtoull(argv[++i], nullptr, 10) * 1000 * 1000;
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            minTimeNs = 10ull * 1000 * 1000;
+        } else if (strcmp(argv[i], "--list") == 0) {
+            listOnly = true;
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            MockOSReport_SetEcho(true);
+        } else {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%-56s %14s %14s %12s\n", "benchmark", "iterations", "ns/op", "MiB/s");
+    for (auto &bench : GetBenchCases()) {
+        if (filter != nullptr && strstr(bench.name, filter) == nullptr) {
+            continue;
+        }
+        if (listOnly) {
+            printf("%s\n", bench.name);
+            continue;
+        }
+        sCurrentBench       = bench.name;
+        uint64_t iterations = 1;
+        while (true) {
+            BenchState state(iterations);
+            bench.func(state);
+            auto elapsed = (uint64_t) state.elapsed().count();
+            if (elapsed >= minTimeNs || iterations >= 1000000000ull) {
+                double nsPerOp = (double) elapsed / (double) iterations;
+                if (state.bytesPerIteration() != 0 && elapsed != 0) {
+                    double mibPerSec = ((double) state.bytesPerIteration() * (double) iterations / (1024.0 * 1024.0)) / ((double) elapsed / 1e9);
+                    printf("%-56s %14" PRIu64 " %14.1f %12.1f\n", bench.name, iterations, nsPerOp, mibPerSec);
+                } else {
+                    printf("%-56s %14" PRIu64 " %14.1f %12s\n", bench.name, iterations, nsPerOp, "-");
+                }
+                break;
+            }
+            // Aim slightly above the minimum time, but never grow by more than 100x per step.
+            uint64_t next = elapsed == 0 ? iterations * 100 : (uint64_t) ((double) iterations * 1.4 * (double) minTimeNs / (double) elapsed);
+            if (next > iterations * 100) {
+                next = iterations * 100;
+            }
+            iterations = next > iterations ? next : iterations + 1;
+        }
+        fflush(stdout);
+    }
+    sCurrentBench = nullptr;
+    return EXIT_SUCCESS;
+}
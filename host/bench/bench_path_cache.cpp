@@ -0,0 +1,132 @@
+#include "bench_fixture.h"
+#include <cstring>
+#include <string>
+
+RPXLOADER_BENCHMARK(PathCache_Hit_Copy) {
+    BenchFixture_Init();
+    char buffer[256];
+    BENCH_CHECK(RPXLoader_GetPathOfRunningExecutable(buffer, sizeof(buffer)) == RPX_LOADER_RESULT_SUCCESS);
+    auto callsBefore = MockRPXLoader_GetCalls().getPathOfRunningExecutable;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_GetPathOfRunningExecutable(buffer, sizeof(buffer)));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(MockRPXLoader_GetCalls().getPathOfRunningExecutable == callsBefore);
+    BENCH_CHECK(strcmp(buffer, "wiiu/apps/mock/mock.wuhb") == 0);
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(PathCache_Hit_View) {
+    BenchFixture_Init();
+    const char *path = nullptr;
+    uint32_t length  = 0;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_GetPathOfSaveRedirectionView(&path, &length));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(MockRPXLoader_GetCalls().getPathOfSaveRedirection == 1);
+    BENCH_CHECK(path != nullptr && strcmp(path, "wiiu/apps/save/00050000/mock") == 0 && length == strlen(path));
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(PathCache_Hit_SizeProbe) {
+    BenchFixture_Init();
+    uint32_t requiredSize = 0;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_GetPathOfRunningExecutableEx(nullptr, 0, &requiredSize));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(requiredSize == strlen("wiiu/apps/mock/mock.wuhb") + 1);
+
+    char small[8];
+    requiredSize = 0;
+    BENCH_CHECK(RPXLoader_GetPathOfRunningExecutableEx(small, sizeof(small), &requiredSize) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+    BENCH_CHECK(requiredSize == strlen("wiiu/apps/mock/mock.wuhb") + 1);
+    BENCH_CHECK(RPXLoader_GetPathOfRunningExecutable(small, sizeof(small)) == RPX_LOADER_RESULT_SUCCESS);
+    BENCH_CHECK(strcmp(small, "wiiu/ap") == 0);
+    BenchFixture_Reset();
+}
+
+// Every iteration invalidates the cache, so each query crosses into the module again.
+RPXLOADER_BENCHMARK(PathCache_Miss_AfterUnmount) {
+    BenchFixture_Init();
+    char buffer[256];
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        RPXLoader_UnmountCurrentRunningBundle();
+        Bench_DoNotOptimize(RPXLoader_GetPathOfRunningExecutable(buffer, sizeof(buffer)));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(MockRPXLoader_GetCalls().getPathOfRunningExecutable == state.iterations());
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(PathCache_Invalidation) {
+    BenchFixture_Init();
+    const char *path = nullptr;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        state.PauseTiming();
+        MockRPXLoader_SetRunningExecutablePath((i & 1) ? "wiiu/apps/odd.rpx" : "wiiu/apps/even.rpx");
+        state.ResumeTiming();
+        BENCH_CHECK(RPXLoader_PrepareLaunchFromSD("wiiu/apps/bench/bench.wuhb") == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_GetPathOfRunningExecutableView(&path, nullptr) == RPX_LOADER_RESULT_SUCCESS);
+        state.PauseTiming();
+        BENCH_CHECK(strcmp(path, (i & 1) ? "wiiu/apps/odd.rpx" : "wiiu/apps/even.rpx") == 0);
+        state.ResumeTiming();
+    }
+    state.PauseTiming();
+
+    MockRPXLoader_SetRunningExecutablePath(nullptr);
+    BENCH_CHECK(RPXLoader_LaunchHomebrew("wiiu/apps/bench/bench.wuhb") == RPX_LOADER_RESULT_SUCCESS);
+    BENCH_CHECK(RPXLoader_GetPathOfRunningExecutableView(&path, nullptr) == RPX_LOADER_RESULT_NOT_AVAILABLE);
+    BENCH_CHECK(RPXLoader_GetPathOfRunningExecutableView(&path, nullptr) == RPX_LOADER_RESULT_NOT_AVAILABLE);
+    BENCH_CHECK(MockRPXLoader_GetCalls().getPathOfRunningExecutable == state.iterations() + 1);
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(PathCache_Fail_Uninitialized) {
+    BenchFixture_Init();
+    const char *path = nullptr;
+    BENCH_CHECK(RPXLoader_GetPathOfRunningExecutableView(&path, nullptr) == RPX_LOADER_RESULT_SUCCESS);
+    RPXLoader_DeInitLibrary();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_GetPathOfRunningExecutableView(&path, nullptr));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(RPXLoader_GetPathOfRunningExecutableView(&path, nullptr) == RPX_LOADER_RESULT_LIB_UNINITIALIZED);
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(PathCache_LongPath) {
+    BenchFixture_Init();
+    const char *oldPath = nullptr;
+    BENCH_CHECK(RPXLoader_GetPathOfRunningExecutableView(&oldPath, nullptr) == RPX_LOADER_RESULT_SUCCESS);
+
+    std::string longPath = "wiiu/apps/" + std::string(0x300, 'a') + ".wuhb";
+    MockRPXLoader_SetRunningExecutablePath(longPath.c_str());
+    uint32_t requiredSize = 0;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        RPXLoader_UnmountCurrentRunningBundle();
+        Bench_DoNotOptimize(RPXLoader_GetPathOfRunningExecutableEx(nullptr, 0, &requiredSize));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(requiredSize == longPath.size() + 1);
+    const char *path = nullptr;
+    uint32_t length  = 0;
+    BENCH_CHECK(RPXLoader_GetPathOfRunningExecutableView(&path, &length) == RPX_LOADER_RESULT_SUCCESS);
+    BENCH_CHECK(length == longPath.size() && path == longPath);
+    // Views handed out before an invalidation stay intact.
+    BENCH_CHECK(strcmp(oldPath, "wiiu/apps/mock/mock.wuhb") == 0);
+
+    MockRPXLoader_SetRunningExecutablePath(("wiiu/apps/" + std::string(0x1000, 'a')).c_str());
+    RPXLoader_UnmountCurrentRunningBundle();
+    BENCH_CHECK(RPXLoader_GetPathOfRunningExecutableEx(nullptr, 0, &requiredSize) == RPX_LOADER_RESULT_UNKNOWN_ERROR);
+    BENCH_CHECK(path == longPath);
+    BenchFixture_Reset();
+}
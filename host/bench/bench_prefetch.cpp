@@ -0,0 +1,168 @@
+#include "bench_corpus.h"
+#include "bench_fixture.h"
+#include <rpxloader/bundle.h>
+#include <rpxloader/prefetch.h>
+#include <string>
+#include <vector>
+
+#define PREFETCH_BENCH_PATH   "bench/prefetch/game.wuhb"
+#define PREFETCH_LEVELS       16
+#define PREFETCH_LEVEL_SIZE   0x20000
+#define PREFETCH_SMALL_ASSETS 2048
+
+namespace {
+    std::string GetLevelPath(uint32_t index) {
+        return "content/levels/level" + std::to_string(index) + ".bin";
+    }
+
+    std::string GetAssetPath(uint32_t index) {
+        return "content/assets/asset" + std::to_string(index) + ".bin";
+    }
+
+    // Large levels that are further apart than the merge gap, and a lot of small assets.
+    void CreateBundle() {
+        static bool sCreated = [] {
+            auto files = Corpus_DefaultBundleFiles("game", "bench", 7);
+            for (uint32_t i = 0; i < PREFETCH_LEVELS; i++) {
+                files.push_back({GetLevelPath(i), Corpus_RandomData(PREFETCH_LEVEL_SIZE, 100 + i, false)});
+            }
+            for (uint32_t i = 0; i < PREFETCH_SMALL_ASSETS; i++) {
+                files.push_back({GetAssetPath(i), Corpus_RandomData(0x200 + (i * 97) % 0x600, 1000 + i, false)});
+            }
+            BENCH_CHECK(Corpus_WriteSDFile(PREFETCH_BENCH_PATH, Corpus_BuildWUHB(files)));
+            return true;
+        }();
+        (void) sCreated;
+    }
+
+    RPXLoaderBundleFileInfo GetFileInfo(const std::string &path) {
+        RPXLoaderBundle *bundle = nullptr;
+        BENCH_CHECK(RPXLoader_BundleOpen(PREFETCH_BENCH_PATH, &bundle) == RPX_LOADER_RESULT_SUCCESS);
+        RPXLoaderBundleFileInfo info;
+        BENCH_CHECK(RPXLoader_BundleFindFile(bundle, path.c_str(), &info) == RPX_LOADER_RESULT_SUCCESS);
+        RPXLoader_BundleClose(bundle);
+        return info;
+    }
+
+    bool IsFilePrefetched(const std::string &path) {
+        auto info = GetFileInfo(path);
+        return MockRPXLoader_IsPrefetched(info.offset, info.size);
+    }
+} // namespace
+
+RPXLOADER_BENCHMARK(Prefetch_Plan) {
+    CreateBundle();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BenchFixture_Reset();
+        BENCH_CHECK(RPXLoader_PrefetchBundle(PREFETCH_BENCH_PATH, nullptr, nullptr) == RPX_LOADER_RESULT_LIB_UNINITIALIZED);
+        BenchFixture_Init();
+        BENCH_CHECK(RPXLoader_PrefetchBundle(nullptr, nullptr, nullptr) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+        BENCH_CHECK(RPXLoader_PrefetchBundle("bench/prefetch/missing.wuhb", nullptr, nullptr) == RPX_LOADER_RESULT_NOT_FOUND);
+
+        // Without options only the RomFS tables are read.
+        RPXLoaderPrefetchStats stats;
+        BENCH_CHECK(RPXLoader_PrefetchBundle(PREFETCH_BENCH_PATH, nullptr, &stats) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(stats.files == 0 && stats.ranges >= 1 && stats.bytes > 0);
+        BENCH_CHECK(MockRPXLoader_GetPrefetch().bundlePath == PREFETCH_BENCH_PATH);
+        BENCH_CHECK(MockRPXLoader_IsPrefetched(0, 0x50));
+        BENCH_CHECK(!IsFilePrefetched(GetLevelPath(0)));
+
+        // Hot files completely, hints partially. Levels that aren't requested stay on the sd card.
+        auto level5                 = GetFileInfo(GetLevelPath(5));
+        std::string hotLevel0       = GetLevelPath(0);
+        const char *hotFiles[]      = {"meta/meta.ini", hotLevel0.c_str(), "content/missing.bin"};
+        RPXLoaderPrefetchHint hints[] = {
+                {RPXLoader_BundleHashPath(GetLevelPath(5).c_str()), 0x1000, 0x2000},
+                {RPXLoader_BundleHashPath("content/other_missing.bin"), 0, 0},
+        };
+        RPXLoaderPrefetchOptions options = {hotFiles, 3, hints, 2, 0};
+        BENCH_CHECK(RPXLoader_PrefetchBundle(PREFETCH_BENCH_PATH, &options, &stats) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(stats.files == 3 && stats.missing == 2 && stats.skipped == 0);
+        BENCH_CHECK(IsFilePrefetched("meta/meta.ini") && IsFilePrefetched(GetLevelPath(0)));
+        BENCH_CHECK(MockRPXLoader_IsPrefetched(level5.offset + 0x1000, 0x2000));
+        BENCH_CHECK(!MockRPXLoader_IsPrefetched(level5.offset, 0x1000));
+        BENCH_CHECK(!IsFilePrefetched(GetLevelPath(10)));
+        auto prefetch = MockRPXLoader_GetPrefetch();
+        BENCH_CHECK(prefetch.ranges.size() == stats.ranges && prefetch.bytesRead == stats.bytes);
+        for (uint32_t j = 1; j < prefetch.ranges.size(); j++) {
+            BENCH_CHECK(prefetch.ranges[j].offset > prefetch.ranges[j - 1].offset + prefetch.ranges[j - 1].size + RPX_LOADER_PREFETCH_MERGE_GAP);
+        }
+
+        // The budget skips what doesn't fit anymore, in the given order. Files that are already covered are free.
+        options.maxBytes      = PREFETCH_LEVEL_SIZE + 0x100;
+        std::string hotLevel1 = GetLevelPath(1);
+        const char *levels[]  = {hotLevel0.c_str(), "meta/meta.ini", hotLevel0.c_str(), hotLevel1.c_str()};
+        options.hotFiles      = levels;
+        options.hotFileCount  = 4;
+        options.hintCount     = 0;
+        BENCH_CHECK(RPXLoader_PrefetchBundle(PREFETCH_BENCH_PATH, &options, &stats) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(stats.files == 3 && stats.skipped == 1);
+        BENCH_CHECK(!IsFilePrefetched(hotLevel1));
+
+        // Gaps that are merged into a read count against the budget, overlapping hints only once.
+        auto level5Hash                  = RPXLoader_BundleHashPath(GetLevelPath(5).c_str());
+        RPXLoaderPrefetchHint gapHints[] = {
+                {level5Hash, 0, 0x100},
+                {level5Hash, 0x80, 0x80},
+                {level5Hash, 0x8000, 0x100},
+        };
+        options = {nullptr, 0, gapHints, 3, 0x200};
+        BENCH_CHECK(RPXLoader_PrefetchBundle(PREFETCH_BENCH_PATH, &options, &stats) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(stats.files == 2 && stats.skipped == 1);
+        BENCH_CHECK(MockRPXLoader_IsPrefetched(level5.offset, 0x100) && !MockRPXLoader_IsPrefetched(level5.offset + 0x8000, 0x100));
+        options.maxBytes = 0x8100;
+        BENCH_CHECK(RPXLoader_PrefetchBundle(PREFETCH_BENCH_PATH, &options, &stats) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(stats.files == 3 && stats.skipped == 0);
+        BENCH_CHECK(MockRPXLoader_IsPrefetched(level5.offset, 0x8100));
+
+        // Thousands of small hot files still end up as a limited number of large reads.
+        std::vector<std::string> assetPaths;
+        for (uint32_t j = 0; j < PREFETCH_SMALL_ASSETS; j += 2) {
+            assetPaths.push_back(GetAssetPath(j));
+        }
+        std::vector<const char *> assets;
+        for (auto &path : assetPaths) {
+            assets.push_back(path.c_str());
+        }
+        options = {assets.data(), (uint32_t) assets.size(), nullptr, 0, 0};
+        BENCH_CHECK(RPXLoader_PrefetchBundle(PREFETCH_BENCH_PATH, &options, &stats) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(stats.files == assets.size() && stats.ranges <= RPX_LOADER_PREFETCH_MAX_RANGES);
+        BENCH_CHECK(IsFilePrefetched(GetAssetPath(0)) && IsFilePrefetched(GetAssetPath(PREFETCH_SMALL_ASSETS - 2)));
+
+        // Older modules: nothing is opened, the launcher just continues without prefetching.
+        BenchFixture_Reset();
+        MockRPXLoader_SetExportMissing("RL_PrefetchBundle", true);
+        BENCH_CHECK(RPXLoader_InitLibrary() == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_PrefetchBundle(PREFETCH_BENCH_PATH, &options, &stats) == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND);
+        BENCH_CHECK(MockRPXLoader_GetCalls().prefetchBundle == 0);
+        BenchFixture_Reset();
+        MockRPXLoader_SetAPIVersion(4);
+        BENCH_CHECK(RPXLoader_InitLibrary() == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_PrefetchBundle(PREFETCH_BENCH_PATH, &options, &stats) == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND);
+        BENCH_CHECK(MockRPXLoader_GetCalls().prefetchBundle == 0);
+        BenchFixture_Reset();
+    }
+}
+
+// Opening the bundle, resolving 1024 hot files and merging them, plus the reads of the mock module.
+RPXLOADER_BENCHMARK(Prefetch_1024Files) {
+    CreateBundle();
+    std::vector<std::string> assetPaths;
+    for (uint32_t j = 0; j < PREFETCH_SMALL_ASSETS; j += 2) {
+        assetPaths.push_back(GetAssetPath((j * 2654435761u) % PREFETCH_SMALL_ASSETS));
+    }
+    std::vector<const char *> assets;
+    for (auto &path : assetPaths) {
+        assets.push_back(path.c_str());
+    }
+    RPXLoaderPrefetchOptions options = {assets.data(), (uint32_t) assets.size(), nullptr, 0, 0};
+    BenchFixture_Init();
+    RPXLoaderPrefetchStats stats;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BENCH_CHECK(RPXLoader_PrefetchBundle(PREFETCH_BENCH_PATH, &options, &stats) == RPX_LOADER_RESULT_SUCCESS);
+    }
+    state.PauseTiming();
+    BENCH_CHECK(stats.files == assets.size());
+    BenchFixture_Reset();
+}
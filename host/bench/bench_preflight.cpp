@@ -0,0 +1,173 @@
+#include "bench.h"
+#include "bench_corpus.h"
+#include "byte_order.h"
+#include "romfs.h"
+#include <cstdio>
+#include <rpxloader/preflight.h>
+
+#define PREFLIGHT_CORPUS_DIR "bench/preflight/"
+
+namespace {
+    struct PreflightCase {
+        const char *name;
+        std::vector<uint8_t> data;
+        RPXLoaderPreflightError headersOnly;
+        RPXLoaderPreflightError full;
+    };
+
+    std::vector<uint8_t> Truncate(std::vector<uint8_t> data, size_t size) {
+        data.resize(size);
+        return data;
+    }
+
+    std::vector<uint8_t> Patch32(std::vector<uint8_t> data, uint64_t offset, uint32_t value) {
+        StoreBE32(data.data() + offset, value);
+        return data;
+    }
+
+    std::vector<uint8_t> FlipByte(std::vector<uint8_t> data, uint64_t offset) {
+        data[offset] ^= 0x5A;
+        return data;
+    }
+
+    std::vector<PreflightCase> BuildCases() {
+        auto rpx = Corpus_BuildRPX(0x20000, 1);
+        auto &r  = rpx.data;
+        auto textEntry = rpx.sectionTableOffset + rpx.textIndex * 0x28;
+        auto crcEntry  = rpx.sectionTableOffset + rpx.crcSectionIndex * 0x28;
+
+        auto bundleFiles = Corpus_DefaultBundleFiles("preflight", "bench", 2);
+        bundleFiles.push_back({"content/large.bin", Corpus_RandomData(0x40000, 3, false)});
+        auto wuhb = Corpus_BuildWUHB(bundleFiles);
+        RomFSHeader header;
+        RomFS_ParseHeader(wuhb.data(), &header);
+
+        const auto OK = RPX_LOADER_PREFLIGHT_OK;
+        return {
+                {"rpx_ok.rpx", r, OK, OK},
+                {"empty.rpx", {}, RPX_LOADER_PREFLIGHT_TRUNCATED, RPX_LOADER_PREFLIGHT_TRUNCATED},
+                {"unknown.bin", Corpus_RandomData(0x100, 4, false), RPX_LOADER_PREFLIGHT_UNKNOWN_FORMAT, RPX_LOADER_PREFLIGHT_UNKNOWN_FORMAT},
+                {"rpx_short_header.rpx", Truncate(r, 0x20), RPX_LOADER_PREFLIGHT_TRUNCATED, RPX_LOADER_PREFLIGHT_TRUNCATED},
+                {"rpx_short_sections.rpx", Truncate(r, rpx.sectionTableOffset + 0x30), RPX_LOADER_PREFLIGHT_TRUNCATED, RPX_LOADER_PREFLIGHT_TRUNCATED},
+                {"rpx_truncated.rpx", Truncate(r, r.size() - 0x10), RPX_LOADER_PREFLIGHT_TRUNCATED, RPX_LOADER_PREFLIGHT_TRUNCATED},
+                {"rpx_bad_abi.rpx", FlipByte(r, 7), RPX_LOADER_PREFLIGHT_BAD_HEADER, RPX_LOADER_PREFLIGHT_BAD_HEADER},
+                {"rpx_bad_type.rpx", Patch32(r, 0x10, 0x00020014), RPX_LOADER_PREFLIGHT_BAD_HEADER, RPX_LOADER_PREFLIGHT_BAD_HEADER},
+                {"rpx_section_out_of_file.rpx", Patch32(r, textEntry + 0x10, r.size() + 0x100), RPX_LOADER_PREFLIGHT_TRUNCATED, RPX_LOADER_PREFLIGHT_TRUNCATED},
+                {"rpx_no_crcs.rpx", Patch32(r, crcEntry + 0x04, 1), RPX_LOADER_PREFLIGHT_BAD_SECTION_TABLE, RPX_LOADER_PREFLIGHT_BAD_SECTION_TABLE},
+                {"rpx_crc_size.rpx", Patch32(r, crcEntry + 0x14, 8), RPX_LOADER_PREFLIGHT_BAD_SECTION_TABLE, RPX_LOADER_PREFLIGHT_BAD_SECTION_TABLE},
+                {"rpx_corrupt_zlib.rpx", FlipByte(r, rpx.textOffset + rpx.textSize / 2), OK, RPX_LOADER_PREFLIGHT_BAD_SECTION_DATA},
+                {"rpx_corrupt_data.rpx", FlipByte(r, rpx.dataOffset + rpx.dataSize / 2), OK, RPX_LOADER_PREFLIGHT_CRC_MISMATCH},
+                {"rpx_wrong_crc.rpx", FlipByte(r, rpx.crcOffset + rpx.dataIndex * 4), OK, RPX_LOADER_PREFLIGHT_CRC_MISMATCH},
+                {"wuhb_ok.wuhb", wuhb, OK, OK},
+                {"wuhb_short_header.wuhb", Truncate(wuhb, 0x30), RPX_LOADER_PREFLIGHT_TRUNCATED, RPX_LOADER_PREFLIGHT_TRUNCATED},
+                {"wuhb_bad_header_size.wuhb", Patch32(wuhb, 4, 0x40), RPX_LOADER_PREFLIGHT_BAD_HEADER, RPX_LOADER_PREFLIGHT_BAD_HEADER},
+                {"wuhb_short_tables.wuhb", Truncate(wuhb, header.fileTableOffset + 4), RPX_LOADER_PREFLIGHT_TRUNCATED, RPX_LOADER_PREFLIGHT_TRUNCATED},
+                {"wuhb_truncated_data.wuhb", Truncate(wuhb, wuhb.size() - 0x100), RPX_LOADER_PREFLIGHT_TRUNCATED, RPX_LOADER_PREFLIGHT_TRUNCATED},
+                {"wuhb_bad_sibling.wuhb", Patch32(wuhb, header.dirTableOffset + 4, 0x2), RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE, RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE},
+                {"wuhb_bad_bucket.wuhb", Patch32(wuhb, header.fileHashTableOffset, 0x3), RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE, RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE},
+                {"wuhb_bad_hash_chain.wuhb", Patch32(wuhb, header.fileHashTableOffset, ROMFS_ENTRY_EMPTY), RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE, RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE},
+                {"wuhb_bad_name_length.wuhb", Patch32(wuhb, header.fileTableOffset + 0x1C, 0x10000), RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE, RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE},
+                {"wuhb_data_out_of_file.wuhb", Patch32(wuhb, header.fileTableOffset + 0x0C, 0x10000000), RPX_LOADER_PREFLIGHT_TRUNCATED, RPX_LOADER_PREFLIGHT_TRUNCATED},
+        };
+    }
+
+    std::vector<PreflightCase> &GetCorpus() {
+        static std::vector<PreflightCase> sCases = [] {
+            auto cases = BuildCases();
+            for (auto &entry : cases) {
+                BENCH_CHECK(Corpus_WriteSDFile(std::string(PREFLIGHT_CORPUS_DIR) + entry.name, entry.data));
+            }
+            return cases;
+        }();
+        return sCases;
+    }
+
+    RPXLoaderPreflightError RunPreflight(const std::string &name, RPXLoaderPreflightMode mode) {
+        RPXLoaderPreflightResult result;
+        auto path = std::string(PREFLIGHT_CORPUS_DIR) + name;
+        BENCH_CHECK(RPXLoader_PreflightCheck(path.c_str(), mode, nullptr, nullptr, &result) == RPX_LOADER_RESULT_SUCCESS);
+        return result.error;
+    }
+
+    void CheckCase(const PreflightCase &entry, RPXLoaderPreflightMode mode, RPXLoaderPreflightError expected) {
+        auto error = RunPreflight(entry.name, mode);
+        if (error != expected) {
+            fprintf(stderr, "%s (mode %d): expected %s, got %s\n", entry.name, mode,
+                    RPXLoader_GetPreflightErrorStr(expected), RPXLoader_GetPreflightErrorStr(error));
+        }
+        BENCH_CHECK(error == expected);
+    }
+
+    bool CancelAfterFirstChunk(uint64_t, uint64_t, void *context) {
+        auto calls = (uint32_t *) context;
+        return (*calls)++ == 0;
+    }
+} // namespace
+
+// Validates every file of the corpus in both modes, one iteration checks the whole corpus.
+RPXLOADER_BENCHMARK(Preflight_Corpus) {
+    auto &corpus = GetCorpus();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        for (auto &entry : corpus) {
+            CheckCase(entry, RPX_LOADER_PREFLIGHT_MODE_HEADERS_ONLY, entry.headersOnly);
+            CheckCase(entry, RPX_LOADER_PREFLIGHT_MODE_FULL, entry.full);
+        }
+    }
+    state.PauseTiming();
+
+    RPXLoaderPreflightResult result;
+    BENCH_CHECK(RPXLoader_PreflightCheck(PREFLIGHT_CORPUS_DIR "missing.rpx", RPX_LOADER_PREFLIGHT_MODE_FULL, nullptr, nullptr, &result) == RPX_LOADER_RESULT_NOT_FOUND);
+    BENCH_CHECK(RPXLoader_PreflightCheck(nullptr, RPX_LOADER_PREFLIGHT_MODE_FULL, nullptr, nullptr, &result) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+    BENCH_CHECK(RPXLoader_PreflightCheck(PREFLIGHT_CORPUS_DIR "rpx_ok.rpx", (RPXLoaderPreflightMode) 7, nullptr, nullptr, &result) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+
+    for (auto name : {"rpx_ok.rpx", "wuhb_ok.wuhb"}) {
+        uint32_t calls = 0;
+        auto path      = std::string(PREFLIGHT_CORPUS_DIR) + name;
+        BENCH_CHECK(RPXLoader_PreflightCheck(path.c_str(), RPX_LOADER_PREFLIGHT_MODE_FULL, CancelAfterFirstChunk, &calls, &result) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(result.error == RPX_LOADER_PREFLIGHT_CANCELLED);
+        BENCH_CHECK(calls == 2);
+    }
+}
+
+static void BenchPreflightFile(BenchState &state, const char *name, const std::vector<uint8_t> &data, RPXLoaderPreflightMode mode) {
+    auto path = std::string(PREFLIGHT_CORPUS_DIR) + name;
+    BENCH_CHECK(Corpus_WriteSDFile(path, data));
+    RPXLoaderPreflightResult result{};
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BENCH_CHECK(RPXLoader_PreflightCheck(path.c_str(), mode, nullptr, nullptr, &result) == RPX_LOADER_RESULT_SUCCESS);
+    }
+    state.PauseTiming();
+    BENCH_CHECK(result.error == RPX_LOADER_PREFLIGHT_OK);
+    state.SetBytesPerIteration(result.bytesRead);
+}
+
+RPXLOADER_BENCHMARK(Preflight_RPX_HeadersOnly) {
+    static auto sRPX = Corpus_BuildRPX(0x400000, 10).data;
+    BenchPreflightFile(state, "large.rpx", sRPX, RPX_LOADER_PREFLIGHT_MODE_HEADERS_ONLY);
+}
+
+RPXLOADER_BENCHMARK(Preflight_RPX_Full) {
+    static auto sRPX = Corpus_BuildRPX(0x400000, 10).data;
+    BenchPreflightFile(state, "large.rpx", sRPX, RPX_LOADER_PREFLIGHT_MODE_FULL);
+}
+
+static const std::vector<uint8_t> &GetLargeBundle() {
+    static std::vector<uint8_t> sBundle = [] {
+        auto files = Corpus_DefaultBundleFiles("large", "bench", 20);
+        for (uint32_t i = 0; i < 64; i++) {
+            files.push_back({"content/level" + std::to_string(i / 8) + "/chunk" + std::to_string(i) + ".bin", Corpus_RandomData(0x20000 + i * 0x100, i, false)});
+        }
+        return Corpus_BuildWUHB(files);
+    }();
+    return sBundle;
+}
+
+RPXLOADER_BENCHMARK(Preflight_WUHB_HeadersOnly) {
+    BenchPreflightFile(state, "large.wuhb", GetLargeBundle(), RPX_LOADER_PREFLIGHT_MODE_HEADERS_ONLY);
+}
+
+RPXLOADER_BENCHMARK(Preflight_WUHB_Full) {
+    BenchPreflightFile(state, "large.wuhb", GetLargeBundle(), RPX_LOADER_PREFLIGHT_MODE_FULL);
+}
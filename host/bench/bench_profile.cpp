@@ -0,0 +1,190 @@
+#include "bench_corpus.h"
+#include "bench_fixture.h"
+#include "profile_format.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <rpxloader/bundle.h>
+#include <rpxloader/prefetch.h>
+#include <rpxloader/profile.h>
+#include <string>
+#include <vector>
+
+#define PROFILE_BENCH_BUNDLE "bench/profile/game.wuhb"
+#define PROFILE_BENCH_FILE   "bench/profile/profile.bin"
+#define PROFILE_BENCH_FILES  8
+
+namespace {
+    struct ProfileFile {
+        ProfileHeader header;
+        std::vector<RPXLoaderAccessRecord> records;
+        std::vector<std::pair<ProfileFileEntry, std::string>> files;
+    };
+
+    std::string GetDataPath(uint32_t index) {
+        return "content/data" + std::to_string(index) + ".bin";
+    }
+
+    void CreateBundle() {
+        static bool sCreated = [] {
+            auto files = Corpus_DefaultBundleFiles("game", "bench", 11);
+            for (uint32_t i = 0; i < PROFILE_BENCH_FILES; i++) {
+                files.push_back({GetDataPath(i), Corpus_RandomData(0x8000 + i * 0x1000, 200 + i, false)});
+            }
+            return Corpus_WriteSDFile(PROFILE_BENCH_BUNDLE, Corpus_BuildWUHB(files));
+        }();
+        BENCH_CHECK(sCreated);
+    }
+
+    ProfileFile ReadProfile() {
+        std::ifstream in(Corpus_SDPath(PROFILE_BENCH_FILE), std::ios::binary);
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        ProfileFile profile;
+        BENCH_CHECK(data.size() >= PROFILE_HEADER_SIZE && ProfileFile_LoadHeader(data.data(), &profile.header));
+        size_t offset = PROFILE_HEADER_SIZE;
+        for (uint32_t i = 0; i < profile.header.recordCount; i++, offset += profile.header.recordSize) {
+            BENCH_CHECK(offset + profile.header.recordSize <= data.size());
+            RPXLoaderAccessRecord record;
+            ProfileFile_LoadRecord(&data[offset], &record);
+            profile.records.push_back(record);
+        }
+        for (uint32_t i = 0; i < profile.header.fileCount; i++) {
+            BENCH_CHECK(offset + PROFILE_FILE_ENTRY_SIZE <= data.size());
+            ProfileFileEntry entry;
+            ProfileFile_LoadFileEntry(&data[offset], &entry);
+            BENCH_CHECK(offset + ProfileFile_GetEntrySize(entry.pathLength) <= data.size());
+            profile.files.push_back({entry, std::string((const char *) &data[offset + PROFILE_FILE_ENTRY_SIZE], entry.pathLength)});
+            offset += ProfileFile_GetEntrySize(entry.pathLength);
+        }
+        BENCH_CHECK(offset == data.size());
+        return profile;
+    }
+
+    RPXLoaderBundleFileInfo GetFileInfo(const std::string &path) {
+        RPXLoaderBundle *bundle = nullptr;
+        BENCH_CHECK(RPXLoader_BundleOpen(PROFILE_BENCH_BUNDLE, &bundle) == RPX_LOADER_RESULT_SUCCESS);
+        RPXLoaderBundleFileInfo info;
+        BENCH_CHECK(RPXLoader_BundleFindFile(bundle, path.c_str(), &info) == RPX_LOADER_RESULT_SUCCESS);
+        RPXLoader_BundleClose(bundle);
+        return info;
+    }
+
+    // Opens a file and reads it in 0x1000 byte chunks, skipping every second chunk if requested.
+    void ReadFile(uint32_t index, bool skip) {
+        auto path = GetDataPath(index);
+        MockRPXLoader_SimulateContentAccess(RPX_LOADER_ACCESS_OPEN, ("/" + path).c_str(), 0, 0);
+        for (uint32_t offset = 0; offset < 0x8000; offset += skip ? 0x2000 : 0x1000) {
+            MockRPXLoader_SimulateContentAccess(RPX_LOADER_ACCESS_READ, path.c_str(), offset, 0x1000);
+        }
+    }
+} // namespace
+
+RPXLOADER_BENCHMARK(Profile_Record) {
+    CreateBundle();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BenchFixture_Reset();
+        BENCH_CHECK(RPXLoader_StartAccessProfile(0) == RPX_LOADER_RESULT_LIB_UNINITIALIZED);
+        MockRPXLoader_SetRunningExecutablePath(PROFILE_BENCH_BUNDLE);
+        BENCH_CHECK(RPXLoader_InitLibrary() == RPX_LOADER_RESULT_SUCCESS);
+        const RPXLoaderAccessRecord *records = nullptr;
+        uint32_t count = 0, dropped = 0;
+        BENCH_CHECK(RPXLoader_GetAccessProfile(&records, &count, &dropped) == RPX_LOADER_RESULT_NOT_AVAILABLE);
+        BENCH_CHECK(RPXLoader_StopAccessProfile() == RPX_LOADER_RESULT_NOT_AVAILABLE);
+
+        // Only redirected accesses are recorded.
+        BENCH_CHECK(RPXLoader_StartAccessProfile(0) == RPX_LOADER_RESULT_SUCCESS);
+        ReadFile(7, false);
+        BENCH_CHECK(RPXLoader_EnableContentRedirection() == RPX_LOADER_RESULT_SUCCESS);
+        ReadFile(3, false);
+        ReadFile(5, true);
+        BENCH_CHECK(RPXLoader_GetAccessProfile(&records, &count, &dropped) == RPX_LOADER_RESULT_NOT_AVAILABLE);
+        BENCH_CHECK(RPXLoader_StopAccessProfile() == RPX_LOADER_RESULT_SUCCESS);
+        ReadFile(6, false);
+        BENCH_CHECK(RPXLoader_GetAccessProfile(nullptr, &count, nullptr) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+        BENCH_CHECK(RPXLoader_GetAccessProfile(&records, &count, &dropped) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(count == 1 + 8 + 1 + 4 && dropped == 0);
+        BENCH_CHECK(records[0].type == RPX_LOADER_ACCESS_OPEN && records[0].pathHash == RPXLoader_BundleHashPath(GetDataPath(3).c_str()));
+        BENCH_CHECK(records[9].type == RPX_LOADER_ACCESS_OPEN && records[9].pathHash == RPXLoader_BundleHashPath(GetDataPath(5).c_str()));
+        for (uint32_t j = 1; j < count; j++) {
+            BENCH_CHECK(records[j].time >= records[j - 1].time);
+            if (records[j].type == RPX_LOADER_ACCESS_READ) {
+                BENCH_CHECK(records[j].length == 0x1000 && records[j].offset == (j < 9 ? (j - 1) * 0x1000 : (j - 10) * 0x2000));
+            }
+        }
+
+        // The reads can be fed back as prefetch hints.
+        std::vector<RPXLoaderPrefetchHint> hints;
+        for (uint32_t j = 0; j < count; j++) {
+            if (records[j].type == RPX_LOADER_ACCESS_READ) {
+                hints.push_back({records[j].pathHash, records[j].offset, records[j].length});
+            }
+        }
+        RPXLoaderPrefetchOptions options = {nullptr, 0, hints.data(), (uint32_t) hints.size(), 0};
+        RPXLoaderPrefetchStats stats;
+        BENCH_CHECK(RPXLoader_PrefetchBundle(PROFILE_BENCH_BUNDLE, &options, &stats) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(stats.files == hints.size() && stats.missing == 0);
+        auto data5 = GetFileInfo(GetDataPath(5));
+        BENCH_CHECK(MockRPXLoader_IsPrefetched(GetFileInfo(GetDataPath(3)).offset, 0x8000) && MockRPXLoader_IsPrefetched(data5.offset + 0x6000, 0x1000));
+
+        // The export resolves the hashes with the running bundle.
+        BENCH_CHECK(RPXLoader_ExportAccessProfile(nullptr) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+        BENCH_CHECK(RPXLoader_ExportAccessProfile("bench/profile/missing/profile.bin") == RPX_LOADER_RESULT_NOT_FOUND);
+        BENCH_CHECK(RPXLoader_ExportAccessProfile(PROFILE_BENCH_FILE) == RPX_LOADER_RESULT_SUCCESS);
+        auto profile = ReadProfile();
+        BENCH_CHECK(profile.header.recordCount == count && profile.header.dropped == 0 && profile.header.fileCount == 2);
+        BENCH_CHECK(memcmp(profile.records.data(), records, count * sizeof(*records)) == 0);
+        for (auto &[entry, path] : profile.files) {
+            auto info = GetFileInfo(path);
+            BENCH_CHECK((path == GetDataPath(3) || path == GetDataPath(5)) && entry.pathHash == RPXLoader_BundleHashPath(path.c_str()));
+            BENCH_CHECK(entry.pathLength == path.size() && entry.offset == info.offset && entry.size == info.size);
+        }
+
+        // A full buffer only counts the accesses.
+        BENCH_CHECK(RPXLoader_StartAccessProfile(4) == RPX_LOADER_RESULT_SUCCESS);
+        ReadFile(1, true);
+        BENCH_CHECK(RPXLoader_StopAccessProfile() == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_GetAccessProfile(&records, &count, &dropped) == RPX_LOADER_RESULT_SUCCESS && count == 4 && dropped == 1);
+
+        // Without a running bundle only the records are exported.
+        MockRPXLoader_SetRunningExecutablePath("wiiu/apps/bench/bench.rpx");
+        BENCH_CHECK(RPXLoader_UnmountCurrentRunningBundle() == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_ExportAccessProfile(PROFILE_BENCH_FILE) == RPX_LOADER_RESULT_SUCCESS);
+        profile = ReadProfile();
+        BENCH_CHECK(profile.header.recordCount == 4 && profile.header.dropped == 1 && profile.header.fileCount == 0);
+
+        // DeInit stops the recording and frees the profile.
+        BENCH_CHECK(RPXLoader_StartAccessProfile(16) == RPX_LOADER_RESULT_SUCCESS);
+        RPXLoader_DeInitLibrary();
+        ReadFile(1, false);
+        BENCH_CHECK(RPXLoader_GetAccessProfile(&records, &count, &dropped) == RPX_LOADER_RESULT_NOT_AVAILABLE);
+
+        BenchFixture_Reset();
+        MockRPXLoader_SetAPIVersion(6);
+        BENCH_CHECK(RPXLoader_InitLibrary() == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_StartAccessProfile(0) == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND);
+        BenchFixture_Reset();
+    }
+}
+
+// Resolving the paths and writing a full default sized profile.
+RPXLOADER_BENCHMARK(Profile_Export_16384Records) {
+    CreateBundle();
+    BenchFixture_Reset();
+    MockRPXLoader_SetRunningExecutablePath(PROFILE_BENCH_BUNDLE);
+    BENCH_CHECK(RPXLoader_InitLibrary() == RPX_LOADER_RESULT_SUCCESS);
+    BENCH_CHECK(RPXLoader_EnableContentRedirection() == RPX_LOADER_RESULT_SUCCESS);
+    BENCH_CHECK(RPXLoader_StartAccessProfile(0) == RPX_LOADER_RESULT_SUCCESS);
+    for (uint32_t i = 0; i < RPX_LOADER_ACCESS_PROFILE_DEFAULT_CAPACITY / 8; i++) {
+        ReadFile(i % PROFILE_BENCH_FILES, false);
+        ReadFile((i * 5) % PROFILE_BENCH_FILES, true);
+    }
+    BENCH_CHECK(RPXLoader_StopAccessProfile() == RPX_LOADER_RESULT_SUCCESS);
+    state.SetBytesPerIteration(RPX_LOADER_ACCESS_PROFILE_DEFAULT_CAPACITY * PROFILE_RECORD_SIZE);
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BENCH_CHECK(RPXLoader_ExportAccessProfile(PROFILE_BENCH_FILE) == RPX_LOADER_RESULT_SUCCESS);
+    }
+    state.PauseTiming();
+    BENCH_CHECK(ReadProfile().header.recordCount == RPX_LOADER_ACCESS_PROFILE_DEFAULT_CAPACITY);
+    BenchFixture_Reset();
+}
@@ -0,0 +1,74 @@
+#include "bench_fixture.h"
+#include <rpxloader/rpxloader.hpp>
+
+using SaveSession = rpxloader::Session<rpxloader::API_VERSION_SAVE_REDIRECTION>;
+
+static_assert(SaveSession::Supports(rpxloader::API_VERSION_PATH_OF_RUNNING_EXECUTABLE));
+static_assert(!SaveSession::Supports(rpxloader::API_VERSION_EXECUTE_BATCH));
+
+RPXLOADER_BENCHMARK(Session_Lifetime) {
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BenchFixture_Reset();
+        MockRPXLoader_SetRunningExecutablePath("wiiu/apps/a.wuhb");
+        MockRPXLoader_SetSaveRedirectionPath("wiiu/apps/save/a");
+        {
+            SaveSession session;
+            BENCH_CHECK(session && session.status() == RPX_LOADER_RESULT_SUCCESS);
+            BENCH_CHECK(session.version() == MOCK_RPX_LOADER_API_VERSION);
+            BENCH_CHECK(session.GetPathOfRunningExecutable() == "wiiu/apps/a.wuhb");
+            RPXLoaderStatus status;
+            BENCH_CHECK(session.GetPathOfSaveRedirection(&status) == "wiiu/apps/save/a" && status == RPX_LOADER_RESULT_SUCCESS);
+            BENCH_CHECK(session.LaunchHomebrew("wiiu/apps/b.wuhb") == RPX_LOADER_RESULT_SUCCESS);
+            BENCH_CHECK(MockRPXLoader_GetPreparedPath() == "wiiu/apps/b.wuhb");
+
+            MockRPXLoader_SetSaveRedirectionPath(nullptr);
+            BENCH_CHECK(session.UnmountCurrentRunningBundle() == RPX_LOADER_RESULT_SUCCESS);
+            BENCH_CHECK(session.GetPathOfSaveRedirection(&status).empty() && status == RPX_LOADER_RESULT_NOT_AVAILABLE);
+        }
+        // The session deinitialized the lib.
+        BENCH_CHECK(RPXLoader_EnableContentRedirection() == RPX_LOADER_RESULT_LIB_UNINITIALIZED);
+
+        // A module that is older than the session requires.
+        MockRPXLoader_SetAPIVersion(rpxloader::API_VERSION_PATH_OF_RUNNING_EXECUTABLE);
+        {
+            SaveSession session;
+            BENCH_CHECK(!session && session.status() == RPX_LOADER_RESULT_UNSUPPORTED_API_VERSION);
+            BENCH_CHECK(RPXLoader_EnableContentRedirection() == RPX_LOADER_RESULT_LIB_UNINITIALIZED);
+        }
+        {
+            rpxloader::Session<rpxloader::API_VERSION_PATH_OF_RUNNING_EXECUTABLE> session;
+            BENCH_CHECK(session && session.version() == rpxloader::API_VERSION_PATH_OF_RUNNING_EXECUTABLE);
+        }
+
+        // A session doesn't deinitialize a lib it hasn't initialized.
+        MockRPXLoader_SetAPIVersion(MOCK_RPX_LOADER_API_VERSION);
+        bool initialized = false;
+        BENCH_CHECK(RPXLoader_InitLibraryEx(&initialized) == RPX_LOADER_RESULT_SUCCESS && initialized);
+        BENCH_CHECK(RPXLoader_InitLibraryEx(&initialized) == RPX_LOADER_RESULT_SUCCESS && !initialized);
+        {
+            SaveSession session;
+            BENCH_CHECK(session);
+        }
+        BENCH_CHECK(RPXLoader_EnableContentRedirection() == RPX_LOADER_RESULT_SUCCESS);
+        RPXLoader_DeInitLibrary();
+
+        MockRPXLoader_SetLoaded(false);
+        {
+            SaveSession session;
+            BENCH_CHECK(session.status() == RPX_LOADER_RESULT_MODULE_NOT_FOUND);
+        }
+        BenchFixture_Reset();
+    }
+}
+
+// Compare with PathCache_Hit_View.
+RPXLOADER_BENCHMARK(Session_GetPathOfRunningExecutable) {
+    BenchFixture_Reset();
+    SaveSession session;
+    BENCH_CHECK(session);
+    BENCH_CHECK(!session.GetPathOfRunningExecutable().empty());
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(session.GetPathOfRunningExecutable());
+    }
+}
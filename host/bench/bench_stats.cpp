@@ -0,0 +1,108 @@
+#include "bench_fixture.h"
+#include <rpxloader/stats.h>
+
+namespace {
+    bool IsStatsEnabled() {
+        RPXLoaderStats stats;
+        return RPXLoader_GetStats(&stats) == RPX_LOADER_RESULT_SUCCESS;
+    }
+
+    uint32_t SumHistogram(const RPXLoaderAPIStats &stats) {
+        uint32_t sum = 0;
+        for (auto count : stats.latencyHistogram) {
+            sum += count;
+        }
+        return sum;
+    }
+} // namespace
+
+// Checks the recorded counters, or that the API reports it's not available in builds without RPX_LOADER_ENABLE_STATS.
+RPXLOADER_BENCHMARK(Stats_Counters) {
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        if (!IsStatsEnabled()) {
+            BENCH_CHECK(RPXLoader_ResetStats() == RPX_LOADER_RESULT_NOT_AVAILABLE);
+            BENCH_CHECK(RPXLoader_GetStats(nullptr) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+            continue;
+        }
+        BenchFixture_Reset();
+        BENCH_CHECK(RPXLoader_ResetStats() == RPX_LOADER_RESULT_SUCCESS);
+
+        BENCH_CHECK(RPXLoader_LaunchHomebrew("wiiu/apps/a.wuhb") == RPX_LOADER_RESULT_LIB_UNINITIALIZED);
+        BenchFixture_Init();
+        for (uint32_t j = 0; j < 10; j++) {
+            BENCH_CHECK(RPXLoader_LaunchHomebrew("wiiu/apps/a.wuhb") == RPX_LOADER_RESULT_SUCCESS);
+        }
+        char path[0x100];
+        BENCH_CHECK(RPXLoader_GetPathOfRunningExecutable(path, sizeof(path)) == RPX_LOADER_RESULT_SUCCESS);
+        const char *view = nullptr;
+        BENCH_CHECK(RPXLoader_GetPathOfRunningExecutableView(&view, nullptr) == RPX_LOADER_RESULT_SUCCESS);
+
+        // A batch command the module can't execute falls back to the wrapper, which reports the unsupported command.
+        MockRPXLoader_SetExportMissing("RL_EnableContentRedirection", true);
+        RPXLoaderCommand commands[2] = {};
+        commands[0].type             = RPX_LOADER_COMMAND_DISABLE_CONTENT_REDIRECTION;
+        commands[1].type             = RPX_LOADER_COMMAND_ENABLE_CONTENT_REDIRECTION;
+        BENCH_CHECK(RPXLoader_ExecuteBatch(commands, 2, 0) == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND);
+        BENCH_CHECK(RPXLoader_EnableContentRedirection() == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND);
+
+        RPXLoaderStats stats;
+        BENCH_CHECK(RPXLoader_GetStats(&stats) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(stats.ticksPerSecond != 0);
+        auto &launch = stats.apis[RPX_LOADER_STATS_API_LAUNCH_HOMEBREW];
+        BENCH_CHECK(launch.calls == 11);
+        BENCH_CHECK(launch.callsPerCore[0] + launch.callsPerCore[1] + launch.callsPerCore[2] == 11);
+        BENCH_CHECK(launch.statusCounts[RPX_LOADER_STATS_STATUS_SUCCESS] == 10);
+        BENCH_CHECK(launch.statusCounts[RPX_LOADER_STATS_STATUS_LIB_UNINITIALIZED] == 1);
+        BENCH_CHECK(SumHistogram(launch) == 11);
+
+        auto &getPath = stats.apis[RPX_LOADER_STATS_API_GET_PATH_OF_RUNNING_EXECUTABLE];
+        BENCH_CHECK(getPath.calls == 2 && getPath.statusCounts[RPX_LOADER_STATS_STATUS_SUCCESS] == 2);
+
+        auto &batch = stats.apis[RPX_LOADER_STATS_API_EXECUTE_BATCH];
+        BENCH_CHECK(batch.calls == 1 && batch.statusCounts[RPX_LOADER_STATS_STATUS_UNSUPPORTED_COMMAND] == 1);
+        auto &enable = stats.apis[RPX_LOADER_STATS_API_ENABLE_CONTENT_REDIRECTION];
+        BENCH_CHECK(enable.calls == 2 && enable.statusCounts[RPX_LOADER_STATS_STATUS_UNSUPPORTED_COMMAND] == 2);
+        BENCH_CHECK(stats.apis[RPX_LOADER_STATS_API_GET_VERSION].calls == 0);
+
+        // A call that takes 1ms lands in the bucket of its duration.
+        BENCH_CHECK(RPXLoader_ResetStats() == RPX_LOADER_RESULT_SUCCESS);
+        MockRPXLoader_SetCallDelay(1000000);
+        BENCH_CHECK(RPXLoader_DisableContentRedirection() == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_GetStats(&stats) == RPX_LOADER_RESULT_SUCCESS);
+        auto &disable    = stats.apis[RPX_LOADER_STATS_API_DISABLE_CONTENT_REDIRECTION];
+        uint32_t minTicks = stats.ticksPerSecond / 1000;
+        uint32_t bucket   = 32 - __builtin_clz(minTicks);
+        uint32_t slower   = 0;
+        for (uint32_t j = bucket; j < RPX_LOADER_STATS_LATENCY_BUCKETS; j++) {
+            slower += disable.latencyHistogram[j];
+        }
+        BENCH_CHECK(disable.calls == 1 && slower == 1);
+        BENCH_CHECK(stats.apis[RPX_LOADER_STATS_API_LAUNCH_HOMEBREW].calls == 0);
+        BenchFixture_Reset();
+    }
+}
+
+// Compare with LaunchPreparedHomebrew in a build with and without RPX_LOADER_STATS=1.
+// On the host most of the difference is reading the clock, the console reads the time base register instead.
+RPXLOADER_BENCHMARK(Stats_RecordedCall) {
+    BenchFixture_Init();
+    RPXLoader_ResetStats();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_LaunchPreparedHomebrew());
+    }
+    state.PauseTiming();
+    RPXLoaderStats stats;
+    if (RPXLoader_GetStats(&stats) == RPX_LOADER_RESULT_SUCCESS) {
+        BENCH_CHECK(stats.apis[RPX_LOADER_STATS_API_LAUNCH_PREPARED_HOMEBREW].calls == (uint32_t) state.iterations());
+    }
+    BenchFixture_Reset();
+}
+
+RPXLOADER_BENCHMARK(Stats_GetStats) {
+    RPXLoaderStats stats;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_GetStats(&stats));
+    }
+}
@@ -0,0 +1,194 @@
+#include "bench_corpus.h"
+#include "bench_fixture.h"
+#include "trace_format.h"
+#include <coreinit/time.h>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <rpxloader/async.h>
+#include <rpxloader/preflight.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define TRACE_BENCH_DIR  "bench/trace/"
+#define TRACE_BENCH_FILE TRACE_BENCH_DIR "launch.bin"
+#define TRACE_BENCH_RPX  TRACE_BENCH_DIR "app.rpx"
+
+namespace {
+    std::vector<TraceRecord> ReadRecords() {
+        std::ifstream in(Corpus_SDPath(TRACE_BENCH_FILE), std::ios::binary);
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        TraceHeader header;
+        BENCH_CHECK(data.size() >= TRACE_HEADER_SIZE && TraceFile_LoadHeader(data.data(), &header));
+        BENCH_CHECK(header.ticksPerSecond == OSTimerClockSpeed && (data.size() - TRACE_HEADER_SIZE) % header.recordSize == 0);
+        std::vector<TraceRecord> records;
+        for (size_t offset = TRACE_HEADER_SIZE; offset < data.size(); offset += header.recordSize) {
+            TraceRecord record;
+            TraceFile_LoadRecord(&data[offset], &record);
+            records.push_back(record);
+        }
+        return records;
+    }
+
+    void AppendData(const uint8_t *data, size_t size) {
+        std::ofstream out(Corpus_SDPath(TRACE_BENCH_FILE), std::ios::binary | std::ios::app);
+        out.write((const char *) data, size);
+        BENCH_CHECK(out.good());
+    }
+
+    void AppendRecord(const TraceRecord &record) {
+        uint8_t data[TRACE_RECORD_SIZE] = {};
+        TraceFile_StoreRecord(data, record);
+        AppendData(data, sizeof(data));
+    }
+
+    void CreateRPX() {
+        static bool sCreated = Corpus_WriteSDFile(TRACE_BENCH_RPX, Corpus_BuildRPX(0x10000, 5).data);
+        BENCH_CHECK(sCreated);
+    }
+} // namespace
+
+RPXLOADER_BENCHMARK(Trace_Timeline) {
+    CreateRPX();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BenchFixture_Reset();
+        Corpus_RemoveSDPath(TRACE_BENCH_FILE);
+        BENCH_CHECK(RPXLoader_EnableLaunchTrace(nullptr) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+        BENCH_CHECK(RPXLoader_EnableLaunchTrace(TRACE_BENCH_DIR "missing/launch.bin") == RPX_LOADER_RESULT_NOT_FOUND);
+        BENCH_CHECK(RPXLoader_EnableLaunchTrace(TRACE_BENCH_RPX) == RPX_LOADER_RESULT_NOT_FOUND);
+        BENCH_CHECK(RPXLoader_EnableLaunchTrace(TRACE_BENCH_FILE) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_InitLibrary() == RPX_LOADER_RESULT_SUCCESS);
+
+        // Checks of the app that aren't part of a launch aren't traced.
+        RPXLoaderPreflightResult preflight;
+        BENCH_CHECK(RPXLoader_PreflightCheck(TRACE_BENCH_RPX, RPX_LOADER_PREFLIGHT_MODE_FULL, nullptr, nullptr, &preflight) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(ReadRecords().empty());
+
+        // Launcher: validation, prepare and the request of one launch.
+        RPXLoaderAsyncOptions options = {RPX_LOADER_PREFLIGHT_MODE_FULL, 0, nullptr, nullptr};
+        RPXLoaderAsyncLaunch *handle  = nullptr;
+        BENCH_CHECK(RPXLoader_PrepareLaunchFromSDAsync(TRACE_BENCH_RPX, &options, &handle) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_AsyncWait(handle) == RPX_LOADER_RESULT_SUCCESS);
+        RPXLoader_AsyncFree(handle);
+        BENCH_CHECK(RPXLoader_LaunchPreparedHomebrew() == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(ReadRecords().size() == 3);
+
+        // Relaunched app: a new process that only has the trace file.
+        BenchFixture_Reset();
+        auto tick                                              = (uint64_t) OSGetTime();
+        RPXLoaderTraceSpan spans[RPX_LOADER_TRACE_PHASE_COUNT] = {};
+        spans[RPX_LOADER_TRACE_PHASE_WRAPPER_STARTED]          = {tick, tick};
+        spans[RPX_LOADER_TRACE_PHASE_BUNDLE_MOUNTED]           = {tick + 100, tick + 5000};
+        MockRPXLoader_SetLaunchTimeline(spans);
+        BENCH_CHECK(RPXLoader_InitLibrary() == RPX_LOADER_RESULT_SUCCESS);
+        uint32_t written = 0;
+        BENCH_CHECK(RPXLoader_CollectLaunchTrace(&written) == RPX_LOADER_RESULT_NOT_AVAILABLE);
+        BENCH_CHECK(RPXLoader_EnableLaunchTrace(TRACE_BENCH_FILE) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_CollectLaunchTrace(&written) == RPX_LOADER_RESULT_SUCCESS && written == 2);
+        // The first content read happens later, only the new phase is appended.
+        spans[RPX_LOADER_TRACE_PHASE_FIRST_REDIRECTED_READ] = {tick + 9000, tick + 9000};
+        MockRPXLoader_SetLaunchTimeline(spans);
+        BENCH_CHECK(RPXLoader_CollectLaunchTrace(&written) == RPX_LOADER_RESULT_SUCCESS && written == 1);
+        BENCH_CHECK(RPXLoader_CollectLaunchTrace(&written) == RPX_LOADER_RESULT_SUCCESS && written == 0);
+
+        auto records                   = ReadRecords();
+        RPXLoaderTracePhase expected[] = {RPX_LOADER_TRACE_PHASE_VALIDATION, RPX_LOADER_TRACE_PHASE_PREPARE, RPX_LOADER_TRACE_PHASE_LAUNCH_REQUESTED,
+                                          RPX_LOADER_TRACE_PHASE_WRAPPER_STARTED, RPX_LOADER_TRACE_PHASE_BUNDLE_MOUNTED, RPX_LOADER_TRACE_PHASE_FIRST_REDIRECTED_READ};
+        BENCH_CHECK(records.size() == 6);
+        for (uint32_t j = 0; j < records.size(); j++) {
+            auto &record = records[j];
+            BENCH_CHECK(record.phase == expected[j] && record.source == (j < 3 ? TRACE_SOURCE_LIB : TRACE_SOURCE_MODULE));
+            BENCH_CHECK(record.launchId == records[0].launchId && strcmp(record.name, "app.rpx") == 0);
+            BENCH_CHECK(record.status == RPX_LOADER_RESULT_SUCCESS && record.moduleVersion == MOCK_RPX_LOADER_API_VERSION);
+            BENCH_CHECK(record.begin <= record.end && (j == 0 || record.begin >= records[j - 1].begin));
+        }
+        BENCH_CHECK(records[4].begin == tick + 100 && records[4].end == tick + 5000);
+
+        // A failed request doesn't end the launch, the next one does. Both belong to a new launch.
+        BENCH_CHECK(RPXLoader_LaunchPreparedHomebrew() == RPX_LOADER_RESULT_NOT_FOUND);
+        BENCH_CHECK(RPXLoader_LaunchHomebrew(TRACE_BENCH_DIR "other.wuhb") == RPX_LOADER_RESULT_SUCCESS);
+        records = ReadRecords();
+        BENCH_CHECK(records.size() == 8 && records[6].status == RPX_LOADER_RESULT_NOT_FOUND);
+        BENCH_CHECK(records[6].launchId == records[7].launchId && records[6].launchId != records[0].launchId);
+        BENCH_CHECK(strcmp(records[7].name, "other.wuhb") == 0);
+        // Module phases from before the last request belong to an earlier launch.
+        spans[RPX_LOADER_TRACE_PHASE_BUNDLE_MOUNTED]        = {tick, tick};
+        spans[RPX_LOADER_TRACE_PHASE_FIRST_REDIRECTED_READ] = {tick, tick};
+        MockRPXLoader_SetLaunchTimeline(spans);
+        BENCH_CHECK(RPXLoader_CollectLaunchTrace(&written) == RPX_LOADER_RESULT_SUCCESS && written == 0);
+
+        // While tracing, launch commands of a batch aren't handed to the module as a whole.
+        RPXLoaderCommand commands[2] = {};
+        commands[0].type             = RPX_LOADER_COMMAND_PREPARE_LAUNCH_FROM_SD;
+        commands[0].args.launch.path = TRACE_BENCH_RPX;
+        commands[1].type             = RPX_LOADER_COMMAND_LAUNCH_PREPARED_HOMEBREW;
+        BENCH_CHECK(RPXLoader_ExecuteBatch(commands, 2, 0) == RPX_LOADER_RESULT_SUCCESS);
+        records = ReadRecords();
+        BENCH_CHECK(records.size() == 10 && records[8].phase == RPX_LOADER_TRACE_PHASE_PREPARE && records[9].phase == RPX_LOADER_TRACE_PHASE_LAUNCH_REQUESTED);
+
+        // Unknown phases, e.g. from a newer lib version, are ignored.
+        auto unknown   = records[9];
+        unknown.phase  = 40;
+        unknown.source = TRACE_SOURCE_MODULE;
+        AppendRecord(unknown);
+        BENCH_CHECK(RPXLoader_CollectLaunchTrace(&written) == RPX_LOADER_RESULT_SUCCESS && written == 0);
+
+        // Nothing is written once tracing is disabled.
+        RPXLoader_DisableLaunchTrace();
+        BENCH_CHECK(RPXLoader_LaunchHomebrew(TRACE_BENCH_DIR "other.wuhb") == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(ReadRecords().size() == 11);
+
+        // An append that was cut off is overwritten by the next record, the following records keep their stride.
+        uint8_t partial[0x10] = {};
+        AppendData(partial, sizeof(partial));
+        BENCH_CHECK(RPXLoader_EnableLaunchTrace(TRACE_BENCH_FILE) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_LaunchHomebrew(TRACE_BENCH_DIR "other.wuhb") == RPX_LOADER_RESULT_SUCCESS);
+        records = ReadRecords();
+        BENCH_CHECK(records.size() == 12 && records[11].phase == RPX_LOADER_TRACE_PHASE_LAUNCH_REQUESTED && strcmp(records[11].name, "other.wuhb") == 0);
+        RPXLoader_DisableLaunchTrace();
+
+        // Files of other versions aren't continued, this version's records would break their stride.
+        for (auto [version, recordSize] : {std::pair{TRACE_FILE_VERSION + 1, TRACE_RECORD_SIZE}, std::pair{TRACE_FILE_VERSION, TRACE_RECORD_SIZE + 0x10}}) {
+            uint8_t header[TRACE_HEADER_SIZE];
+            TraceFile_StoreHeader(header, {TRACE_FILE_MAGIC, (uint16_t) version, (uint16_t) recordSize, (uint32_t) OSTimerClockSpeed});
+            BENCH_CHECK(Corpus_WriteSDFile(TRACE_BENCH_FILE, std::vector<uint8_t>(header, header + sizeof(header))));
+            BENCH_CHECK(RPXLoader_EnableLaunchTrace(TRACE_BENCH_FILE) == RPX_LOADER_RESULT_NOT_FOUND);
+        }
+        Corpus_RemoveSDPath(TRACE_BENCH_FILE);
+
+        // Older modules don't know the phases of the wrapper app.
+        BenchFixture_Reset();
+        MockRPXLoader_SetAPIVersion(5);
+        BENCH_CHECK(RPXLoader_InitLibrary() == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_EnableLaunchTrace(TRACE_BENCH_FILE) == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_CollectLaunchTrace(&written) == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND && written == 0);
+        BenchFixture_Reset();
+        BENCH_CHECK(RPXLoader_CollectLaunchTrace(&written) == RPX_LOADER_RESULT_LIB_UNINITIALIZED);
+    }
+}
+
+// Baseline: with tracing disabled the launch functions only check a flag.
+RPXLOADER_BENCHMARK(Trace_PrepareLaunchFromSD_Disabled) {
+    BenchFixture_Init();
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BENCH_CHECK(RPXLoader_PrepareLaunchFromSD(TRACE_BENCH_RPX) == RPX_LOADER_RESULT_SUCCESS);
+    }
+    state.PauseTiming();
+    BenchFixture_Reset();
+}
+
+// Includes appending the record to the trace file.
+RPXLOADER_BENCHMARK(Trace_PrepareLaunchFromSD_Enabled) {
+    BenchFixture_Init();
+    Corpus_RemoveSDPath(TRACE_BENCH_FILE);
+    BENCH_CHECK(RPXLoader_EnableLaunchTrace(TRACE_BENCH_FILE) == RPX_LOADER_RESULT_SUCCESS);
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BENCH_CHECK(RPXLoader_PrepareLaunchFromSD(TRACE_BENCH_RPX) == RPX_LOADER_RESULT_SUCCESS);
+    }
+    state.PauseTiming();
+    BenchFixture_Reset();
+    Corpus_RemoveSDPath(TRACE_BENCH_FILE);
+}
@@ -0,0 +1,130 @@
+#include "bench_fixture.h"
+#include <cstdio>
+#include <cstring>
+#include <rpxloader/translate.h>
+#include <string>
+#include <vector>
+
+#define TRANSLATE_PATH_COUNT 20000
+
+namespace {
+    // Half save files, half content files, like the file list of a save sync.
+    struct PathList {
+        std::vector<std::string> storage;
+        std::vector<const char *> paths;
+        uint64_t bytes = 0;
+
+        PathList() {
+            for (uint32_t i = 0; i < TRANSLATE_PATH_COUNT; i++) {
+                char path[64];
+                if (i % 2 == 0) {
+                    snprintf(path, sizeof(path), "/vol/save/common/slot%02u/file_%05u.bin", i % 16, i);
+                } else {
+                    snprintf(path, sizeof(path), "/vol/content/data/level%02u/asset_%05u.bin", i % 16, i);
+                }
+                storage.emplace_back(path);
+                bytes += storage.back().size();
+            }
+            for (auto &cur : storage) {
+                paths.push_back(cur.c_str());
+            }
+        }
+    };
+
+    const PathList &GetPathList() {
+        static PathList sList;
+        return sList;
+    }
+} // namespace
+
+RPXLOADER_BENCHMARK(TranslatePaths_Results) {
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        BenchFixture_Reset();
+        const char *paths[] = {"/vol/save/common/a.bin", "/vol/content//data/b.bin", "/vol/save", "/vol/saveX/c", "/vol/external01/d", nullptr};
+        RPXLoaderTranslatedPath out[6];
+        char arena[256];
+        uint32_t required = 0;
+        BENCH_CHECK(RPXLoader_TranslatePaths(paths, 6, arena, sizeof(arena), out, &required) == RPX_LOADER_RESULT_LIB_UNINITIALIZED);
+
+        BenchFixture_Init();
+        BENCH_CHECK(RPXLoader_TranslatePaths(nullptr, 6, arena, sizeof(arena), out, &required) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+        BENCH_CHECK(RPXLoader_TranslatePaths(paths, 6, arena, sizeof(arena), out, &required) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+        BENCH_CHECK(out[0].status == RPX_LOADER_RESULT_SUCCESS && out[0].location == RPX_LOADER_PATH_LOCATION_SD);
+        BENCH_CHECK(strcmp(out[0].path, "wiiu/apps/save/00050000/mock/common/a.bin") == 0 && out[0].length == strlen(out[0].path));
+        BENCH_CHECK(out[1].status == RPX_LOADER_RESULT_SUCCESS && out[1].location == RPX_LOADER_PATH_LOCATION_BUNDLE);
+        BENCH_CHECK(strcmp(out[1].path, "content/data/b.bin") == 0);
+        BENCH_CHECK(out[2].status == RPX_LOADER_RESULT_SUCCESS && strcmp(out[2].path, "wiiu/apps/save/00050000/mock") == 0);
+        for (uint32_t j = 3; j < 6; j++) {
+            BENCH_CHECK(out[j].status == RPX_LOADER_RESULT_INVALID_ARGUMENT && out[j].path == nullptr);
+        }
+        BENCH_CHECK(required == out[0].length + out[1].length + out[2].length + 3);
+        BENCH_CHECK(out[0].path == arena && out[1].path == out[0].path + out[0].length + 1);
+
+        // Size query, then an arena that only fits the first path.
+        auto firstSize = out[0].length + 1;
+        BENCH_CHECK(RPXLoader_TranslatePaths(paths, 3, nullptr, 0, out, &required) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+        BENCH_CHECK(out[0].status == RPX_LOADER_RESULT_INVALID_ARGUMENT && out[0].path == nullptr);
+        BENCH_CHECK(RPXLoader_TranslatePaths(paths, 3, arena, firstSize + 5, out, &required) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+        BENCH_CHECK(out[0].status == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(out[1].status == RPX_LOADER_RESULT_INVALID_ARGUMENT && out[2].status == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+        BENCH_CHECK(RPXLoader_TranslatePaths(paths, 3, arena, required, out, nullptr) == RPX_LOADER_RESULT_SUCCESS);
+
+        // /vol/content is only redirected for bundles, /vol/save needs API version 3.
+        MockRPXLoader_SetRunningExecutablePath("wiiu/apps/app.rpx");
+        BENCH_CHECK(RPXLoader_UnmountCurrentRunningBundle() == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_TranslatePaths(paths, 2, arena, sizeof(arena), out, nullptr) == RPX_LOADER_RESULT_NOT_AVAILABLE);
+        BENCH_CHECK(out[0].status == RPX_LOADER_RESULT_SUCCESS && out[1].status == RPX_LOADER_RESULT_NOT_AVAILABLE);
+
+        MockRPXLoader_SetAPIVersion(2);
+        BENCH_CHECK(RPXLoader_DeInitLibrary() == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_InitLibrary() == RPX_LOADER_RESULT_SUCCESS);
+        BENCH_CHECK(RPXLoader_TranslatePaths(paths, 2, arena, sizeof(arena), out, nullptr) == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND);
+        BENCH_CHECK(out[0].status == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND && out[1].status == RPX_LOADER_RESULT_NOT_AVAILABLE);
+        BenchFixture_Reset();
+    }
+}
+
+// Translates TRANSLATE_PATH_COUNT paths per iteration, the throughput refers to the input paths.
+RPXLOADER_BENCHMARK(TranslatePaths_Bulk) {
+    auto &list = GetPathList();
+    BenchFixture_Init();
+    std::vector<RPXLoaderTranslatedPath> out(TRANSLATE_PATH_COUNT);
+    uint32_t required = 0;
+    BENCH_CHECK(RPXLoader_TranslatePaths(list.paths.data(), TRANSLATE_PATH_COUNT, nullptr, 0, out.data(), &required) == RPX_LOADER_RESULT_INVALID_ARGUMENT);
+    std::vector<char> arena(required);
+    state.SetBytesPerIteration(list.bytes);
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        Bench_DoNotOptimize(RPXLoader_TranslatePaths(list.paths.data(), TRANSLATE_PATH_COUNT, arena.data(), arena.size(), out.data(), nullptr));
+    }
+    state.PauseTiming();
+    BENCH_CHECK(RPXLoader_TranslatePaths(list.paths.data(), TRANSLATE_PATH_COUNT, arena.data(), arena.size(), out.data(), nullptr) == RPX_LOADER_RESULT_SUCCESS);
+    BENCH_CHECK(strcmp(out[1].path, "content/data/level01/asset_00001.bin") == 0);
+    BenchFixture_Reset();
+}
+
+// What apps had to do before: query the redirection path for every file and build the path themselves.
+RPXLOADER_BENCHMARK(TranslatePaths_PerPathBaseline) {
+    auto &list = GetPathList();
+    BenchFixture_Init();
+    std::vector<std::string> out(TRANSLATE_PATH_COUNT);
+    state.SetBytesPerIteration(list.bytes);
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.iterations(); i++) {
+        for (uint32_t j = 0; j < TRANSLATE_PATH_COUNT; j++) {
+            char prefix[0x200];
+            auto path = list.paths[j];
+            if (strncmp(path, "/vol/save/", 10) == 0) {
+                RPXLoader_GetPathOfSaveRedirection(prefix, sizeof(prefix));
+                out[j] = std::string(prefix) + "/" + (path + 10);
+            } else {
+                RPXLoader_GetPathOfRunningExecutable(prefix, sizeof(prefix));
+                out[j] = std::string("content/") + (path + 13);
+            }
+        }
+        Bench_DoNotOptimize(out.data());
+    }
+    state.PauseTiming();
+    BENCH_CHECK(out[1] == "content/data/level01/asset_00001.bin");
+    BenchFixture_Reset();
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+/**
+ * Host-side stand-in for wut's <coreinit/core.h>.
+ * Only the subset used by librpxloader is provided.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Returns 0-2, derived from the cpu the calling thread currently runs on.
+ */
+uint32_t OSGetCoreId();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
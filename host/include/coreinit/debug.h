@@ -0,0 +1,16 @@
+#pragma once
+
+/**
+ * Host-side stand-in for wut's <coreinit/debug.h>.
+ * Only the subset used by librpxloader is provided.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void OSReport(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
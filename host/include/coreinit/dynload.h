@@ -0,0 +1,37 @@
+#pragma once
+
+/**
+ * Host-side stand-in for wut's <coreinit/dynload.h>.
+ * Modules are registered by the mock layer (see host/mock/mock_dynload.h).
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void *OSDynLoad_Module;
+
+typedef enum OSDynLoad_Error {
+    OS_DYNLOAD_OK                 = 0,
+    OS_DYNLOAD_OUT_OF_MEMORY      = 0xBAD10002,
+    OS_DYNLOAD_INVALID_NOTIFY_PTR = 0xBAD1000E,
+    OS_DYNLOAD_INVALID_MODULE_PTR = 0xBAD1000F,
+    OS_DYNLOAD_INVALID_EXPORT_PTR = 0xBAD10010,
+    OS_DYNLOAD_MODULE_NOT_FOUND   = 0xBAD10016,
+    OS_DYNLOAD_EXPORT_NOT_FOUND   = 0xBAD10017,
+} OSDynLoad_Error;
+
+typedef enum OSDynLoad_ExportType {
+    OS_DYNLOAD_EXPORT_FUNC = 0,
+    OS_DYNLOAD_EXPORT_DATA = 1,
+} OSDynLoad_ExportType;
+
+OSDynLoad_Error OSDynLoad_Acquire(char const *name, OSDynLoad_Module *outModule);
+
+OSDynLoad_Error OSDynLoad_FindExport(OSDynLoad_Module module, OSDynLoad_ExportType exportType, char const *name, void **outAddr);
+
+void OSDynLoad_Release(OSDynLoad_Module module);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+ * Host-side stand-in for wut's <coreinit/time.h>.
+ * Only the subset used by librpxloader is provided.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int32_t OSTick;
+typedef int64_t OSTime;
+
+// On the console this is the bus clock speed / 4.
+#define OSTimerClockSpeed         62156250
+#define OSTicksToNanoseconds(val) ((((uint64_t) (val)) * 8000) / ((uint64_t) (OSTimerClockSpeed / 125000)))
+
+OSTick OSGetSystemTick();
+
+OSTime OSGetTime();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,138 @@
+#include "mock_dynload.h"
+#include <atomic>
+#include <chrono>
+#include <coreinit/debug.h>
+#include <coreinit/dynload.h>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+    struct MockModule {
+        std::string name;
+        std::vector<MockDynLoadExport> exports;
+    };
+
+    std::mutex sModulesMutex;
+    // Unregistered modules are kept alive, handles acquired earlier may still point at them.
+    std::vector<std::unique_ptr<MockModule>> sModules;
+    std::vector<std::unique_ptr<MockModule>> sRetiredModules;
+
+    std::atomic<uint32_t> sLookupDelayNs{0};
+    std::atomic<bool> sReportEcho{false};
+
+    std::atomic<uint64_t> sAcquireCalls{0};
+    std::atomic<uint64_t> sFindExportCalls{0};
+    std::atomic<uint64_t> sReleaseCalls{0};
+    std::atomic<uint64_t> sReportCalls{0};
+
+    void SimulateLookupCost() {
+        auto delay = sLookupDelayNs.load(std::memory_order_relaxed);
+        if (delay == 0) {
+            return;
+        }
+        auto end = std::chrono::steady_clock::now() + std::chrono::nanoseconds(delay);
+        while (std::chrono::steady_clock::now() < end) {}
+    }
+} // namespace
+
+void MockDynLoad_RegisterModule(const char *name, const MockDynLoadExport *exports, uint32_t exportCount) {
+    std::lock_guard<std::mutex> lock(sModulesMutex);
+    for (auto &cur : sModules) {
+        if (cur->name == name) {
+            // Handles acquired earlier have to see the new exports as well.
+            cur->exports.assign(exports, exports + exportCount);
+            return;
+        }
+    }
+    auto module  = std::make_unique<MockModule>();
+    module->name = name;
+    module->exports.assign(exports, exports + exportCount);
+    sModules.push_back(std::move(module));
+}
+
+void MockDynLoad_UnregisterModule(const char *name) {
+    std::lock_guard<std::mutex> lock(sModulesMutex);
+    for (auto it = sModules.begin(); it != sModules.end(); ++it) {
+        if ((*it)->name == name) {
+            sRetiredModules.push_back(std::move(*it));
+            sModules.erase(it);
+            return;
+        }
+    }
+}
+
+void MockDynLoad_SetLookupDelay(uint32_t nanoseconds) {
+    sLookupDelayNs = nanoseconds;
+}
+
+void MockOSReport_SetEcho(bool echo) {
+    sReportEcho = echo;
+}
+
+MockDynLoadCounters MockDynLoad_GetCounters() {
+    return {sAcquireCalls.load(), sFindExportCalls.load(), sReleaseCalls.load(), sReportCalls.load()};
+}
+
+void MockDynLoad_ResetCounters() {
+    sAcquireCalls    = 0;
+    sFindExportCalls = 0;
+    sReleaseCalls    = 0;
+    sReportCalls     = 0;
+}
+
+OSDynLoad_Error OSDynLoad_Acquire(char const *name, OSDynLoad_Module *outModule) {
+    sAcquireCalls.fetch_add(1, std::memory_order_relaxed);
+    SimulateLookupCost();
+    if (name == nullptr || outModule == nullptr) {
+        return OS_DYNLOAD_INVALID_MODULE_PTR;
+    }
+    std::lock_guard<std::mutex> lock(sModulesMutex);
+    for (auto &cur : sModules) {
+        if (cur->name == name) {
+            *outModule = cur.get();
+            return OS_DYNLOAD_OK;
+        }
+    }
+    return OS_DYNLOAD_MODULE_NOT_FOUND;
+}
+
+OSDynLoad_Error OSDynLoad_FindExport(OSDynLoad_Module module, OSDynLoad_ExportType exportType, char const *name, void **outAddr) {
+    sFindExportCalls.fetch_add(1, std::memory_order_relaxed);
+    SimulateLookupCost();
+    if (module == nullptr) {
+        return OS_DYNLOAD_INVALID_MODULE_PTR;
+    }
+    if (name == nullptr || outAddr == nullptr || exportType != OS_DYNLOAD_EXPORT_FUNC) {
+        return OS_DYNLOAD_INVALID_EXPORT_PTR;
+    }
+    std::lock_guard<std::mutex> lock(sModulesMutex);
+    for (auto &exp : static_cast<MockModule *>(module)->exports) {
+        if (strcmp(exp.name, name) == 0) {
+            *outAddr = exp.address;
+            return OS_DYNLOAD_OK;
+        }
+    }
+    return OS_DYNLOAD_EXPORT_NOT_FOUND;
+}
+
+void OSDynLoad_Release(OSDynLoad_Module module) {
+    (void) module;
+    sReleaseCalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OSReport(const char *fmt, ...) {
+    sReportCalls.fetch_add(1, std::memory_order_relaxed);
+    char buffer[512];
+    va_list va;
+    va_start(va, fmt);
+    vsnprintf(buffer, sizeof(buffer), fmt, va);
+    va_end(va);
+    if (sReportEcho.load(std::memory_order_relaxed)) {
+        fputs(buffer, stderr);
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Control interface of the host-side OSDynLoad/OSReport stand-in.
+ * Modules registered here can be acquired via OSDynLoad_Acquire and their exports
+ * resolved via OSDynLoad_FindExport, just like real RPLs on the console.
+ */
+
+struct MockDynLoadExport {
+    const char *name;
+    void *address;
+};
+
+struct MockDynLoadCounters {
+    uint64_t acquireCalls;
+    uint64_t findExportCalls;
+    uint64_t releaseCalls;
+    uint64_t reportCalls;
+};
+
+/**
+ * Registers a module or replaces the exports of an already registered one. The export table is copied, the names
+ * have to outlive the registration.
+ */
+void MockDynLoad_RegisterModule(const char *name, const MockDynLoadExport *exports, uint32_t exportCount);
+
+void MockDynLoad_UnregisterModule(const char *name);
+
+/**
+ * Adds an artificial busy-wait to every OSDynLoad_Acquire/OSDynLoad_FindExport call to model the
+ * cost of the loader on the console. 0 (default) disables the delay.
+ */
+void MockDynLoad_SetLookupDelay(uint32_t nanoseconds);
+
+/**
+ * When enabled, OSReport output is written to stderr. It is always formatted either way.
+ */
+void MockOSReport_SetEcho(bool echo);
+
+MockDynLoadCounters MockDynLoad_GetCounters();
+
+void MockDynLoad_ResetCounters();
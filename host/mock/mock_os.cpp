@@ -0,0 +1,20 @@
+#include <chrono>
+#include <coreinit/core.h>
+#include <coreinit/time.h>
+#include <sched.h>
+
+// Time and core functions of coreinit, backed by the host clock/scheduler.
+
+OSTime OSGetTime() {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    return (OSTime) (ns * (OSTimerClockSpeed / 1e9));
+}
+
+OSTick OSGetSystemTick() {
+    return (OSTick) OSGetTime();
+}
+
+uint32_t OSGetCoreId() {
+    auto cpu = sched_getcpu();
+    return cpu < 0 ? 0 : (uint32_t) cpu % 3;
+}
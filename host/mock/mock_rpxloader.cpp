@@ -0,0 +1,443 @@
+#include "mock_rpxloader.h"
+#include "mock_dynload.h"
+#include <atomic>
+#include <chrono>
+#include <coreinit/time.h>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#define MOCK_RPX_LOADER_MODULE_NAME "homebrew_rpx_loader"
+
+namespace {
+    std::mutex sStateMutex;
+    bool sLoaded                        = true;
+    std::atomic<RPXLoaderVersion> sVersion{MOCK_RPX_LOADER_API_VERSION};
+    std::set<std::string> sMissingExports;
+    std::string sRunningExecutablePath;
+    bool sRunningExecutableAvailable = false;
+    std::string sSaveRedirectionPath;
+    bool sSaveRedirectionAvailable = false;
+    std::string sPreparedPath;
+    std::atomic<bool> sContentRedirectionEnabled{false};
+    std::atomic<uint32_t> sCallDelayNs{0};
+    MockRPXLoaderPrefetch sPrefetch;
+    RPXLoaderTraceSpan sLaunchTimeline[RPX_LOADER_TRACE_PHASE_COUNT];
+    std::atomic<RPXLoaderAccessLog *> sAccessLog{nullptr};
+
+    struct {
+        std::atomic<uint64_t> getVersion;
+        std::atomic<uint64_t> prepareLaunchFromSD;
+        std::atomic<uint64_t> launchPreparedHomebrew;
+        std::atomic<uint64_t> launchHomebrew;
+        std::atomic<uint64_t> enableContentRedirection;
+        std::atomic<uint64_t> disableContentRedirection;
+        std::atomic<uint64_t> unmountCurrentRunningBundle;
+        std::atomic<uint64_t> getPathOfRunningExecutable;
+        std::atomic<uint64_t> getPathOfSaveRedirection;
+        std::atomic<uint64_t> executeBatch;
+        std::atomic<uint64_t> prefetchBundle;
+        std::atomic<uint64_t> getLaunchTimeline;
+        std::atomic<uint64_t> setAccessLog;
+    } sCalls;
+
+    thread_local bool tInsideBatch = false;
+
+    // Models the cost of entering the module from another RPL.
+    void SimulateCallCost() {
+        if (tInsideBatch) {
+            return;
+        }
+        auto delay = sCallDelayNs.load(std::memory_order_relaxed);
+        if (delay == 0) {
+            return;
+        }
+        auto end = std::chrono::steady_clock::now() + std::chrono::nanoseconds(delay);
+        while (std::chrono::steady_clock::now() < end) {}
+    }
+
+    RPXLoaderStatus CopyPath(const std::string &path, bool available, char *outBuffer, uint32_t outSize) {
+        if (outBuffer == nullptr || outSize == 0) {
+            return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+        }
+        if (!available) {
+            return RPX_LOADER_RESULT_NOT_AVAILABLE;
+        }
+        strncpy(outBuffer, path.c_str(), outSize - 1);
+        outBuffer[outSize - 1] = '\0';
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+
+    RPXLoaderStatus RL_GetVersion(RPXLoaderVersion *outVersion) {
+        sCalls.getVersion++;
+        SimulateCallCost();
+        if (outVersion == nullptr) {
+            return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+        }
+        *outVersion = sVersion;
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+
+    RPXLoaderStatus RL_PrepareLaunchFromSD(const char *path) {
+        sCalls.prepareLaunchFromSD++;
+        SimulateCallCost();
+        if (path == nullptr) {
+            return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+        }
+        std::lock_guard<std::mutex> lock(sStateMutex);
+        sPreparedPath = path;
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+
+    RPXLoaderStatus RL_LaunchPreparedHomebrew() {
+        sCalls.launchPreparedHomebrew++;
+        SimulateCallCost();
+        std::lock_guard<std::mutex> lock(sStateMutex);
+        if (sPreparedPath.empty()) {
+            return RPX_LOADER_RESULT_NOT_FOUND;
+        }
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+
+    RPXLoaderStatus RL_LaunchHomebrew(const char *bundle_path) {
+        sCalls.launchHomebrew++;
+        SimulateCallCost();
+        if (bundle_path == nullptr) {
+            return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+        }
+        std::lock_guard<std::mutex> lock(sStateMutex);
+        sPreparedPath = bundle_path;
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+
+    RPXLoaderStatus RL_EnableContentRedirection() {
+        sCalls.enableContentRedirection++;
+        SimulateCallCost();
+        sContentRedirectionEnabled = true;
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+
+    RPXLoaderStatus RL_DisableContentRedirection() {
+        sCalls.disableContentRedirection++;
+        SimulateCallCost();
+        sContentRedirectionEnabled = false;
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+
+    RPXLoaderStatus RL_UnmountCurrentRunningBundle() {
+        sCalls.unmountCurrentRunningBundle++;
+        SimulateCallCost();
+        sContentRedirectionEnabled = false;
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+
+    RPXLoaderStatus RL_GetPathOfRunningExecutable(char *outBuffer, uint32_t outSize) {
+        sCalls.getPathOfRunningExecutable++;
+        SimulateCallCost();
+        std::lock_guard<std::mutex> lock(sStateMutex);
+        return CopyPath(sRunningExecutablePath, sRunningExecutableAvailable, outBuffer, outSize);
+    }
+
+    RPXLoaderStatus RL_GetPathOfSaveRedirection(char *outBuffer, uint32_t outSize) {
+        sCalls.getPathOfSaveRedirection++;
+        SimulateCallCost();
+        std::lock_guard<std::mutex> lock(sStateMutex);
+        return CopyPath(sSaveRedirectionPath, sSaveRedirectionAvailable, outBuffer, outSize);
+    }
+
+    bool IsExportMissing(const char *exportName) {
+        std::lock_guard<std::mutex> lock(sStateMutex);
+        return sMissingExports.count(exportName) != 0;
+    }
+
+    RPXLoaderStatus ExecuteCommand(RPXLoaderCommand &command) {
+        // A module without the matching export doesn't know the command inside a batch either.
+        static const char *sCommandExports[] = {
+                "RL_GetVersion",
+                "RL_PrepareLaunchFromSD",
+                "RL_LaunchPreparedHomebrew",
+                "RL_LaunchHomebrew",
+                "RL_EnableContentRedirection",
+                "RL_DisableContentRedirection",
+                "RL_UnmountCurrentRunningBundle",
+                "RL_GetPathOfRunningExecutable",
+                "RL_GetPathOfSaveRedirection",
+        };
+        if ((uint32_t) command.type >= sizeof(sCommandExports) / sizeof(sCommandExports[0]) || IsExportMissing(sCommandExports[command.type])) {
+            return RPX_LOADER_RESULT_UNSUPPORTED_COMMAND;
+        }
+        switch (command.type) {
+            case RPX_LOADER_COMMAND_GET_VERSION:
+                return RL_GetVersion(command.args.getVersion.outVersion);
+            case RPX_LOADER_COMMAND_PREPARE_LAUNCH_FROM_SD:
+                return RL_PrepareLaunchFromSD(command.args.launch.path);
+            case RPX_LOADER_COMMAND_LAUNCH_PREPARED_HOMEBREW:
+                return RL_LaunchPreparedHomebrew();
+            case RPX_LOADER_COMMAND_LAUNCH_HOMEBREW:
+                return RL_LaunchHomebrew(command.args.launch.path);
+            case RPX_LOADER_COMMAND_ENABLE_CONTENT_REDIRECTION:
+                return RL_EnableContentRedirection();
+            case RPX_LOADER_COMMAND_DISABLE_CONTENT_REDIRECTION:
+                return RL_DisableContentRedirection();
+            case RPX_LOADER_COMMAND_UNMOUNT_CURRENT_RUNNING_BUNDLE:
+                return RL_UnmountCurrentRunningBundle();
+            case RPX_LOADER_COMMAND_GET_PATH_OF_RUNNING_EXECUTABLE:
+                return RL_GetPathOfRunningExecutable(command.args.getPath.outBuffer, command.args.getPath.outSize);
+            case RPX_LOADER_COMMAND_GET_PATH_OF_SAVE_REDIRECTION:
+                return RL_GetPathOfSaveRedirection(command.args.getPath.outBuffer, command.args.getPath.outSize);
+        }
+        return RPX_LOADER_RESULT_UNSUPPORTED_COMMAND;
+    }
+
+    RPXLoaderStatus RL_ExecuteBatch(RPXLoaderCommand *commands, uint32_t count, uint32_t *outProcessed) {
+        sCalls.executeBatch++;
+        SimulateCallCost();
+        if (commands == nullptr || outProcessed == nullptr) {
+            return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+        }
+        // Always stops at the first failing command, the lib decides how to continue.
+        for (uint32_t i = 0; i < count; i++) {
+            // Commands are executed internally, they don't pay the entry cost again.
+            tInsideBatch = true;
+            auto status  = ExecuteCommand(commands[i]);
+            tInsideBatch = false;
+
+            commands[i].status = status;
+            if (status != RPX_LOADER_RESULT_SUCCESS) {
+                *outProcessed = i + 1;
+                return status;
+            }
+        }
+        *outProcessed = count;
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+
+    // Reads the ranges right away, the real module does it in the background.
+    RPXLoaderStatus RL_PrefetchBundle(const char *bundlePath, const RPXLoaderPrefetchRange *ranges, uint32_t count) {
+        sCalls.prefetchBundle++;
+        SimulateCallCost();
+        if (bundlePath == nullptr || (ranges == nullptr && count > 0)) {
+            return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+        }
+        MockRPXLoaderPrefetch prefetch;
+        prefetch.bundlePath = bundlePath;
+        auto file           = fopen((std::string(RPX_LOADER_SD_ROOT) + bundlePath).c_str(), "rb");
+        if (file == nullptr) {
+            return RPX_LOADER_RESULT_NOT_FOUND;
+        }
+        std::vector<uint8_t> buffer;
+        auto res = RPX_LOADER_RESULT_SUCCESS;
+        for (uint32_t i = 0; i < count; i++) {
+            buffer.resize(ranges[i].size);
+            if (fseeko(file, ranges[i].offset, SEEK_SET) != 0 || fread(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+                res = RPX_LOADER_RESULT_INVALID_ARGUMENT;
+                break;
+            }
+            prefetch.ranges.push_back(ranges[i]);
+            prefetch.bytesRead += ranges[i].size;
+        }
+        fclose(file);
+        if (res == RPX_LOADER_RESULT_SUCCESS) {
+            std::lock_guard<std::mutex> lock(sStateMutex);
+            sPrefetch = prefetch;
+        }
+        return res;
+    }
+
+    // The real module only knows the phases that happen inside the wrapper app.
+    RPXLoaderStatus RL_GetLaunchTimeline(RPXLoaderTraceSpan *outSpans, uint32_t count) {
+        sCalls.getLaunchTimeline++;
+        SimulateCallCost();
+        if (outSpans == nullptr) {
+            return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+        }
+        std::lock_guard<std::mutex> lock(sStateMutex);
+        for (uint32_t i = 0; i < count; i++) {
+            outSpans[i] = i >= RPX_LOADER_TRACE_PHASE_WRAPPER_STARTED && i < RPX_LOADER_TRACE_PHASE_COUNT ? sLaunchTimeline[i] : RPXLoaderTraceSpan{};
+        }
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+
+    RPXLoaderStatus RL_SetAccessLog(RPXLoaderAccessLog *log) {
+        sCalls.setAccessLog++;
+        SimulateCallCost();
+        if (log != nullptr && (log->records == nullptr || log->capacity == 0)) {
+            return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+        }
+        // The accesses are recorded synchronously, nothing writes into the old log after the exchange.
+        sAccessLog.store(log);
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+
+    const MockDynLoadExport sAllExports[] = {
+            {"RL_GetVersion", (void *) &RL_GetVersion},
+            {"RL_PrepareLaunchFromSD", (void *) &RL_PrepareLaunchFromSD},
+            {"RL_LaunchPreparedHomebrew", (void *) &RL_LaunchPreparedHomebrew},
+            {"RL_LaunchHomebrew", (void *) &RL_LaunchHomebrew},
+            {"RL_EnableContentRedirection", (void *) &RL_EnableContentRedirection},
+            {"RL_DisableContentRedirection", (void *) &RL_DisableContentRedirection},
+            {"RL_UnmountCurrentRunningBundle", (void *) &RL_UnmountCurrentRunningBundle},
+            {"RL_GetPathOfRunningExecutable", (void *) &RL_GetPathOfRunningExecutable},
+            {"RL_GetPathOfSaveRedirection", (void *) &RL_GetPathOfSaveRedirection},
+            {"RL_ExecuteBatch", (void *) &RL_ExecuteBatch},
+            {"RL_PrefetchBundle", (void *) &RL_PrefetchBundle},
+            {"RL_GetLaunchTimeline", (void *) &RL_GetLaunchTimeline},
+            {"RL_SetAccessLog", (void *) &RL_SetAccessLog},
+    };
+
+    // Has to be called with sStateMutex held.
+    void UpdateRegistration() {
+        if (!sLoaded) {
+            MockDynLoad_UnregisterModule(MOCK_RPX_LOADER_MODULE_NAME);
+            return;
+        }
+        std::vector<MockDynLoadExport> exports;
+        for (auto &exp : sAllExports) {
+            if (sMissingExports.count(exp.name) == 0) {
+                exports.push_back(exp);
+            }
+        }
+        MockDynLoad_RegisterModule(MOCK_RPX_LOADER_MODULE_NAME, exports.data(), exports.size());
+    }
+} // namespace
+
+void MockRPXLoader_Reset() {
+    std::lock_guard<std::mutex> lock(sStateMutex);
+    sLoaded  = true;
+    sVersion = MOCK_RPX_LOADER_API_VERSION;
+    sMissingExports.clear();
+    sRunningExecutablePath      = "wiiu/apps/mock/mock.wuhb";
+    sRunningExecutableAvailable = true;
+    sSaveRedirectionPath        = "wiiu/apps/save/00050000/mock";
+    sSaveRedirectionAvailable   = true;
+    sPreparedPath.clear();
+    sContentRedirectionEnabled = false;
+    sPrefetch                  = {};
+    memset(sLaunchTimeline, 0, sizeof(sLaunchTimeline));
+    sAccessLog = nullptr;
+
+    sCalls.getVersion                  = 0;
+    sCalls.prepareLaunchFromSD         = 0;
+    sCalls.launchPreparedHomebrew      = 0;
+    sCalls.launchHomebrew              = 0;
+    sCalls.enableContentRedirection    = 0;
+    sCalls.disableContentRedirection   = 0;
+    sCalls.unmountCurrentRunningBundle = 0;
+    sCalls.getPathOfRunningExecutable  = 0;
+    sCalls.getPathOfSaveRedirection    = 0;
+    sCalls.executeBatch                = 0;
+    sCalls.prefetchBundle              = 0;
+    sCalls.getLaunchTimeline           = 0;
+    sCalls.setAccessLog                = 0;
+    sCallDelayNs                       = 0;
+
+    UpdateRegistration();
+}
+
+void MockRPXLoader_SetLoaded(bool loaded) {
+    std::lock_guard<std::mutex> lock(sStateMutex);
+    sLoaded = loaded;
+    UpdateRegistration();
+}
+
+void MockRPXLoader_SetAPIVersion(RPXLoaderVersion version) {
+    sVersion = version;
+}
+
+void MockRPXLoader_SetCallDelay(uint32_t nanoseconds) {
+    sCallDelayNs = nanoseconds;
+}
+
+void MockRPXLoader_SetExportMissing(const char *exportName, bool missing) {
+    std::lock_guard<std::mutex> lock(sStateMutex);
+    if (missing) {
+        sMissingExports.insert(exportName);
+    } else {
+        sMissingExports.erase(exportName);
+    }
+    UpdateRegistration();
+}
+
+void MockRPXLoader_SetRunningExecutablePath(const char *path) {
+    std::lock_guard<std::mutex> lock(sStateMutex);
+    sRunningExecutableAvailable = path != nullptr;
+    sRunningExecutablePath      = path ? path : "";
+}
+
+void MockRPXLoader_SetSaveRedirectionPath(const char *path) {
+    std::lock_guard<std::mutex> lock(sStateMutex);
+    sSaveRedirectionAvailable = path != nullptr;
+    sSaveRedirectionPath      = path ? path : "";
+}
+
+std::string MockRPXLoader_GetPreparedPath() {
+    std::lock_guard<std::mutex> lock(sStateMutex);
+    return sPreparedPath;
+}
+
+bool MockRPXLoader_IsContentRedirectionEnabled() {
+    return sContentRedirectionEnabled;
+}
+
+MockRPXLoaderCalls MockRPXLoader_GetCalls() {
+    return {sCalls.getVersion.load(),
+            sCalls.prepareLaunchFromSD.load(),
+            sCalls.launchPreparedHomebrew.load(),
+            sCalls.launchHomebrew.load(),
+            sCalls.enableContentRedirection.load(),
+            sCalls.disableContentRedirection.load(),
+            sCalls.unmountCurrentRunningBundle.load(),
+            sCalls.getPathOfRunningExecutable.load(),
+            sCalls.getPathOfSaveRedirection.load(),
+            sCalls.executeBatch.load(),
+            sCalls.prefetchBundle.load(),
+            sCalls.getLaunchTimeline.load(),
+            sCalls.setAccessLog.load()};
+}
+
+MockRPXLoaderPrefetch MockRPXLoader_GetPrefetch() {
+    std::lock_guard<std::mutex> lock(sStateMutex);
+    return sPrefetch;
+}
+
+bool MockRPXLoader_IsPrefetched(uint64_t offset, uint64_t size) {
+    std::lock_guard<std::mutex> lock(sStateMutex);
+    for (auto &range : sPrefetch.ranges) {
+        if (offset >= range.offset && offset + size <= range.offset + range.size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MockRPXLoader_SetLaunchTimeline(const RPXLoaderTraceSpan *spans) {
+    std::lock_guard<std::mutex> lock(sStateMutex);
+    if (spans != nullptr) {
+        memcpy(sLaunchTimeline, spans, sizeof(sLaunchTimeline));
+    } else {
+        memset(sLaunchTimeline, 0, sizeof(sLaunchTimeline));
+    }
+}
+
+void MockRPXLoader_SimulateContentAccess(RPXLoaderAccessType type, const char *path, uint32_t offset, uint32_t length) {
+    auto log = sAccessLog.load();
+    if (log == nullptr || !sContentRedirectionEnabled) {
+        return;
+    }
+    while (*path == '/') {
+        path++;
+    }
+    // Same FNV-1a as RPXLoader_BundleHashPath, the module has its own copy.
+    uint32_t hash = 0x811C9DC5;
+    for (; *path != '\0'; path++) {
+        hash ^= (uint8_t) *path;
+        hash *= 0x01000193;
+    }
+    auto index = __atomic_fetch_add(&log->written, 1, __ATOMIC_RELAXED);
+    if (index < log->capacity) {
+        log->records[index] = {(uint64_t) OSGetTime(), hash, offset, length, (uint32_t) type};
+    }
+}
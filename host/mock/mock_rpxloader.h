@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <rpxloader/prefetch.h>
+#include <rpxloader/profile.h>
+#include <rpxloader/rpxloader.h>
+#include <rpxloader/trace.h>
+#include <string>
+#include <vector>
+
+// API version reported after MockRPXLoader_Reset, matches the newest exports this lib knows about.
+#define MOCK_RPX_LOADER_API_VERSION 7
+
+/**
+ * Fake "homebrew_rpx_loader" module for the host build.
+ * Mirrors the exports of the RPXLoadingModule; the reported API version and the set of
+ * available exports can be changed at any time to emulate older or broken module versions.
+ */
+
+struct MockRPXLoaderCalls {
+    uint64_t getVersion;
+    uint64_t prepareLaunchFromSD;
+    uint64_t launchPreparedHomebrew;
+    uint64_t launchHomebrew;
+    uint64_t enableContentRedirection;
+    uint64_t disableContentRedirection;
+    uint64_t unmountCurrentRunningBundle;
+    uint64_t getPathOfRunningExecutable;
+    uint64_t getPathOfSaveRedirection;
+    uint64_t executeBatch;
+    uint64_t prefetchBundle;
+    uint64_t getLaunchTimeline;
+    uint64_t setAccessLog;
+};
+
+/**
+ * Data of the last successful RL_PrefetchBundle call, replaces the cache the module keeps for the next launch.
+ */
+struct MockRPXLoaderPrefetch {
+    std::string bundlePath;
+    std::vector<RPXLoaderPrefetchRange> ranges;
+    uint64_t bytesRead = 0;
+};
+
+/**
+ * Registers the module with the default configuration: loaded, latest API version, all exports present.
+ */
+void MockRPXLoader_Reset();
+
+/**
+ * Loads/unloads the module. An unloaded module makes OSDynLoad_Acquire fail.
+ */
+void MockRPXLoader_SetLoaded(bool loaded);
+
+void MockRPXLoader_SetAPIVersion(RPXLoaderVersion version);
+
+/**
+ * Adds an artificial busy-wait to every call into the module, to model the cost of a cross-module call on the console.
+ * A batch only pays it once. 0 (default) disables the delay.
+ */
+void MockRPXLoader_SetCallDelay(uint32_t nanoseconds);
+
+/**
+ * Hides (or restores) a single export, e.g. "RL_GetPathOfSaveRedirection".
+ */
+void MockRPXLoader_SetExportMissing(const char *exportName, bool missing);
+
+/**
+ * Sets the paths returned by RL_GetPathOfRunningExecutable/RL_GetPathOfSaveRedirection.
+ * nullptr makes the functions return RPX_LOADER_RESULT_NOT_AVAILABLE.
+ */
+void MockRPXLoader_SetRunningExecutablePath(const char *path);
+
+void MockRPXLoader_SetSaveRedirectionPath(const char *path);
+
+/**
+ * Returns the path passed to the last successful RL_PrepareLaunchFromSD/RL_LaunchHomebrew call.
+ */
+std::string MockRPXLoader_GetPreparedPath();
+
+bool MockRPXLoader_IsContentRedirectionEnabled();
+
+MockRPXLoaderCalls MockRPXLoader_GetCalls();
+
+MockRPXLoaderPrefetch MockRPXLoader_GetPrefetch();
+
+/**
+ * Returns true if a read of this range of the prefetched bundle would be served from memory.
+ */
+bool MockRPXLoader_IsPrefetched(uint64_t offset, uint64_t size);
+
+/**
+ * Sets the phases RL_GetLaunchTimeline reports, RPX_LOADER_TRACE_PHASE_COUNT entries. NULL clears them.
+ */
+void MockRPXLoader_SetLaunchTimeline(const RPXLoaderTraceSpan *spans);
+
+/**
+ * Stands in for a /vol/content open or read of the running app that the module redirects into the bundle.
+ * Recorded if content redirection is enabled and an access log has been set, like the module's FS hooks would.
+ *
+ * @param path path relative to the root of the bundle, e.g. "content/data.bin"
+ */
+void MockRPXLoader_SimulateContentAccess(RPXLoaderAccessType type, const char *path, uint32_t offset, uint32_t length);
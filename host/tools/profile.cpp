@@ -0,0 +1,247 @@
+#include "profile_format.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <rpxloader/profile.h>
+#include <string>
+#include <vector>
+
+// Analyses an access profile (see include/rpxloader/profile.h): how sequential the reads are, which files are read the
+// most, and a RomFS file order that places the files in the order they are needed, so startup reads less scattered.
+
+#define PROFILE_DATA_ALIGNMENT 0x40 // Alignment of the file data in a RomFS created by wuhbtool
+
+namespace {
+    struct FileStats {
+        uint32_t hash;
+        std::string path;
+        bool known       = false;
+        uint64_t offset  = 0;
+        uint64_t size    = 0;
+        uint32_t opens   = 0;
+        uint32_t reads   = 0;
+        uint64_t bytes   = 0;
+        uint64_t first   = UINT64_MAX;
+        uint64_t readEnd = 0;
+    };
+
+    struct Profile {
+        ProfileHeader header;
+        std::vector<RPXLoaderAccessRecord> records;
+        std::map<uint32_t, FileStats> files;
+    };
+
+    bool ReadProfile(const char *path, Profile &outProfile) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            fprintf(stderr, "Failed to open %s\n", path);
+            return false;
+        }
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        auto &header = outProfile.header;
+        if (data.size() < PROFILE_HEADER_SIZE || !ProfileFile_LoadHeader(data.data(), &header) ||
+            data.size() < PROFILE_HEADER_SIZE + (uint64_t) header.recordCount * header.recordSize) {
+            fprintf(stderr, "%s is not an access profile\n", path);
+            return false;
+        }
+        size_t offset = PROFILE_HEADER_SIZE;
+        for (uint32_t i = 0; i < header.recordCount; i++, offset += header.recordSize) {
+            RPXLoaderAccessRecord record;
+            ProfileFile_LoadRecord(&data[offset], &record);
+            outProfile.records.push_back(record);
+            outProfile.files[record.pathHash].hash = record.pathHash;
+        }
+        // Records of concurrent accesses may be stored out of order, everything below expects them in the order they happened.
+        std::stable_sort(outProfile.records.begin(), outProfile.records.end(), [](const RPXLoaderAccessRecord &a, const RPXLoaderAccessRecord &b) {
+            return a.time < b.time;
+        });
+        for (uint32_t i = 0; i < header.fileCount; i++) {
+            ProfileFileEntry entry;
+            if (offset + PROFILE_FILE_ENTRY_SIZE > data.size()) {
+                fprintf(stderr, "%s: the file table is truncated\n", path);
+                return false;
+            }
+            ProfileFile_LoadFileEntry(&data[offset], &entry);
+            if (offset + ProfileFile_GetEntrySize(entry.pathLength) > data.size()) {
+                fprintf(stderr, "%s: the file table is truncated\n", path);
+                return false;
+            }
+            auto &file  = outProfile.files[entry.pathHash];
+            file.hash   = entry.pathHash;
+            file.path   = std::string((const char *) &data[offset + PROFILE_FILE_ENTRY_SIZE], entry.pathLength);
+            file.known  = true;
+            file.offset = entry.offset;
+            file.size   = entry.size;
+            offset += ProfileFile_GetEntrySize(entry.pathLength);
+        }
+        for (auto &[hash, file] : outProfile.files) {
+            if (!file.known) {
+                char name[16];
+                snprintf(name, sizeof(name), "<%08" PRIx32 ">", hash);
+                file.path = name;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Number of reads that don't start where the previous read ended, with the files at the given offsets.
+     * Reads of files without an offset are skipped.
+     */
+    uint32_t CountSeeks(const Profile &profile, const std::map<uint32_t, uint64_t> &layout) {
+        uint32_t seeks    = 0;
+        uint64_t position = UINT64_MAX;
+        for (auto &record : profile.records) {
+            auto file = layout.find(record.pathHash);
+            if (record.type != RPX_LOADER_ACCESS_READ || file == layout.end()) {
+                continue;
+            }
+            auto start = file->second + record.offset;
+            if (start != position) {
+                seeks++;
+            }
+            position = start + record.length;
+        }
+        return seeks;
+    }
+
+    double ToMilliseconds(const Profile &profile, uint64_t ticks) {
+        return (double) ticks * 1000.0 / profile.header.ticksPerSecond;
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    const char *inPath    = nullptr;
+    const char *orderPath = nullptr;
+    uint32_t top          = 20;
+    bool usage            = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            orderPath = argv[++i];
+        } else if (arg == "-n" && i + 1 < argc) {
+            top = (uint32_t) strtoul(argv[++i], nullptr, 10);
+        } else if (arg[0] == '-' || inPath != nullptr) {
+            usage = true;
+        } else {
+            inPath = argv[i];
+        }
+    }
+    if (usage || inPath == nullptr) {
+        fprintf(stderr, "Usage: %s [-n top_files] [-o order.txt] profile.bin\n", argv[0]);
+        return 2;
+    }
+
+    Profile profile;
+    if (!ReadProfile(inPath, profile)) {
+        return 1;
+    }
+
+    // Per file statistics, and reads that continue exactly where the previous read of the same file ended.
+    uint32_t opens = 0, reads = 0, sequentialInFile = 0;
+    uint64_t bytes = 0;
+    for (auto &record : profile.records) {
+        auto &file = profile.files[record.pathHash];
+        file.first = std::min(file.first, record.time);
+        if (record.type == RPX_LOADER_ACCESS_OPEN) {
+            opens++;
+            file.opens++;
+            continue;
+        }
+        if (record.type != RPX_LOADER_ACCESS_READ) {
+            continue;
+        }
+        reads++;
+        bytes += record.length;
+        if (record.offset == file.readEnd) {
+            sequentialInFile++;
+        }
+        file.reads++;
+        file.bytes += record.length;
+        file.readEnd = (uint64_t) record.offset + record.length;
+    }
+
+    std::map<uint32_t, uint64_t> currentLayout;
+    uint32_t knownReads = 0;
+    for (auto &[hash, file] : profile.files) {
+        if (file.known) {
+            currentLayout[hash] = file.offset;
+            knownReads += file.reads;
+        }
+    }
+
+    auto first    = profile.records.empty() ? 0 : profile.records.front().time;
+    auto duration = profile.records.empty() ? 0 : profile.records.back().time - first;
+    printf("Records:    %" PRIu32 " (%" PRIu32 " opens, %" PRIu32 " reads), %" PRIu32 " dropped, %.1f ms\n",
+           profile.header.recordCount, opens, reads, profile.header.dropped, ToMilliseconds(profile, duration));
+    printf("Read:       %" PRIu64 " bytes in %zu files\n", bytes, profile.files.size());
+    if (reads > 0) {
+        printf("Sequential: %.1f%% of the reads continue the previous read of the same file\n", 100.0 * sequentialInFile / reads);
+    }
+    if (knownReads > 0) {
+        auto seeks = CountSeeks(profile, currentLayout);
+        printf("            %.1f%% of the reads continue the previous read on the sd card (%" PRIu32 " seeks)\n", 100.0 * (knownReads - seeks) / knownReads, seeks);
+    } else {
+        printf("            The profile has no file table, the reads can't be mapped to the bundle.\n");
+    }
+
+    std::vector<const FileStats *> ranking;
+    for (auto &[hash, file] : profile.files) {
+        ranking.push_back(&file);
+    }
+    std::sort(ranking.begin(), ranking.end(), [](const FileStats *a, const FileStats *b) {
+        return a->bytes != b->bytes ? a->bytes > b->bytes : a->reads > b->reads;
+    });
+    printf("\nHot files (by bytes read):\n");
+    printf("%4s %12s %8s %6s %10s  %s\n", "#", "bytes", "reads", "opens", "first ms", "path");
+    for (uint32_t i = 0; i < ranking.size() && i < top; i++) {
+        auto file = ranking[i];
+        printf("%4" PRIu32 " %12" PRIu64 " %8" PRIu32 " %6" PRIu32 " %10.1f  %s\n", i + 1, file->bytes, file->reads, file->opens, ToMilliseconds(profile, file->first - first), file->path.c_str());
+    }
+
+    // Files in the order they are first accessed, so a startup that opens and reads them one after another becomes
+    // one sequential pass. The file table only contains accessed files, the rest of the bundle should follow them in
+    // its current order. Ties keep the current order.
+    std::vector<const FileStats *> order;
+    for (auto &[hash, file] : profile.files) {
+        if (file.known) {
+            order.push_back(&file);
+        }
+    }
+    std::sort(order.begin(), order.end(), [](const FileStats *a, const FileStats *b) {
+        return a->first != b->first ? a->first < b->first : a->offset < b->offset;
+    });
+    std::map<uint32_t, uint64_t> proposedLayout;
+    uint64_t offset = 0;
+    for (auto file : order) {
+        proposedLayout[file->hash] = offset;
+        offset                     = (offset + file->size + PROFILE_DATA_ALIGNMENT - 1) & ~(uint64_t) (PROFILE_DATA_ALIGNMENT - 1);
+    }
+
+    printf("\nProposed RomFS file order (by first access):\n");
+    for (uint32_t i = 0; i < order.size(); i++) {
+        printf("%4" PRIu32 "  %s\n", i + 1, order[i]->path.c_str());
+    }
+    if (knownReads > 0) {
+        printf("Seeks: %" PRIu32 " with the current order, %" PRIu32 " with the proposed order\n", CountSeeks(profile, currentLayout), CountSeeks(profile, proposedLayout));
+    }
+
+    if (orderPath != nullptr) {
+        auto out = fopen(orderPath, "w");
+        if (out == nullptr) {
+            fprintf(stderr, "Failed to create %s\n", orderPath);
+            return 1;
+        }
+        for (auto file : order) {
+            fprintf(out, "%s\n", file->path.c_str());
+        }
+        if (fclose(out) != 0) {
+            fprintf(stderr, "Failed to write %s\n", orderPath);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include "trace_format.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <rpxloader/trace.h>
+#include <string>
+#include <vector>
+
+// Converts launch trace files (see include/rpxloader/trace.h) into the Chrome trace event format, which can be opened
+// via chrome://tracing or https://ui.perfetto.dev. Every file becomes a process, every launch a thread. The timestamps
+// of a launch are relative to its first phase, so launches of different files and module versions line up.
+
+namespace {
+    struct TraceFile {
+        std::string name;
+        TraceHeader header;
+        std::vector<TraceRecord> records;
+    };
+
+    struct Launch {
+        uint32_t id;
+        std::vector<const TraceRecord *> records;
+    };
+
+    const char *sPhaseNames[] = {
+            "prepare",
+            "validation",
+            "launch requested",
+            "wrapper started",
+            "bundle mounted",
+            "first redirected read",
+    };
+    static_assert(sizeof(sPhaseNames) / sizeof(sPhaseNames[0]) == RPX_LOADER_TRACE_PHASE_COUNT, "sPhaseNames and RPXLoaderTracePhase are out of sync");
+
+    std::string EscapeJSON(const std::string &value) {
+        std::string result;
+        for (auto c : value) {
+            if (c == '"' || c == '\\') {
+                result += '\\';
+                result += c;
+            } else if ((unsigned char) c < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                result += escaped;
+            } else {
+                result += c;
+            }
+        }
+        return result;
+    }
+
+    std::string GetPhaseName(uint32_t phase) {
+        return phase < RPX_LOADER_TRACE_PHASE_COUNT ? sPhaseNames[phase] : "phase " + std::to_string(phase);
+    }
+
+    bool ReadTraceFile(const char *path, TraceFile &outFile) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            fprintf(stderr, "Failed to open %s\n", path);
+            return false;
+        }
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (data.size() < TRACE_HEADER_SIZE || !TraceFile_LoadHeader(data.data(), &outFile.header)) {
+            fprintf(stderr, "%s is not a launch trace\n", path);
+            return false;
+        }
+        // A partially written record at the end is ignored.
+        for (size_t offset = TRACE_HEADER_SIZE; offset + outFile.header.recordSize <= data.size(); offset += outFile.header.recordSize) {
+            TraceRecord record;
+            TraceFile_LoadRecord(&data[offset], &record);
+            outFile.records.push_back(record);
+        }
+        std::string name = path;
+        auto slash       = name.find_last_of('/');
+        outFile.name     = slash != std::string::npos ? name.substr(slash + 1) : name;
+        return true;
+    }
+
+    std::vector<Launch> GroupLaunches(const TraceFile &file) {
+        std::vector<Launch> launches;
+        for (auto &record : file.records) {
+            Launch *launch = nullptr;
+            for (auto &existing : launches) {
+                if (existing.id == record.launchId) {
+                    launch = &existing;
+                    break;
+                }
+            }
+            if (launch == nullptr) {
+                launch = &launches.emplace_back(Launch{record.launchId, {}});
+            }
+            launch->records.push_back(&record);
+        }
+        return launches;
+    }
+
+    class EventWriter {
+    public:
+        explicit EventWriter(FILE *out) : mOut(out) {
+            fprintf(mOut, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+        }
+
+        ~EventWriter() {
+            fprintf(mOut, "\n]}\n");
+        }
+
+        void Metadata(const char *name, uint32_t pid, uint32_t tid, const std::string &value) {
+            Begin();
+            fprintf(mOut, "{\"name\":\"%s\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", name, pid, tid, EscapeJSON(value).c_str());
+        }
+
+        void Phase(const TraceRecord &record, uint32_t pid, uint32_t tid, uint64_t base, uint32_t ticksPerSecond) {
+            auto toMicroseconds = [ticksPerSecond](uint64_t ticks) { return (double) ticks * 1000000.0 / ticksPerSecond; };
+            Begin();
+            fprintf(mOut, "{\"name\":\"%s\",\"cat\":\"launch\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,", GetPhaseName(record.phase).c_str(), pid, tid, toMicroseconds(record.begin - base));
+            if (record.end > record.begin) {
+                fprintf(mOut, "\"ph\":\"X\",\"dur\":%.3f,", toMicroseconds(record.end - record.begin));
+            } else {
+                fprintf(mOut, "\"ph\":\"i\",\"s\":\"t\",");
+            }
+            fprintf(mOut, "\"args\":{\"status\":%" PRId32 ",\"module_version\":%" PRIu32 ",\"source\":\"%s\"}}",
+                    record.status, record.moduleVersion, record.source == TRACE_SOURCE_MODULE ? "module" : "lib");
+        }
+
+    private:
+        void Begin() {
+            fprintf(mOut, mFirst ? "\n" : ",\n");
+            mFirst = false;
+        }
+
+        FILE *mOut;
+        bool mFirst = true;
+    };
+
+    void WriteFile(EventWriter &writer, const TraceFile &file, uint32_t pid) {
+        writer.Metadata("process_name", pid, 0, file.name);
+        uint32_t tid = 1;
+        for (auto &launch : GroupLaunches(file)) {
+            uint64_t base          = UINT64_MAX;
+            uint32_t moduleVersion = 0;
+            std::string name;
+            for (auto record : launch.records) {
+                base          = std::min<uint64_t>(base, record->begin);
+                moduleVersion = std::max(moduleVersion, record->moduleVersion);
+                if (name.empty()) {
+                    name = record->name;
+                }
+            }
+            char threadName[128];
+            snprintf(threadName, sizeof(threadName), "#%u %s (module v%u, id %08x)", tid, name.c_str(), moduleVersion, launch.id);
+            writer.Metadata("thread_name", pid, tid, threadName);
+            for (auto record : launch.records) {
+                writer.Phase(*record, pid, tid, base, file.header.ticksPerSecond);
+            }
+            tid++;
+        }
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    const char *outPath = nullptr;
+    std::vector<const char *> inPaths;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            inPaths.clear();
+            break;
+        } else {
+            inPaths.push_back(argv[i]);
+        }
+    }
+    if (inPaths.empty()) {
+        fprintf(stderr, "Usage: %s [-o output.json] trace.bin [trace.bin ...]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<TraceFile> files(inPaths.size());
+    for (size_t i = 0; i < inPaths.size(); i++) {
+        if (!ReadTraceFile(inPaths[i], files[i])) {
+            return 1;
+        }
+    }
+
+    auto out = outPath != nullptr ? fopen(outPath, "w") : stdout;
+    if (out == nullptr) {
+        fprintf(stderr, "Failed to create %s\n", outPath);
+        return 1;
+    }
+    {
+        EventWriter writer(out);
+        for (size_t i = 0; i < files.size(); i++) {
+            WriteFile(writer, files[i], i + 1);
+        }
+    }
+    if (out != stdout && fclose(out) != 0) {
+        fprintf(stderr, "Failed to write %s\n", outPath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "preflight.h"
+#include "rpxloader.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct RPXLoaderAsyncLaunch RPXLoaderAsyncLaunch;
+
+typedef enum RPXLoaderAsyncState {
+    /** Waiting for the worker thread. */
+    RPX_LOADER_ASYNC_STATE_QUEUED = 0,
+    /** The path is checked via RPXLoader_PreflightCheck. */
+    RPX_LOADER_ASYNC_STATE_VALIDATING = 1,
+    /** Point of no return: the module is called, the request can't be cancelled anymore. */
+    RPX_LOADER_ASYNC_STATE_LAUNCHING = 2,
+    RPX_LOADER_ASYNC_STATE_COMPLETED = 3,
+    RPX_LOADER_ASYNC_STATE_CANCELLED = 4,
+} RPXLoaderAsyncState;
+
+/**
+ * Called on the worker thread when a request has finished or the worker got to a cancelled request.
+ * RPXLoader_AsyncWait and RPXLoader_AsyncGetResult only report the result after the callback has returned. <br>
+ * Must not call RPXLoader_AsyncWait or RPXLoader_DeInitLibrary. Releasing the handle via RPXLoader_AsyncFree is allowed.
+ */
+typedef void (*RPXLoaderAsyncCallback)(RPXLoaderAsyncLaunch *handle, RPXLoaderStatus result, void *context);
+
+typedef struct RPXLoaderAsyncOptions {
+    /** Validation that is done before the module is called. */
+    RPXLoaderPreflightMode preflightMode;
+    /** Set to 1 to skip the validation. */
+    uint32_t skipPreflight;
+    /** (optional) */
+    RPXLoaderAsyncCallback callback;
+    void *context;
+} RPXLoaderAsyncOptions;
+
+/**
+ * Like RPXLoader_PrepareLaunchFromSD, but returns immediately. Checking and validating the file as well as the call into
+ * the module happen on a worker thread. Requests are executed one after another in the order they have been made. <br>
+ * The result can be polled via RPXLoader_AsyncGetState/RPXLoader_AsyncGetResult or is passed to the callback. <br>
+ * <br>
+ * The result of the request is: <br>
+ *  - RPX_LOADER_RESULT_NOT_FOUND if the file doesn't exist<br>
+ *  - RPX_LOADER_RESULT_INVALID_ARGUMENT if the validation failed, see RPXLoader_AsyncGetResult for details<br>
+ *  - RPX_LOADER_RESULT_CANCELLED if the request has been cancelled<br>
+ *  - otherwise the result of RPXLoader_PrepareLaunchFromSD<br>
+ * <br>
+ * Requires API version 1 or higher. <br>
+ *
+ * @param path path to the .rpx/.wuhb that should be loaded, relative to the root of the sd card.
+ * @param options (optional) NULL to validate the headers of the file and to not use a callback.
+ * @param outHandle receives the handle of the request, has to be released via RPXLoader_AsyncFree.
+ * @return RPX_LOADER_RESULT_SUCCESS:             The request has been queued.<br>
+ *         RPX_LOADER_RESULT_LIB_UNINITIALIZED:   Library was not initialized. Call RPXLoader_InitLibrary() before using this function.<br>
+ *         RPX_LOADER_RESULT_UNSUPPORTED_COMMAND: Command not supported by the currently loaded RPXLoaderModule version.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT:    path or outHandle was NULL.<br>
+ *         RPX_LOADER_RESULT_UNKNOWN_ERROR:       Failed to allocate memory or to start the worker thread.
+ */
+RPXLoaderStatus RPXLoader_PrepareLaunchFromSDAsync(const char *path, const RPXLoaderAsyncOptions *options, RPXLoaderAsyncLaunch **outHandle);
+
+/**
+ * Like RPXLoader_LaunchHomebrew, but returns immediately. See RPXLoader_PrepareLaunchFromSDAsync. <br>
+ * The application keeps running (and rendering) until the module actually launches the wrapper app.
+ */
+RPXLoaderStatus RPXLoader_LaunchHomebrewAsync(const char *bundle_path, const RPXLoaderAsyncOptions *options, RPXLoaderAsyncLaunch **outHandle);
+
+/**
+ * Cancels a request, if it didn't reach the point of no return yet (see RPX_LOADER_ASYNC_STATE_LAUNCHING).
+ *
+ * @return RPX_LOADER_RESULT_SUCCESS:          The request has been cancelled, the module won't be called.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT: handle was NULL.<br>
+ *         RPX_LOADER_RESULT_NOT_AVAILABLE:    The request is already launching, has finished or was already cancelled.
+ */
+RPXLoaderStatus RPXLoader_AsyncCancel(RPXLoaderAsyncLaunch *handle);
+
+RPXLoaderAsyncState RPXLoader_AsyncGetState(const RPXLoaderAsyncLaunch *handle);
+
+/**
+ * @param outResult receives the result of the request
+ * @param outPreflight (optional) receives the result of the validation
+ * @return RPX_LOADER_RESULT_SUCCESS:          The request has finished, outResult has been set.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT: handle or outResult was NULL.<br>
+ *         RPX_LOADER_RESULT_NOT_AVAILABLE:    The request is still pending. A cancelled request is pending until
+ *                                             the worker thread got to it.
+ */
+RPXLoaderStatus RPXLoader_AsyncGetResult(const RPXLoaderAsyncLaunch *handle, RPXLoaderStatus *outResult, RPXLoaderPreflightResult *outPreflight);
+
+/**
+ * Blocks until the request has finished and returns its result.
+ */
+RPXLoaderStatus RPXLoader_AsyncWait(RPXLoaderAsyncLaunch *handle);
+
+/**
+ * Releases the handle. The request itself is not cancelled.
+ */
+void RPXLoader_AsyncFree(RPXLoaderAsyncLaunch *handle);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
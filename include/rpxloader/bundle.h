@@ -0,0 +1,103 @@
+#pragma once
+
+#include "rpxloader.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Buffers with this alignment (and sizes that are a multiple of it) are filled by the FS directly, without bounce buffer. */
+#define RPX_LOADER_BUNDLE_READ_ALIGNMENT 0x40
+
+typedef struct RPXLoaderBundle RPXLoaderBundle;
+
+typedef struct RPXLoaderBundleFileInfo {
+    /** Path relative to the root of the bundle, e.g. "content/data.bin". Valid until the bundle is closed. */
+    const char *path;
+    uint32_t index;
+    /** File offset of the data inside the .wuhb. */
+    uint64_t offset;
+    uint64_t size;
+} RPXLoaderBundleFileInfo;
+
+/**
+ * Opens a .wuhb and builds an index of all files it contains, so lookups via RPXLoader_BundleFindFile don't have to
+ * walk the directory and file tables of the RomFS. <br>
+ * <br>
+ * Works without RPXLoader_InitLibrary and without the RPXLoadingModule. <br>
+ *
+ * @param path path to the .wuhb, relative to the root of the sd card.
+ * @param outBundle receives the bundle, has to be closed via RPXLoader_BundleClose
+ * @return RPX_LOADER_RESULT_SUCCESS:          The bundle has been opened.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT: path or outBundle was NULL or the file is not a valid .wuhb.<br>
+ *         RPX_LOADER_RESULT_NOT_FOUND:        The file could not be opened.<br>
+ *         RPX_LOADER_RESULT_UNKNOWN_ERROR:    Failed to allocate memory.
+ */
+RPXLoaderStatus RPXLoader_BundleOpen(const char *path, RPXLoaderBundle **outBundle);
+
+/**
+ * Like RPXLoader_BundleOpen, but opens the bundle that is currently running (see RPXLoader_GetPathOfRunningExecutable). <br>
+ *
+ * @param outBundle receives the bundle, has to be closed via RPXLoader_BundleClose
+ * @return RPX_LOADER_RESULT_SUCCESS:           The bundle has been opened.<br>
+ *         RPX_LOADER_RESULT_LIB_UNINITIALIZED: Library was not initialized. Call RPXLoader_InitLibrary() before using this function.<br>
+ *         RPX_LOADER_RESULT_NOT_AVAILABLE:     No .wuhb is running.<br>
+ *         See RPXLoader_BundleOpen and RPXLoader_GetPathOfRunningExecutable for other return values.
+ */
+RPXLoaderStatus RPXLoader_BundleOpenMounted(RPXLoaderBundle **outBundle);
+
+void RPXLoader_BundleClose(RPXLoaderBundle *bundle);
+
+uint32_t RPXLoader_BundleGetFileCount(const RPXLoaderBundle *bundle);
+
+/**
+ * Looks up a file by its path. Takes constant time, independent of the number of files in the bundle.
+ *
+ * @param path path relative to the root of the bundle, e.g. "content/data.bin". A leading '/' is ignored.
+ * @return RPX_LOADER_RESULT_SUCCESS:          outInfo has been filled.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT: An argument was NULL.<br>
+ *         RPX_LOADER_RESULT_NOT_FOUND:        The bundle has no file with this path.
+ */
+RPXLoaderStatus RPXLoader_BundleFindFile(const RPXLoaderBundle *bundle, const char *path, RPXLoaderBundleFileInfo *outInfo);
+
+/**
+ * Looks up a file by the hash of its path, see RPXLoader_BundleHashPath. Useful for recorded access profiles that
+ * only store the hash. If several paths share the hash, one of them is returned.
+ *
+ * @return RPX_LOADER_RESULT_SUCCESS:          outInfo has been filled.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT: An argument was NULL.<br>
+ *         RPX_LOADER_RESULT_NOT_FOUND:        The bundle has no file with this hash.
+ */
+RPXLoaderStatus RPXLoader_BundleFindFileByHash(const RPXLoaderBundle *bundle, uint32_t pathHash, RPXLoaderBundleFileInfo *outInfo);
+
+/**
+ * Hash (32 bit FNV-1a) of a path relative to the root of the bundle, e.g. "content/data.bin". A leading '/' is ignored.
+ */
+uint32_t RPXLoader_BundleHashPath(const char *path);
+
+/**
+ * Returns the file with the given index, files are numbered from 0 to RPXLoader_BundleGetFileCount() - 1.
+ *
+ * @return RPX_LOADER_RESULT_SUCCESS:          outInfo has been filled.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT: An argument was NULL or the index is out of range.
+ */
+RPXLoaderStatus RPXLoader_BundleGetFileInfo(const RPXLoaderBundle *bundle, uint32_t index, RPXLoaderBundleFileInfo *outInfo);
+
+/**
+ * Reads (a part of) a file directly into the given buffer. Reads beyond the end of the file are shortened. <br>
+ * For best performance, the buffer should be aligned to RPX_LOADER_BUNDLE_READ_ALIGNMENT. <br>
+ * Reads of the same bundle from multiple threads are serialized.
+ *
+ * @param index index of the file, see RPXLoaderBundleFileInfo
+ * @param offset offset inside the file
+ * @param outRead (optional) receives the number of bytes that have been read
+ * @return RPX_LOADER_RESULT_SUCCESS:          The data has been read.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT: bundle or buffer was NULL or the index is out of range.<br>
+ *         RPX_LOADER_RESULT_UNKNOWN_ERROR:    Failed to read from the sd card.
+ */
+RPXLoaderStatus RPXLoader_BundleReadFile(RPXLoaderBundle *bundle, uint32_t index, uint64_t offset, void *buffer, uint32_t size, uint32_t *outRead);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
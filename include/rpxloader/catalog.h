@@ -0,0 +1,84 @@
+#pragma once
+
+#include "rpxloader.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum RPXLoaderCatalogFileType {
+    RPX_LOADER_CATALOG_FILE_TYPE_RPX  = 0,
+    RPX_LOADER_CATALOG_FILE_TYPE_WUHB = 1,
+} RPXLoaderCatalogFileType;
+
+typedef struct RPXLoaderCatalogEntry {
+    /** Path relative to the root of the sd card, can be passed to RPXLoader_LaunchHomebrew as it is. */
+    const char *path;
+    /** .wuhb: name from meta/meta.ini, .rpx or if the bundle has no name: file name without extension. */
+    const char *name;
+    /** .wuhb: author from meta/meta.ini, empty string otherwise. */
+    const char *author;
+    RPXLoaderCatalogFileType type;
+    /** .wuhb: size of meta/iconTex.tga, 0 if the bundle has no icon. */
+    uint32_t iconSize;
+    /** .wuhb: file offset of meta/iconTex.tga inside the bundle. */
+    uint64_t iconOffset;
+    uint64_t fileSize;
+    /** Last modification time, as reported by stat(). */
+    int64_t modificationTime;
+} RPXLoaderCatalogEntry;
+
+typedef struct RPXLoaderCatalogStats {
+    /** Number of entries in the catalog. */
+    uint32_t entries;
+    /** Entries that have been taken from the cache file. */
+    uint32_t reused;
+    /** Entries that had to be read from the .rpx/.wuhb because they were new or changed. */
+    uint32_t parsed;
+    /** Entries of the cache file whose .rpx/.wuhb doesn't exist anymore. */
+    uint32_t removed;
+    /** 1 if a valid cache file has been loaded. */
+    uint32_t cacheLoaded;
+    /** 1 if the cache file has been (re)written. */
+    uint32_t cacheWritten;
+} RPXLoaderCatalogStats;
+
+typedef struct RPXLoaderCatalog RPXLoaderCatalog;
+
+#define RPX_LOADER_CATALOG_MAX_DEPTH 4
+
+/**
+ * Builds a list of all .rpx/.wuhb files inside a directory on the sd card and its subdirectories
+ * (up to RPX_LOADER_CATALOG_MAX_DEPTH levels). Entries are sorted by path. <br>
+ * <br>
+ * If a cachePath is given, the name, author and icon location of every file are stored there. On the next call
+ * only files whose size or modification time has changed are opened again. The cache file is only rewritten if
+ * something has changed. An invalid or outdated cache file is ignored.<br>
+ * <br>
+ * Works without RPXLoader_InitLibrary and without the RPXLoadingModule. <br>
+ *
+ * @param directory directory relative to the root of the sd card, e.g. "wiiu/apps". "" scans the whole sd card.
+ * @param cachePath (optional) path of the cache file relative to the root of the sd card
+ * @param outCatalog receives the catalog, has to be freed via RPXLoader_CatalogFree
+ * @param outStats (optional) receives statistics about the scan
+ * @return RPX_LOADER_RESULT_SUCCESS:          The catalog has been created.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT: directory or outCatalog was NULL.<br>
+ *         RPX_LOADER_RESULT_NOT_FOUND:        The directory could not be opened.<br>
+ *         RPX_LOADER_RESULT_UNKNOWN_ERROR:    Failed to allocate memory.
+ */
+RPXLoaderStatus RPXLoader_CatalogScan(const char *directory, const char *cachePath, RPXLoaderCatalog **outCatalog, RPXLoaderCatalogStats *outStats);
+
+uint32_t RPXLoader_CatalogGetCount(const RPXLoaderCatalog *catalog);
+
+/**
+ * Returns the entry at the given index, or NULL if the index is out of range.
+ * The entry and its strings stay valid until RPXLoader_CatalogFree is called.
+ */
+const RPXLoaderCatalogEntry *RPXLoader_CatalogGetEntry(const RPXLoaderCatalog *catalog, uint32_t index);
+
+void RPXLoader_CatalogFree(RPXLoaderCatalog *catalog);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "rpxloader.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Log messages of this lib are not printed right away. Each message is stored as a small binary record
+ * (message id, arguments and system tick) in a fixed ring buffer, the text is only formatted when
+ * RPXLoader_FlushLog or RPXLoader_DrainLog is called. <br>
+ * If the ring buffer is full, new messages are dropped and counted, see RPXLoader_GetDroppedLogCount.
+ */
+
+#define RPX_LOADER_LOG_BUFFER_RECORDS 64
+
+typedef enum RPXLoaderLogLevel {
+    RPX_LOADER_LOG_LEVEL_NONE  = 0,
+    RPX_LOADER_LOG_LEVEL_ERROR = 1,
+    RPX_LOADER_LOG_LEVEL_WARN  = 2,
+} RPXLoaderLogLevel;
+
+/**
+ * Receives a formatted message during RPXLoader_DrainLog.
+ *
+ * @param level level of the message
+ * @param tick value of OSGetSystemTick() when the message has been logged
+ * @param line the formatted message, including the trailing newline. Only valid during the call.
+ * @param context context that has been passed to RPXLoader_DrainLog
+ */
+typedef void (*RPXLoaderLogSink)(RPXLoaderLogLevel level, uint32_t tick, const char *line, void *context);
+
+/**
+ * Sets the most verbose level that is recorded, messages of other levels are discarded at the call site. <br>
+ * The default is RPX_LOADER_LOG_LEVEL_WARN. Can be called at any time, also before RPXLoader_InitLibrary.
+ */
+void RPXLoader_SetLogLevel(RPXLoaderLogLevel level);
+
+RPXLoaderLogLevel RPXLoader_GetLogLevel();
+
+/**
+ * Formats all buffered messages in the order they have been logged and passes them to the sink.
+ * Messages that are logged by other threads during the call may or may not be included.
+ *
+ * @param sink receives the messages, NULL writes them via OSReport
+ * @param context passed to the sink
+ * @return the number of messages that have been drained
+ */
+uint32_t RPXLoader_DrainLog(RPXLoaderLogSink sink, void *context);
+
+/**
+ * Writes all buffered messages via OSReport. Same as RPXLoader_DrainLog(NULL, NULL). <br>
+ * RPXLoader_DeInitLibrary flushes the log as well.
+ *
+ * @return the number of messages that have been written
+ */
+uint32_t RPXLoader_FlushLog();
+
+/**
+ * Returns the number of messages that have been dropped because the ring buffer was full.
+ */
+uint32_t RPXLoader_GetDroppedLogCount();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
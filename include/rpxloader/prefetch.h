@@ -0,0 +1,91 @@
+#pragma once
+
+#include "rpxloader.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Upper limit of the file data that is prefetched if RPXLoaderPrefetchOptions.maxBytes is 0. */
+#define RPX_LOADER_PREFETCH_DEFAULT_BUDGET (8 * 1024 * 1024)
+/** Ranges whose gap is at most this size are read with one sequential read, including the gap. */
+#define RPX_LOADER_PREFETCH_MERGE_GAP      0x10000
+/** Maximum number of reads that are passed to the module, files and hints that would need more are skipped. */
+#define RPX_LOADER_PREFETCH_MAX_RANGES     256
+
+/**
+ * Part of a file inside the bundle, e.g. from a recorded access profile.
+ */
+typedef struct RPXLoaderPrefetchHint {
+    /** Hash of the path relative to the root of the bundle, see RPXLoader_BundleHashPath. */
+    uint32_t pathHash;
+    /** Offset inside the file. */
+    uint32_t offset;
+    /** Length of the range, 0 for everything up to the end of the file. */
+    uint32_t length;
+} RPXLoaderPrefetchHint;
+
+typedef struct RPXLoaderPrefetchOptions {
+    /** (optional) Files that are prefetched completely, relative to the root of the bundle, e.g. "content/data.bin". */
+    const char *const *hotFiles;
+    uint32_t hotFileCount;
+    /** (optional) Ranges that are prefetched after the hot files. */
+    const RPXLoaderPrefetchHint *hints;
+    uint32_t hintCount;
+    /**
+     * Upper limit of the bytes read for the files and hints, including the gaps that are merged into their reads,
+     * 0 for RPX_LOADER_PREFETCH_DEFAULT_BUDGET. Files and hints that don't fit anymore are skipped.
+     */
+    uint32_t maxBytes;
+} RPXLoaderPrefetchOptions;
+
+/**
+ * Sequential read inside the .wuhb that is passed to the module.
+ */
+typedef struct RPXLoaderPrefetchRange {
+    uint64_t offset;
+    uint64_t size;
+} RPXLoaderPrefetchRange;
+
+typedef struct RPXLoaderPrefetchStats {
+    /** Number of sequential reads the module has been asked to do. */
+    uint32_t ranges;
+    /** Number of hot files and hints that are covered. */
+    uint32_t files;
+    /** Hot files and hints that don't exist in the bundle. */
+    uint32_t missing;
+    /** Hot files and hints that have been skipped because of maxBytes or RPX_LOADER_PREFETCH_MAX_RANGES. */
+    uint32_t skipped;
+    /** Total size of all reads, including the RomFS tables and merged gaps. */
+    uint64_t bytes;
+} RPXLoaderPrefetchStats;
+
+/**
+ * Asks the RPXLoadingModule to read the RomFS tables and the given files of a .wuhb ahead of time, so the first
+ * /vol/content accesses after the launch don't have to wait for the sd card. Call it next to
+ * RPXLoader_PrepareLaunchFromSD with the same path. <br>
+ * <br>
+ * The lib opens the bundle, resolves the hot files and hints to file ranges, sorts them by offset and merges close
+ * ranges (see RPX_LOADER_PREFETCH_MERGE_GAP) into a few large sequential reads. The module reads them in the
+ * background and serves the matching reads of the next launch of this bundle from memory. <br>
+ * <br>
+ * Purely an optimization: if the module doesn't support it, the bundle simply isn't prefetched. <br>
+ * <br>
+ * Requires API version 5 or higher. <br>
+ *
+ * @param bundlePath path to the .wuhb, relative to the root of the sd card
+ * @param options (optional) hot files and hints, without options only the RomFS tables are prefetched
+ * @param outStats (optional) receives what has been requested, only written on success
+ * @return RPX_LOADER_RESULT_SUCCESS:               The module will prefetch the data.<br>
+ *         RPX_LOADER_RESULT_LIB_UNINITIALIZED:     Library was not initialized. Call RPXLoader_InitLibrary() before using this function.<br>
+ *         RPX_LOADER_RESULT_UNSUPPORTED_COMMAND:   Command not supported by the currently loaded RPXLoaderModule version.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT:      bundlePath was NULL or the file is not a valid .wuhb.<br>
+ *         RPX_LOADER_RESULT_NOT_FOUND:             The bundle could not be opened.<br>
+ *         RPX_LOADER_RESULT_UNKNOWN_ERROR:         Out of memory or unexpected error.
+ */
+RPXLoaderStatus RPXLoader_PrefetchBundle(const char *bundlePath, const RPXLoaderPrefetchOptions *options, RPXLoaderPrefetchStats *outStats);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "rpxloader.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum RPXLoaderPreflightMode {
+    /** Only checks the headers and tables and that everything they reference lies within the file. */
+    RPX_LOADER_PREFLIGHT_MODE_HEADERS_ONLY = 0,
+    /** Additionally reads the whole file. .rpx: all sections are decompressed and checked against the RPL CRCs. */
+    RPX_LOADER_PREFLIGHT_MODE_FULL = 1,
+    /** Not a mode. Makes the enum 32 bit wide, so unknown (non-negative) values are well-defined and can be rejected. */
+    RPX_LOADER_PREFLIGHT_MODE_FORCE_32BIT = 0x7FFFFFFF,
+} RPXLoaderPreflightMode;
+
+typedef enum RPXLoaderPreflightError {
+    RPX_LOADER_PREFLIGHT_OK                = 0,
+    RPX_LOADER_PREFLIGHT_UNKNOWN_FORMAT    = 1,
+    RPX_LOADER_PREFLIGHT_IO_ERROR          = 2,
+    RPX_LOADER_PREFLIGHT_TRUNCATED         = 3,
+    RPX_LOADER_PREFLIGHT_BAD_HEADER        = 4,
+    RPX_LOADER_PREFLIGHT_BAD_SECTION_TABLE = 5,
+    RPX_LOADER_PREFLIGHT_BAD_SECTION_DATA  = 6,
+    RPX_LOADER_PREFLIGHT_CRC_MISMATCH      = 7,
+    RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE   = 8,
+    RPX_LOADER_PREFLIGHT_CANCELLED         = 9,
+} RPXLoaderPreflightError;
+
+#define RPX_LOADER_PREFLIGHT_NO_INDEX 0xFFFFFFFF
+
+typedef struct RPXLoaderPreflightResult {
+    RPXLoaderPreflightError error;
+    /** .rpx: index of the affected section. .wuhb: offset of the affected entry inside its table. */
+    uint32_t index;
+    /** File offset where the problem was detected. */
+    uint64_t offset;
+    /** Number of bytes that have been read from the file. */
+    uint64_t bytesRead;
+} RPXLoaderPreflightResult;
+
+/**
+ * Called after every chunk that has been read.
+ * @return false to cancel the check, it then finishes with RPX_LOADER_PREFLIGHT_CANCELLED.
+ */
+typedef bool (*RPXLoaderPreflightProgressCallback)(uint64_t bytesDone, uint64_t bytesTotal, void *context);
+
+const char *RPXLoader_GetPreflightErrorStr(RPXLoaderPreflightError error);
+
+/**
+ * Checks whether a .rpx/.wuhb looks intact before it's passed to RPXLoader_PrepareLaunchFromSD or
+ * RPXLoader_LaunchHomebrew, so a truncated or corrupted file is detected before the wrapper app is launched.<br>
+ * The file is read sequentially in large aligned chunks. The format is detected via the file content.<br>
+ * <br>
+ * Works without RPXLoader_InitLibrary and without the RPXLoadingModule. <br>
+ *
+ * @param path path to the .rpx/.wuhb, relative to the root of the sd card.
+ * @param mode see RPXLoaderPreflightMode
+ * @param callback (optional) progress callback
+ * @param context passed to the callback
+ * @param outResult receives the result of the check
+ * @return  RPX_LOADER_RESULT_SUCCESS:          The check has been done, see outResult->error for the result.<br>
+ *          RPX_LOADER_RESULT_INVALID_ARGUMENT: path or outResult was NULL or mode is invalid.<br>
+ *          RPX_LOADER_RESULT_NOT_FOUND:        The file could not be opened.<br>
+ *          RPX_LOADER_RESULT_UNKNOWN_ERROR:    Failed to allocate memory.
+ */
+RPXLoaderStatus RPXLoader_PreflightCheck(const char *path, RPXLoaderPreflightMode mode, RPXLoaderPreflightProgressCallback callback, void *context, RPXLoaderPreflightResult *outResult);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "rpxloader.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Access profiles of redirected bundle content. <br>
+ * <br>
+ * While a profile is recorded, the module appends a record for every /vol/content open and read it redirects into the
+ * running .wuhb. The records go into a buffer the lib allocates when the recording starts, nothing is allocated on the
+ * I/O path. If the buffer is full, further accesses are only counted. <br>
+ * <br>
+ * The path hashes are the same as RPXLoader_BundleHashPath, so the records of the reads can be used as
+ * RPXLoaderPrefetchHint. `host/build/rpxloader_profile` analyses a profile exported via RPXLoader_ExportAccessProfile.
+ */
+
+/** Number of records if 0 is passed to RPXLoader_StartAccessProfile, 384 KiB. */
+#define RPX_LOADER_ACCESS_PROFILE_DEFAULT_CAPACITY 16384
+
+typedef enum RPXLoaderAccessType {
+    RPX_LOADER_ACCESS_OPEN = 0,
+    RPX_LOADER_ACCESS_READ = 1,
+} RPXLoaderAccessType;
+
+typedef struct RPXLoaderAccessRecord {
+    /** OSGetTime() when the access started. */
+    uint64_t time;
+    /** Hash of the path relative to the root of the bundle, see RPXLoader_BundleHashPath. */
+    uint32_t pathHash;
+    /** Offset inside the file, 0 for opens. */
+    uint32_t offset;
+    /** Number of bytes read, 0 for opens. */
+    uint32_t length;
+    /** RPXLoaderAccessType */
+    uint32_t type;
+} RPXLoaderAccessRecord;
+
+/**
+ * Buffer that is passed to the module while recording. <br>
+ * The module reserves a record by atomically incrementing `written` and only fills it if the index is below
+ * `capacity`. Once the module has been called with NULL, it doesn't touch the buffer anymore.
+ */
+typedef struct RPXLoaderAccessLog {
+    RPXLoaderAccessRecord *records;
+    uint32_t capacity;
+    /** Number of accesses since the start, including the ones that didn't fit. */
+    uint32_t written;
+} RPXLoaderAccessLog;
+
+/**
+ * Starts recording the accesses to the running bundle. A previous profile is discarded. <br>
+ * <br>
+ * Requires API version 7 or higher. <br>
+ *
+ * @param capacity number of records, 0 for RPX_LOADER_ACCESS_PROFILE_DEFAULT_CAPACITY
+ * @return RPX_LOADER_RESULT_SUCCESS:               The recording has been started.<br>
+ *         RPX_LOADER_RESULT_LIB_UNINITIALIZED:     Library was not initialized. Call RPXLoader_InitLibrary() before using this function.<br>
+ *         RPX_LOADER_RESULT_UNSUPPORTED_COMMAND:   Command not supported by the currently loaded RPXLoaderModule version.<br>
+ *         RPX_LOADER_RESULT_UNKNOWN_ERROR:         The buffer could not be allocated.
+ */
+RPXLoaderStatus RPXLoader_StartAccessProfile(uint32_t capacity);
+
+/**
+ * Stops the recording, the profile stays available until the next start or RPXLoader_DeInitLibrary. <br>
+ * <br>
+ * Requires API version 7 or higher. <br>
+ *
+ * @return RPX_LOADER_RESULT_SUCCESS:               The recording has been stopped.<br>
+ *         RPX_LOADER_RESULT_LIB_UNINITIALIZED:     Library was not initialized. Call RPXLoader_InitLibrary() before using this function.<br>
+ *         RPX_LOADER_RESULT_UNSUPPORTED_COMMAND:   Command not supported by the currently loaded RPXLoaderModule version.<br>
+ *         RPX_LOADER_RESULT_NOT_AVAILABLE:         No profile is being recorded.
+ */
+RPXLoaderStatus RPXLoader_StopAccessProfile();
+
+/**
+ * Returns the records of the stopped profile in the order the accesses have been made.
+ *
+ * @param outRecords receives a pointer to the records, valid until the next start or RPXLoader_DeInitLibrary
+ * @param outCount receives the number of records
+ * @param outDropped (optional) receives the number of accesses that didn't fit into the buffer
+ * @return RPX_LOADER_RESULT_SUCCESS:          The records have been returned.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT: outRecords or outCount was NULL.<br>
+ *         RPX_LOADER_RESULT_NOT_AVAILABLE:    There is no profile or it's still being recorded.
+ */
+RPXLoaderStatus RPXLoader_GetAccessProfile(const RPXLoaderAccessRecord **outRecords, uint32_t *outCount, uint32_t *outDropped);
+
+/**
+ * Writes the stopped profile to the sd card. If the running executable is a .wuhb, the path, offset and size of
+ * every file in the profile are written as well, so the profile can be analysed without the bundle.
+ *
+ * @param path path of the file, relative to the root of the sd card. Its directory has to exist.
+ * @return RPX_LOADER_RESULT_SUCCESS:          The profile has been written.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT: path was NULL.<br>
+ *         RPX_LOADER_RESULT_NOT_AVAILABLE:    There is no profile or it's still being recorded.<br>
+ *         RPX_LOADER_RESULT_NOT_FOUND:        The file could not be created.<br>
+ *         RPX_LOADER_RESULT_UNKNOWN_ERROR:    Out of memory or the file could not be written.
+ */
+RPXLoaderStatus RPXLoader_ExportAccessProfile(const char *path);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -4,6 +4,7 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
 #include <stdint.h>
 
 typedef enum RPXLoaderStatus {
@@ -16,30 +17,100 @@ typedef enum RPXLoaderStatus {
     RPX_LOADER_RESULT_MODULE_NOT_FOUND        = -0x30,
     RPX_LOADER_RESULT_MODULE_MISSING_EXPORT   = -0x31,
     RPX_LOADER_RESULT_NOT_AVAILABLE           = -0x40,
+    RPX_LOADER_RESULT_CANCELLED               = -0x50,
     RPX_LOADER_RESULT_UNKNOWN_ERROR           = -0x100,
 } RPXLoaderStatus;
 
 typedef uint32_t RPXLoaderVersion;
 #define RPX_LOADER_MODULE_VERSION_ERROR 0xFFFFFFFF
 
+typedef enum RPXLoaderCommandType {
+    RPX_LOADER_COMMAND_GET_VERSION                    = 0,
+    RPX_LOADER_COMMAND_PREPARE_LAUNCH_FROM_SD         = 1,
+    RPX_LOADER_COMMAND_LAUNCH_PREPARED_HOMEBREW       = 2,
+    RPX_LOADER_COMMAND_LAUNCH_HOMEBREW                = 3,
+    RPX_LOADER_COMMAND_ENABLE_CONTENT_REDIRECTION     = 4,
+    RPX_LOADER_COMMAND_DISABLE_CONTENT_REDIRECTION    = 5,
+    RPX_LOADER_COMMAND_UNMOUNT_CURRENT_RUNNING_BUNDLE = 6,
+    RPX_LOADER_COMMAND_GET_PATH_OF_RUNNING_EXECUTABLE = 7,
+    RPX_LOADER_COMMAND_GET_PATH_OF_SAVE_REDIRECTION   = 8,
+} RPXLoaderCommandType;
+
+/**
+ * A single command for RPXLoader_ExecuteBatch. Each command takes the same arguments as the function of the same name.
+ */
+typedef struct RPXLoaderCommand {
+    RPXLoaderCommandType type;
+    /** Set to the result of the command once it has been executed. */
+    RPXLoaderStatus status;
+    union {
+        struct {
+            uint32_t *outVersion;
+        } getVersion;
+        /** RPX_LOADER_COMMAND_PREPARE_LAUNCH_FROM_SD and RPX_LOADER_COMMAND_LAUNCH_HOMEBREW */
+        struct {
+            const char *path;
+        } launch;
+        /** RPX_LOADER_COMMAND_GET_PATH_OF_RUNNING_EXECUTABLE and RPX_LOADER_COMMAND_GET_PATH_OF_SAVE_REDIRECTION */
+        struct {
+            char *outBuffer;
+            uint32_t outSize;
+        } getPath;
+    } args;
+} RPXLoaderCommand;
+
+/** RPXLoader_ExecuteBatch: Don't execute any further commands after the first one that failed. */
+#define RPX_LOADER_BATCH_FLAG_STOP_ON_FAILURE 0x00000001
+
 const char *RPXLoader_GetStatusStr(RPXLoaderStatus status);
 
 /**
- * This function has to be called before any other function of this lib (except RPXLoader_GetVersion) can be used.
+ * This function has to be called before any other function of this lib (except RPXLoader_GetVersion) can be used.<br>
+ * Only the module and its API version are looked up here, the remaining exports are resolved the first time the
+ * corresponding function is called. See RPXLoader_ResolveAllExports to resolve them up front.<br>
+ * <br>
+ * Can be called from any thread, calling it again after a successful init does nothing.
  *
  * @return  RPX_LOADER_RESULT_SUCCESS:                 The library has been initialized successfully. Other functions can now be used.<br>
  *          RPX_LOADER_RESULT_MODULE_NOT_FOUND:        The module could not be found. Make sure the module is loaded.<br>
  *          RPX_LOADER_RESULT_MODULE_MISSING_EXPORT:   The module is missing an expected export.<br>
- *          RPX_LOADER_RESULT_UNSUPPORTED_API_VERSION: The version of the loaded module is not compatible with this version of the lib.
+ *          RPX_LOADER_RESULT_UNSUPPORTED_API_VERSION: The version of the loaded module is not compatible with this version of the lib.<br>
+ *          RPX_LOADER_RESULT_UNKNOWN_ERROR:           Out of memory.
 */
 RPXLoaderStatus RPXLoader_InitLibrary();
 
 /**
- * Deinitializes the RPXLoader lib
+ * Same as RPXLoader_InitLibrary, but reports whether this call initialized the lib. Only the caller that did should
+ * call RPXLoader_DeInitLibrary, so independent parts of an app (e.g. rpxloader::Session) can share the lib.
+ *
+ * @param outInitialized (optional) receives true if this call initialized the lib, false if it already was
+ *                       initialized or the init failed
+ * @return see RPXLoader_InitLibrary
+ */
+RPXLoaderStatus RPXLoader_InitLibraryEx(bool *outInitialized);
+
+/**
+ * Deinitializes the RPXLoader lib<br>
+ * Must not be called while other threads are still using functions of this lib, the module is released here and a
+ * call that is still running may end up in a module that is no longer loaded.
+ * Pending asynchronous launches are cancelled, a launch that already passed the point of no return is waited for.
+ * A running access profile recording is stopped and the profile is freed, see <rpxloader/profile.h>.
+ * Buffered log messages are written via OSReport, see <rpxloader/log.h>.
  * @return RPX_LOADER_RESULT_SUCCESS
  */
 RPXLoaderStatus RPXLoader_DeInitLibrary();
 
+/**
+ * Resolves all exports that are supported by the API version of the loaded module right away instead of on first use.<br>
+ * Calling this function is optional.
+ *
+ * @return RPX_LOADER_RESULT_SUCCESS:               All exports have been resolved.<br>
+ *         RPX_LOADER_RESULT_LIB_UNINITIALIZED:     Library was not initialized. Call RPXLoader_InitLibrary() before using this function.<br>
+ *         RPX_LOADER_RESULT_MODULE_MISSING_EXPORT: At least one export is missing even though the API version of the module should provide it.
+ *                                                  The affected functions will return RPX_LOADER_RESULT_UNSUPPORTED_COMMAND.
+ */
+RPXLoaderStatus RPXLoader_ResolveAllExports();
+
 /**
  * Retrieves the API Version of the loaded RPXLoaderModule.<br>
  * <br>
@@ -144,6 +215,9 @@ RPXLoaderStatus RPXLoader_UnmountCurrentRunningBundle();
  * This function is not guaranteed to succeed, it only works if the executable is loaded via the RPXLoadingModule <br>
  * The returned path is relative to the root of the sd card.  <br>
  * <br>
+ * The path is cached by this lib until RPXLoader_PrepareLaunchFromSD, RPXLoader_LaunchHomebrew or
+ * RPXLoader_UnmountCurrentRunningBundle is called. If outBuffer is too small, the path is truncated. <br>
+ * <br>
  * Requires API version 2 or higher. <br>
  *
  * @param outBuffer buffer where the result will be stored
@@ -153,14 +227,55 @@ RPXLoaderStatus RPXLoader_UnmountCurrentRunningBundle();
  *          RPX_LOADER_RESULT_INVALID_ARGUMENT:     The given outBuffer was NULL or outSize was 0 <br>
  *          RPX_LOADER_RESULT_LIB_UNINITIALIZED:    "RPXLoader_Init()" was not called.<br>
  *          RPX_LOADER_RESULT_NOT_AVAILABLE:        The path is not available.<br>
+ *          RPX_LOADER_RESULT_UNKNOWN_ERROR:        The path is longer than 4095 characters or out of memory.<br>
 */
 RPXLoaderStatus RPXLoader_GetPathOfRunningExecutable(char *outBuffer, uint32_t outSize);
 
+/**
+ * Same as RPXLoader_GetPathOfRunningExecutable, but never truncates and reports the required buffer size. <br>
+ * Call it with outBuffer = NULL and outSize = 0 to only query the size. <br>
+ * <br>
+ * Requires API version 2 or higher. <br>
+ *
+ * @param outBuffer buffer where the result will be stored, may be NULL if outSize is 0
+ * @param outSize size of outBuffer
+ * @param outRequiredSize (optional) receives the size in bytes including the null terminator that is needed to store the path
+ * @return  RPX_LOADER_RESULT_SUCCESS:              The path has been written to outBuffer or outRequiredSize has been set. <br>
+ *          RPX_LOADER_RESULT_UNSUPPORTED_COMMAND:  Command not supported by the currently loaded RPXLoaderModule version.<br>
+ *          RPX_LOADER_RESULT_INVALID_ARGUMENT:     outBuffer was NULL or is too small. outRequiredSize is still set.<br>
+ *          RPX_LOADER_RESULT_LIB_UNINITIALIZED:    "RPXLoader_Init()" was not called.<br>
+ *          RPX_LOADER_RESULT_NOT_AVAILABLE:        The path is not available.<br>
+ *          RPX_LOADER_RESULT_UNKNOWN_ERROR:        The path is longer than 4095 characters or out of memory.<br>
+*/
+RPXLoaderStatus RPXLoader_GetPathOfRunningExecutableEx(char *outBuffer, uint32_t outSize, uint32_t *outRequiredSize);
+
+/**
+ * Returns a read-only pointer to the cached path of the currently running executable, nothing is copied. <br>
+ * The pointer and the path it points to stay valid until RPXLoader_DeInitLibrary is called. After
+ * RPXLoader_PrepareLaunchFromSD, RPXLoader_LaunchHomebrew or RPXLoader_UnmountCurrentRunningBundle it may be outdated,
+ * call this function again to get the current path. <br>
+ * <br>
+ * Requires API version 2 or higher. <br>
+ *
+ * @param outPath receives a pointer to the null terminated path
+ * @param outLength (optional) receives the length of the path without null terminator
+ * @return  RPX_LOADER_RESULT_SUCCESS:              outPath has been set. <br>
+ *          RPX_LOADER_RESULT_UNSUPPORTED_COMMAND:  Command not supported by the currently loaded RPXLoaderModule version.<br>
+ *          RPX_LOADER_RESULT_INVALID_ARGUMENT:     outPath was NULL.<br>
+ *          RPX_LOADER_RESULT_LIB_UNINITIALIZED:    "RPXLoader_Init()" was not called.<br>
+ *          RPX_LOADER_RESULT_NOT_AVAILABLE:        The path is not available.<br>
+ *          RPX_LOADER_RESULT_UNKNOWN_ERROR:        The path is longer than 4095 characters or out of memory.<br>
+*/
+RPXLoaderStatus RPXLoader_GetPathOfRunningExecutableView(const char **outPath, uint32_t *outLength);
+
 /**
  * Returns the path currently used for /vol/save redirection <br>
  * This function is not guaranteed to succeed, it only works if the executable is loaded via the RPXLoadingModule <br>
  * The returned path is relative to the root of the sd card.  <br>
  * <br>
+ * The path is cached by this lib until RPXLoader_PrepareLaunchFromSD, RPXLoader_LaunchHomebrew or
+ * RPXLoader_UnmountCurrentRunningBundle is called. If outBuffer is too small, the path is truncated. <br>
+ * <br>
  * Requires API version 3 or higher. <br>
  *
  * @param outBuffer buffer where the result will be stored
@@ -170,9 +285,65 @@ RPXLoaderStatus RPXLoader_GetPathOfRunningExecutable(char *outBuffer, uint32_t o
  *          RPX_LOADER_RESULT_INVALID_ARGUMENT:     The given outBuffer was NULL or outSize was 0 <br>
  *          RPX_LOADER_RESULT_LIB_UNINITIALIZED:    "RPXLoader_Init()" was not called.<br>
  *          RPX_LOADER_RESULT_NOT_AVAILABLE:        The path is not available.<br>
+ *          RPX_LOADER_RESULT_UNKNOWN_ERROR:        The path is longer than 4095 characters or out of memory.<br>
 */
 RPXLoaderStatus RPXLoader_GetPathOfSaveRedirection(char *outBuffer, uint32_t outSize);
 
+/**
+ * Same as RPXLoader_GetPathOfSaveRedirection, but never truncates and reports the required buffer size. <br>
+ * Call it with outBuffer = NULL and outSize = 0 to only query the size. <br>
+ * <br>
+ * Requires API version 3 or higher. <br>
+ *
+ * @param outBuffer buffer where the result will be stored, may be NULL if outSize is 0
+ * @param outSize size of outBuffer
+ * @param outRequiredSize (optional) receives the size in bytes including the null terminator that is needed to store the path
+ * @return  RPX_LOADER_RESULT_SUCCESS:              The path has been written to outBuffer or outRequiredSize has been set. <br>
+ *          RPX_LOADER_RESULT_UNSUPPORTED_COMMAND:  Command not supported by the currently loaded RPXLoaderModule version.<br>
+ *          RPX_LOADER_RESULT_INVALID_ARGUMENT:     outBuffer was NULL or is too small. outRequiredSize is still set.<br>
+ *          RPX_LOADER_RESULT_LIB_UNINITIALIZED:    "RPXLoader_Init()" was not called.<br>
+ *          RPX_LOADER_RESULT_NOT_AVAILABLE:        The path is not available.<br>
+ *          RPX_LOADER_RESULT_UNKNOWN_ERROR:        The path is longer than 4095 characters or out of memory.<br>
+*/
+RPXLoaderStatus RPXLoader_GetPathOfSaveRedirectionEx(char *outBuffer, uint32_t outSize, uint32_t *outRequiredSize);
+
+/**
+ * Returns a read-only pointer to the cached /vol/save redirection path, nothing is copied. <br>
+ * The pointer and the path it points to stay valid until RPXLoader_DeInitLibrary is called. After
+ * RPXLoader_PrepareLaunchFromSD, RPXLoader_LaunchHomebrew or RPXLoader_UnmountCurrentRunningBundle it may be outdated,
+ * call this function again to get the current path. <br>
+ * <br>
+ * Requires API version 3 or higher. <br>
+ *
+ * @param outPath receives a pointer to the null terminated path
+ * @param outLength (optional) receives the length of the path without null terminator
+ * @return  RPX_LOADER_RESULT_SUCCESS:              outPath has been set. <br>
+ *          RPX_LOADER_RESULT_UNSUPPORTED_COMMAND:  Command not supported by the currently loaded RPXLoaderModule version.<br>
+ *          RPX_LOADER_RESULT_INVALID_ARGUMENT:     outPath was NULL.<br>
+ *          RPX_LOADER_RESULT_LIB_UNINITIALIZED:    "RPXLoader_Init()" was not called.<br>
+ *          RPX_LOADER_RESULT_NOT_AVAILABLE:        The path is not available.<br>
+ *          RPX_LOADER_RESULT_UNKNOWN_ERROR:        The path is longer than 4095 characters or out of memory.<br>
+*/
+RPXLoaderStatus RPXLoader_GetPathOfSaveRedirectionView(const char **outPath, uint32_t *outLength);
+
+/**
+ * Executes the given commands in order with a single call into the RPXLoadingModule. <br>
+ * The status of each command is written to its "status" field. Commands that are not executed because of
+ * RPX_LOADER_BATCH_FLAG_STOP_ON_FAILURE are left untouched. <br>
+ * <br>
+ * If the loaded RPXLoaderModule can't execute batches or doesn't support a certain command, the affected commands
+ * are executed one by one via the regular functions of this lib, the order is always preserved. <br>
+ *
+ * @param commands array of commands
+ * @param count number of commands
+ * @param flags combination of RPX_LOADER_BATCH_FLAG_* values
+ * @return  RPX_LOADER_RESULT_SUCCESS:              All executed commands were successful.<br>
+ *          RPX_LOADER_RESULT_LIB_UNINITIALIZED:    "RPXLoader_Init()" was not called.<br>
+ *          RPX_LOADER_RESULT_INVALID_ARGUMENT:     commands was NULL or count was 0.<br>
+ *          Otherwise the status of the first command that failed is returned.
+ */
+RPXLoaderStatus RPXLoader_ExecuteBatch(RPXLoaderCommand *commands, uint32_t count, uint32_t flags);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
\ No newline at end of file
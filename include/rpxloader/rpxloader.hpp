@@ -0,0 +1,208 @@
+#pragma once
+
+#include "prefetch.h"
+#include "profile.h"
+#include "rpxloader.h"
+#include "trace.h"
+#include <string_view>
+
+/**
+ * Optional C++17 interface of this lib. <br>
+ * <br>
+ * The minimum API version an app requires is a template parameter of rpxloader::Session. The session checks the
+ * version of the loaded module once, afterwards its functions call the C API without any further version handling.
+ * Functions that need a newer API version than the one the session has been declared with don't compile.
+ *
+ * @code
+ * rpxloader::Session<rpxloader::API_VERSION_SAVE_REDIRECTION> session;
+ * if (session) {
+ *     auto savePath = session.GetPathOfSaveRedirection();
+ * }
+ * @endcode
+ */
+
+namespace rpxloader {
+    /** API version that added the functions, see the "Requires API version" notes in rpxloader.h */
+    inline constexpr RPXLoaderVersion API_VERSION_LAUNCH                     = 1;
+    inline constexpr RPXLoaderVersion API_VERSION_PATH_OF_RUNNING_EXECUTABLE = 2;
+    inline constexpr RPXLoaderVersion API_VERSION_SAVE_REDIRECTION           = 3;
+    inline constexpr RPXLoaderVersion API_VERSION_EXECUTE_BATCH              = 4;
+    inline constexpr RPXLoaderVersion API_VERSION_PREFETCH                   = 5;
+    inline constexpr RPXLoaderVersion API_VERSION_LAUNCH_TRACE               = 6;
+    inline constexpr RPXLoaderVersion API_VERSION_ACCESS_PROFILE             = 7;
+    inline constexpr RPXLoaderVersion API_VERSION_LATEST                     = API_VERSION_ACCESS_PROFILE;
+
+    /**
+     * Initializes the lib when it's created and deinitializes it when it's destroyed. If the lib already has been
+     * initialized (by the app or another session), the session uses it and leaves it initialized, so the owner has to
+     * outlive the session. <br>
+     * <br>
+     * If the module is missing or older than MinVersion, the session is invalid (see status()) and the lib stays uninitialized.
+     */
+    template<RPXLoaderVersion MinVersion>
+    class Session {
+        static_assert(MinVersion >= API_VERSION_LAUNCH && MinVersion <= API_VERSION_LATEST, "Unknown API version");
+
+    public:
+        Session() : mStatus(Init()) {
+        }
+
+        ~Session() {
+            if (mStatus == RPX_LOADER_RESULT_SUCCESS && mOwnsLibrary) {
+                RPXLoader_DeInitLibrary();
+            }
+        }
+
+        Session(const Session &)            = delete;
+        Session &operator=(const Session &) = delete;
+
+        /**
+         * Returns whether the given API version is covered by this session, can be used with `if constexpr`. <br>
+         * Functions that need a newer API version check it via `static_assert(Dependent && Supports(...))`. Dependent
+         * only delays the check until the function is used, passing false never compiles.
+         */
+        static constexpr bool Supports(RPXLoaderVersion version) {
+            return version <= MinVersion;
+        }
+
+        /**
+         * @return RPX_LOADER_RESULT_SUCCESS:                 The session can be used.<br>
+         *         RPX_LOADER_RESULT_UNSUPPORTED_API_VERSION: The loaded module is older than MinVersion.<br>
+         *         See RPXLoader_InitLibrary for other return values.
+         */
+        RPXLoaderStatus status() const {
+            return mStatus;
+        }
+
+        explicit operator bool() const {
+            return mStatus == RPX_LOADER_RESULT_SUCCESS;
+        }
+
+        /**
+         * API version of the loaded module, at least MinVersion if the session is valid.
+         */
+        RPXLoaderVersion version() const {
+            return mVersion;
+        }
+
+        RPXLoaderStatus PrepareLaunchFromSD(const char *path) const {
+            return RPXLoader_PrepareLaunchFromSD(path);
+        }
+
+        RPXLoaderStatus LaunchPreparedHomebrew() const {
+            return RPXLoader_LaunchPreparedHomebrew();
+        }
+
+        RPXLoaderStatus LaunchHomebrew(const char *bundlePath) const {
+            return RPXLoader_LaunchHomebrew(bundlePath);
+        }
+
+        RPXLoaderStatus EnableContentRedirection() const {
+            return RPXLoader_EnableContentRedirection();
+        }
+
+        RPXLoaderStatus DisableContentRedirection() const {
+            return RPXLoader_DisableContentRedirection();
+        }
+
+        RPXLoaderStatus UnmountCurrentRunningBundle() const {
+            return RPXLoader_UnmountCurrentRunningBundle();
+        }
+
+        /**
+         * Returns the cached path of the running executable, nothing is copied. Empty if it's not available. <br>
+         * The view has the same lifetime as the pointer of RPXLoader_GetPathOfRunningExecutableView.
+         *
+         * @param outStatus (optional) receives the status of RPXLoader_GetPathOfRunningExecutableView
+         */
+        template<bool Dependent = true>
+        std::string_view GetPathOfRunningExecutable(RPXLoaderStatus *outStatus = nullptr) const {
+            static_assert(Dependent && Supports(API_VERSION_PATH_OF_RUNNING_EXECUTABLE), "GetPathOfRunningExecutable requires a Session with API version 2 or higher");
+            return GetView(RPXLoader_GetPathOfRunningExecutableView, outStatus);
+        }
+
+        /**
+         * Returns the cached /vol/save redirection path, nothing is copied. Empty if it's not available. <br>
+         * The view has the same lifetime as the pointer of RPXLoader_GetPathOfSaveRedirectionView.
+         *
+         * @param outStatus (optional) receives the status of RPXLoader_GetPathOfSaveRedirectionView
+         */
+        template<bool Dependent = true>
+        std::string_view GetPathOfSaveRedirection(RPXLoaderStatus *outStatus = nullptr) const {
+            static_assert(Dependent && Supports(API_VERSION_SAVE_REDIRECTION), "GetPathOfSaveRedirection requires a Session with API version 3 or higher");
+            return GetView(RPXLoader_GetPathOfSaveRedirectionView, outStatus);
+        }
+
+        /**
+         * See RPXLoader_ExecuteBatch. Batches are only executed by the module itself with API version 4 or higher,
+         * older modules get the commands one by one, so this is available for every session.
+         */
+        RPXLoaderStatus ExecuteBatch(RPXLoaderCommand *commands, uint32_t count, uint32_t flags = 0) const {
+            return RPXLoader_ExecuteBatch(commands, count, flags);
+        }
+
+        /**
+         * See RPXLoader_PrefetchBundle.
+         */
+        template<bool Dependent = true>
+        RPXLoaderStatus PrefetchBundle(const char *bundlePath, const RPXLoaderPrefetchOptions *options = nullptr, RPXLoaderPrefetchStats *outStats = nullptr) const {
+            static_assert(Dependent && Supports(API_VERSION_PREFETCH), "PrefetchBundle requires a Session with API version 5 or higher");
+            return RPXLoader_PrefetchBundle(bundlePath, options, outStats);
+        }
+
+        /**
+         * See RPXLoader_CollectLaunchTrace.
+         */
+        template<bool Dependent = true>
+        RPXLoaderStatus CollectLaunchTrace(uint32_t *outWritten = nullptr) const {
+            static_assert(Dependent && Supports(API_VERSION_LAUNCH_TRACE), "CollectLaunchTrace requires a Session with API version 6 or higher");
+            return RPXLoader_CollectLaunchTrace(outWritten);
+        }
+
+        /**
+         * See RPXLoader_StartAccessProfile.
+         */
+        template<bool Dependent = true>
+        RPXLoaderStatus StartAccessProfile(uint32_t capacity = 0) const {
+            static_assert(Dependent && Supports(API_VERSION_ACCESS_PROFILE), "StartAccessProfile requires a Session with API version 7 or higher");
+            return RPXLoader_StartAccessProfile(capacity);
+        }
+
+        /**
+         * See RPXLoader_StopAccessProfile.
+         */
+        template<bool Dependent = true>
+        RPXLoaderStatus StopAccessProfile() const {
+            static_assert(Dependent && Supports(API_VERSION_ACCESS_PROFILE), "StopAccessProfile requires a Session with API version 7 or higher");
+            return RPXLoader_StopAccessProfile();
+        }
+
+    private:
+        RPXLoaderStatus Init() {
+            if (auto res = RPXLoader_InitLibraryEx(&mOwnsLibrary); res != RPX_LOADER_RESULT_SUCCESS) {
+                return res;
+            }
+            if (RPXLoader_GetVersion(&mVersion) != RPX_LOADER_RESULT_SUCCESS || mVersion < MinVersion) {
+                if (mOwnsLibrary) {
+                    RPXLoader_DeInitLibrary();
+                }
+                return RPX_LOADER_RESULT_UNSUPPORTED_API_VERSION;
+            }
+            return RPX_LOADER_RESULT_SUCCESS;
+        }
+
+        static std::string_view GetView(RPXLoaderStatus (*getView)(const char **, uint32_t *), RPXLoaderStatus *outStatus) {
+            const char *path = nullptr;
+            uint32_t length  = 0;
+            auto res         = getView(&path, &length);
+            if (outStatus != nullptr) {
+                *outStatus = res;
+            }
+            return res == RPX_LOADER_RESULT_SUCCESS ? std::string_view(path, length) : std::string_view();
+        }
+
+        RPXLoaderVersion mVersion = 0;
+        bool mOwnsLibrary         = false;
+        RPXLoaderStatus mStatus;
+    };
+} // namespace rpxloader
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "rpxloader.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Call statistics of the RPXLoader_* functions. Only recorded if this lib has been built with RPX_LOADER_ENABLE_STATS
+ * (`make RPX_LOADER_STATS=1`), otherwise the functions are not instrumented at all.
+ */
+
+#define RPX_LOADER_STATS_CORE_COUNT      3
+#define RPX_LOADER_STATS_LATENCY_BUCKETS 32
+
+typedef enum RPXLoaderStatsAPI {
+    RPX_LOADER_STATS_API_GET_VERSION                     = 0,
+    RPX_LOADER_STATS_API_PREPARE_LAUNCH_FROM_SD          = 1,
+    RPX_LOADER_STATS_API_LAUNCH_PREPARED_HOMEBREW        = 2,
+    RPX_LOADER_STATS_API_LAUNCH_HOMEBREW                 = 3,
+    RPX_LOADER_STATS_API_ENABLE_CONTENT_REDIRECTION      = 4,
+    RPX_LOADER_STATS_API_DISABLE_CONTENT_REDIRECTION     = 5,
+    RPX_LOADER_STATS_API_UNMOUNT_CURRENT_RUNNING_BUNDLE  = 6,
+    /** Includes the Ex and View variants. */
+    RPX_LOADER_STATS_API_GET_PATH_OF_RUNNING_EXECUTABLE  = 7,
+    /** Includes the Ex and View variants. */
+    RPX_LOADER_STATS_API_GET_PATH_OF_SAVE_REDIRECTION    = 8,
+    RPX_LOADER_STATS_API_EXECUTE_BATCH                   = 9,
+    RPX_LOADER_STATS_API_PREFETCH_BUNDLE                 = 10,
+    RPX_LOADER_STATS_API_COLLECT_LAUNCH_TRACE            = 11,
+    /** RPXLoader_StartAccessProfile and RPXLoader_StopAccessProfile */
+    RPX_LOADER_STATS_API_ACCESS_PROFILE                  = 12,
+    RPX_LOADER_STATS_API_COUNT                           = 13,
+} RPXLoaderStatsAPI;
+
+typedef enum RPXLoaderStatsStatus {
+    RPX_LOADER_STATS_STATUS_SUCCESS                 = 0,
+    RPX_LOADER_STATS_STATUS_INVALID_ARGUMENT        = 1,
+    RPX_LOADER_STATS_STATUS_NOT_FOUND               = 2,
+    RPX_LOADER_STATS_STATUS_UNSUPPORTED_API_VERSION = 3,
+    RPX_LOADER_STATS_STATUS_UNSUPPORTED_COMMAND     = 4,
+    RPX_LOADER_STATS_STATUS_LIB_UNINITIALIZED       = 5,
+    RPX_LOADER_STATS_STATUS_MODULE_NOT_FOUND        = 6,
+    RPX_LOADER_STATS_STATUS_MODULE_MISSING_EXPORT   = 7,
+    RPX_LOADER_STATS_STATUS_NOT_AVAILABLE           = 8,
+    RPX_LOADER_STATS_STATUS_CANCELLED               = 9,
+    /** RPX_LOADER_RESULT_UNKNOWN_ERROR and everything that isn't listed above. */
+    RPX_LOADER_STATS_STATUS_OTHER                   = 10,
+    RPX_LOADER_STATS_STATUS_COUNT                   = 11,
+} RPXLoaderStatsStatus;
+
+typedef struct RPXLoaderAPIStats {
+    uint32_t calls;
+    uint32_t callsPerCore[RPX_LOADER_STATS_CORE_COUNT];
+    /** Number of calls per result, see RPXLoader_GetStatsStatus. */
+    uint32_t statusCounts[RPX_LOADER_STATS_STATUS_COUNT];
+    /** Duration of the calls in system ticks. Bucket 0: 0 ticks, bucket n: [2^(n-1), 2^n) ticks. */
+    uint32_t latencyHistogram[RPX_LOADER_STATS_LATENCY_BUCKETS];
+} RPXLoaderAPIStats;
+
+typedef struct RPXLoaderStats {
+    /** Frequency of the system tick, to convert the latency buckets. */
+    uint32_t ticksPerSecond;
+    RPXLoaderAPIStats apis[RPX_LOADER_STATS_API_COUNT];
+} RPXLoaderStats;
+
+/**
+ * Returns the index into RPXLoaderAPIStats::statusCounts for the given status.
+ */
+RPXLoaderStatsStatus RPXLoader_GetStatsStatus(RPXLoaderStatus status);
+
+/**
+ * Sums up the counters of all cores. Works without RPXLoader_InitLibrary. <br>
+ *
+ * @param outStats receives the statistics
+ * @return RPX_LOADER_RESULT_SUCCESS:          outStats has been filled.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT: outStats was NULL.<br>
+ *         RPX_LOADER_RESULT_NOT_AVAILABLE:    The lib has been built without RPX_LOADER_ENABLE_STATS.
+ */
+RPXLoaderStatus RPXLoader_GetStats(RPXLoaderStats *outStats);
+
+/**
+ * Sets all counters to 0. Calls that are in progress at the same time may be partially counted.
+ *
+ * @return RPX_LOADER_RESULT_SUCCESS:       The counters have been reset.<br>
+ *         RPX_LOADER_RESULT_NOT_AVAILABLE: The lib has been built without RPX_LOADER_ENABLE_STATS.
+ */
+RPXLoaderStatus RPXLoader_ResetStats();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
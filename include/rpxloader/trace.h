@@ -0,0 +1,85 @@
+#pragma once
+
+#include "rpxloader.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Launch timeline tracing. <br>
+ * <br>
+ * A launch spans two processes: the launcher prepares and requests it, then the console switches to the wrapper app
+ * that mounts the bundle. While tracing is enabled, the launcher side phases are appended to a small binary trace file
+ * on the sd card as soon as they are finished, so they survive the title switch. After the relaunch, the app enables
+ * tracing with the same file again and calls RPXLoader_CollectLaunchTrace to append the phases only the module has
+ * seen. All timestamps are OSGetTime() values, which keep counting across the title switch. <br>
+ * <br>
+ * `host/build/rpxloader_trace2json` converts one or more trace files into the Chrome trace event format.
+ */
+
+typedef enum RPXLoaderTracePhase {
+    /** RPXLoader_PrepareLaunchFromSD */
+    RPX_LOADER_TRACE_PHASE_PREPARE               = 0,
+    /** Validation of the file by the async launch functions, see RPXLoaderAsyncOptions. Direct RPXLoader_PreflightCheck calls aren't traced. */
+    RPX_LOADER_TRACE_PHASE_VALIDATION            = 1,
+    /** RPXLoader_LaunchPreparedHomebrew or RPXLoader_LaunchHomebrew has been called, the title switch begins. */
+    RPX_LOADER_TRACE_PHASE_LAUNCH_REQUESTED      = 2,
+    /** Recorded by the module: the wrapper app has been started. */
+    RPX_LOADER_TRACE_PHASE_WRAPPER_STARTED       = 3,
+    /** Recorded by the module: the bundle has been mounted. */
+    RPX_LOADER_TRACE_PHASE_BUNDLE_MOUNTED        = 4,
+    /** Recorded by the module: the first /vol/content read has been redirected into the bundle. */
+    RPX_LOADER_TRACE_PHASE_FIRST_REDIRECTED_READ = 5,
+    RPX_LOADER_TRACE_PHASE_COUNT                 = 6,
+} RPXLoaderTracePhase;
+
+/**
+ * Time span of a phase in OSGetTime() ticks. begin == end for phases that are a single point in time, 0 if the phase
+ * hasn't been reached.
+ */
+typedef struct RPXLoaderTraceSpan {
+    uint64_t begin;
+    uint64_t end;
+} RPXLoaderTraceSpan;
+
+/**
+ * Starts appending launch phases to the given file. The file is created if it doesn't exist, its directory has to exist.
+ * Can be called at any time, also before RPXLoader_InitLibrary. <br>
+ * <br>
+ * Every phase is written (and the file closed) right after it has finished, which adds the duration of a small
+ * sd card write to the launch. Tracing is disabled by default, then the phases aren't timed at all.
+ *
+ * @param path path of the trace file, relative to the root of the sd card
+ * @return RPX_LOADER_RESULT_SUCCESS:          Tracing is enabled.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT: path was NULL or too long.<br>
+ *         RPX_LOADER_RESULT_NOT_FOUND:        The file could not be opened or is not a trace file of this lib version.
+ */
+RPXLoaderStatus RPXLoader_EnableLaunchTrace(const char *path);
+
+/**
+ * Stops tracing. A launch that has been prepared but not requested yet is forgotten.
+ */
+void RPXLoader_DisableLaunchTrace();
+
+/**
+ * Appends the phases the module has recorded for the current launch (wrapper started, bundle mounted, first redirected
+ * read) to the trace file. They are assigned to the last launch request in the file. Call it in the relaunched app
+ * once its content has been read the first time, phases that are already in the file are not written again. <br>
+ * <br>
+ * Requires API version 6 or higher. <br>
+ *
+ * @param outWritten (optional) receives the number of phases that have been appended
+ * @return RPX_LOADER_RESULT_SUCCESS:               The phases have been appended.<br>
+ *         RPX_LOADER_RESULT_LIB_UNINITIALIZED:     Library was not initialized. Call RPXLoader_InitLibrary() before using this function.<br>
+ *         RPX_LOADER_RESULT_UNSUPPORTED_COMMAND:   Command not supported by the currently loaded RPXLoaderModule version.<br>
+ *         RPX_LOADER_RESULT_NOT_AVAILABLE:         Tracing is not enabled.<br>
+ *         RPX_LOADER_RESULT_NOT_FOUND:             The trace file contains no launch request.<br>
+ *         RPX_LOADER_RESULT_UNKNOWN_ERROR:         The trace file could not be written.
+ */
+RPXLoaderStatus RPXLoader_CollectLaunchTrace(uint32_t *outWritten);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
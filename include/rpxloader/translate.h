@@ -0,0 +1,61 @@
+#pragma once
+
+#include "rpxloader.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum RPXLoaderPathLocation {
+    /** Path relative to the root of the sd card. */
+    RPX_LOADER_PATH_LOCATION_SD     = 0,
+    /** Path inside the running .wuhb, e.g. "content/data.bin". Can be passed to RPXLoader_BundleFindFile as it is. */
+    RPX_LOADER_PATH_LOCATION_BUNDLE = 1,
+} RPXLoaderPathLocation;
+
+typedef struct RPXLoaderTranslatedPath {
+    /** Null terminated path inside the arena, NULL if the path could not be translated. */
+    const char *path;
+    /** Length of the path without null terminator. */
+    uint32_t length;
+    RPXLoaderPathLocation location;
+    /** Result of the translation of this path, see RPXLoader_TranslatePaths. */
+    RPXLoaderStatus status;
+} RPXLoaderTranslatedPath;
+
+/**
+ * Translates /vol/save/... and /vol/content/... paths into the locations the RPXLoadingModule redirects them to,
+ * so apps can access the files with their own I/O. <br>
+ * /vol/save/x is translated to the save redirection path on the sd card (see RPXLoader_GetPathOfSaveRedirection),
+ * /vol/content/x to content/x inside the running .wuhb. <br>
+ * <br>
+ * All results are written into one caller provided arena, the redirection paths are taken from the same cache as
+ * RPXLoader_GetPathOfRunningExecutableView/RPXLoader_GetPathOfSaveRedirectionView. Nothing is allocated. <br>
+ * Once a path didn't fit into the arena, the following paths are not written either, so the remaining paths can be
+ * translated with another call. <br>
+ * <br>
+ * The status of every path is written to outPaths[i].status:<br>
+ *  RPX_LOADER_RESULT_SUCCESS:              The path has been translated.<br>
+ *  RPX_LOADER_RESULT_INVALID_ARGUMENT:     The path was NULL, doesn't start with /vol/save or /vol/content or didn't fit into the arena.<br>
+ *  RPX_LOADER_RESULT_NOT_AVAILABLE:        /vol/save or /vol/content is not redirected right now (e.g. for /vol/content when a .rpx is running).<br>
+ *  RPX_LOADER_RESULT_UNSUPPORTED_COMMAND:  The loaded RPXLoaderModule version can't report the redirection path.<br>
+ * <br>
+ * Requires API version 2 or higher for /vol/content and 3 or higher for /vol/save paths. <br>
+ *
+ * @param paths array of count paths
+ * @param count number of paths
+ * @param arena buffer that receives the translated paths, may be NULL if arenaSize is 0
+ * @param arenaSize size of the arena
+ * @param outPaths array of count entries that receive the results
+ * @param outRequiredSize (optional) receives the arena size in bytes that is needed to translate all paths
+ * @return RPX_LOADER_RESULT_SUCCESS:           All paths have been translated.<br>
+ *         RPX_LOADER_RESULT_LIB_UNINITIALIZED: Library was not initialized. Call RPXLoader_InitLibrary() before using this function.<br>
+ *         RPX_LOADER_RESULT_INVALID_ARGUMENT:  paths or outPaths was NULL.<br>
+ *         Otherwise the status of the first path that failed is returned.
+ */
+RPXLoaderStatus RPXLoader_TranslatePaths(const char *const *paths, uint32_t count, char *arena, uint32_t arenaSize, RPXLoaderTranslatedPath *outPaths, uint32_t *outRequiredSize);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,203 @@
+#include "dispatch.h"
+#include "logger.h"
+#include "path_cache.h"
+#include "profile_format.h"
+#include "sd_file.h"
+#include "shutdown_hooks.h"
+#include "stats.h"
+#include <algorithm>
+#include <coreinit/time.h>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <rpxloader/bundle.h>
+#include <rpxloader/profile.h>
+#include <string>
+#include <strings.h>
+#include <vector>
+
+typedef RPXLoaderStatus (*RLSetAccessLogFunction)(RPXLoaderAccessLog *log);
+
+static std::mutex sProfileMutex;
+// Owned by the lib, the module writes into it while sRecording is set.
+static RPXLoaderAccessLog sAccessLog;
+static bool sRecording;
+
+static void FreeAccessLog() {
+    delete[] sAccessLog.records;
+    sAccessLog = {};
+}
+
+static uint32_t GetRecordCount() {
+    return std::min(sAccessLog.written, sAccessLog.capacity);
+}
+
+/**
+ * Stops a running recording and frees the profile, runs while the module is still loaded.
+ */
+static void AccessProfile_Shutdown() {
+    std::lock_guard<std::mutex> lock(sProfileMutex);
+    RLSetAccessLogFunction func;
+    if (sRecording && GetExportFunction(RL_EXPORT_SET_ACCESS_LOG, &func) == RPX_LOADER_RESULT_SUCCESS) {
+        func(nullptr);
+    }
+    sRecording = false;
+    FreeAccessLog();
+}
+
+RPXLoaderStatus RPXLoader_StartAccessProfile(uint32_t capacity) {
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_ACCESS_PROFILE, [&]() -> RPXLoaderStatus {
+        RLSetAccessLogFunction func;
+        if (auto res = GetExportFunction(RL_EXPORT_SET_ACCESS_LOG, &func); res != RPX_LOADER_RESULT_SUCCESS) {
+            return res;
+        }
+        if (capacity == 0) {
+            capacity = RPX_LOADER_ACCESS_PROFILE_DEFAULT_CAPACITY;
+        }
+
+        ShutdownHook_Register(RL_SHUTDOWN_HOOK_ACCESS_PROFILE, AccessProfile_Shutdown);
+        std::lock_guard<std::mutex> lock(sProfileMutex);
+        if (sRecording) {
+            func(nullptr);
+            sRecording = false;
+        }
+        FreeAccessLog();
+        auto records = new (std::nothrow) RPXLoaderAccessRecord[capacity];
+        if (records == nullptr) {
+            DEBUG_FUNCTION_LINE_ERR("Failed to allocate %u access records", capacity);
+            return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+        }
+        sAccessLog = {records, capacity, 0};
+        if (auto res = func(&sAccessLog); res != RPX_LOADER_RESULT_SUCCESS) {
+            FreeAccessLog();
+            return res;
+        }
+        sRecording = true;
+        return RPX_LOADER_RESULT_SUCCESS;
+    });
+}
+
+RPXLoaderStatus RPXLoader_StopAccessProfile() {
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_ACCESS_PROFILE, [&]() -> RPXLoaderStatus {
+        RLSetAccessLogFunction func;
+        if (auto res = GetExportFunction(RL_EXPORT_SET_ACCESS_LOG, &func); res != RPX_LOADER_RESULT_SUCCESS) {
+            return res;
+        }
+        std::lock_guard<std::mutex> lock(sProfileMutex);
+        if (!sRecording) {
+            return RPX_LOADER_RESULT_NOT_AVAILABLE;
+        }
+        auto res   = func(nullptr);
+        sRecording = false;
+        return res;
+    });
+}
+
+RPXLoaderStatus RPXLoader_GetAccessProfile(const RPXLoaderAccessRecord **outRecords, uint32_t *outCount, uint32_t *outDropped) {
+    if (outRecords == nullptr || outCount == nullptr) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(sProfileMutex);
+    if (sRecording || sAccessLog.records == nullptr) {
+        return RPX_LOADER_RESULT_NOT_AVAILABLE;
+    }
+    *outRecords = sAccessLog.records;
+    *outCount   = GetRecordCount();
+    if (outDropped != nullptr) {
+        *outDropped = sAccessLog.written - *outCount;
+    }
+    return RPX_LOADER_RESULT_SUCCESS;
+}
+
+/**
+ * Looks up the files of the profile in the running bundle. Empty if the running executable isn't a .wuhb.
+ */
+static std::vector<std::pair<ProfileFileEntry, std::string>> GetProfileFiles(const RPXLoaderAccessRecord *records, uint32_t count) {
+    std::vector<std::pair<ProfileFileEntry, std::string>> files;
+    const char *path;
+    uint32_t length;
+    if (PathCache_Get(RL_PATH_RUNNING_EXECUTABLE, &path, &length) != RPX_LOADER_RESULT_SUCCESS || length < 5 || strcasecmp(path + length - 5, ".wuhb") != 0) {
+        return files;
+    }
+    RPXLoaderBundle *openedBundle = nullptr;
+    if (RPXLoader_BundleOpen(std::string(path, length).c_str(), &openedBundle) != RPX_LOADER_RESULT_SUCCESS) {
+        DEBUG_FUNCTION_LINE_WARN("Failed to open the running bundle, the profile is exported without paths");
+        return files;
+    }
+    std::unique_ptr<RPXLoaderBundle, decltype(&RPXLoader_BundleClose)> bundle(openedBundle, &RPXLoader_BundleClose);
+    std::vector<uint32_t> hashes;
+    for (uint32_t i = 0; i < count; i++) {
+        hashes.push_back(records[i].pathHash);
+    }
+    std::sort(hashes.begin(), hashes.end());
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+    RPXLoaderBundleFileInfo info;
+    for (auto hash : hashes) {
+        if (RPXLoader_BundleFindFileByHash(bundle.get(), hash, &info) == RPX_LOADER_RESULT_SUCCESS) {
+            files.push_back({{hash, (uint32_t) strlen(info.path), info.offset, info.size}, info.path});
+        }
+    }
+    return files;
+}
+
+// Has to be called with sProfileMutex held.
+static RPXLoaderStatus ExportProfile(const char *path, const char *fullPath) {
+    auto count = GetRecordCount();
+    auto files = GetProfileFiles(sAccessLog.records, count);
+
+    uint64_t size = PROFILE_HEADER_SIZE + (uint64_t) count * PROFILE_RECORD_SIZE;
+    for (auto &file : files) {
+        size += ProfileFile_GetEntrySize(file.first.pathLength);
+    }
+    if (size > SIZE_MAX) {
+        DEBUG_FUNCTION_LINE_ERR("The profile is too large to be exported");
+        return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+    }
+    // Built in memory, the sd card is much faster with a single large write.
+    std::vector<uint8_t> data(size);
+    ProfileFile_StoreHeader(data.data(), {PROFILE_FILE_MAGIC, PROFILE_FILE_VERSION, PROFILE_RECORD_SIZE, (uint32_t) OSTimerClockSpeed,
+                                          count, sAccessLog.written - count, (uint32_t) files.size()});
+    auto out = &data[PROFILE_HEADER_SIZE];
+    for (uint32_t i = 0; i < count; i++, out += PROFILE_RECORD_SIZE) {
+        ProfileFile_StoreRecord(out, sAccessLog.records[i]);
+    }
+    for (auto &file : files) {
+        ProfileFile_StoreFileEntry(out, file.first);
+        memcpy(out + PROFILE_FILE_ENTRY_SIZE, file.second.data(), file.first.pathLength);
+        out += ProfileFile_GetEntrySize(file.first.pathLength);
+    }
+
+    auto file = fopen(fullPath, "wb");
+    if (file == nullptr) {
+        DEBUG_FUNCTION_LINE_ERR("Failed to create %s", path);
+        return RPX_LOADER_RESULT_NOT_FOUND;
+    }
+    bool success = fwrite(data.data(), data.size(), 1, file) == 1;
+    if (fclose(file) != 0 || !success) {
+        DEBUG_FUNCTION_LINE_ERR("Failed to write %s", path);
+        return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+    }
+    return RPX_LOADER_RESULT_SUCCESS;
+}
+
+RPXLoaderStatus RPXLoader_ExportAccessProfile(const char *path) {
+    char fullPath[0x280];
+    if (path == nullptr || !SDFile_BuildPath(fullPath, sizeof(fullPath), path)) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(sProfileMutex);
+    if (sRecording || sAccessLog.records == nullptr) {
+        return RPX_LOADER_RESULT_NOT_AVAILABLE;
+    }
+    // The file is built in memory, which throws if the memory runs out. That must not leave this C function.
+    try {
+        return ExportProfile(path, fullPath);
+    } catch (const std::bad_alloc &) {
+        DEBUG_FUNCTION_LINE_ERR("Out of memory while exporting the profile to %s", path);
+        return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+    }
+}
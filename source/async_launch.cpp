@@ -0,0 +1,250 @@
+#include "dispatch.h"
+#include "launch_trace.h"
+#include "logger.h"
+#include "shutdown_hooks.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <rpxloader/async.h>
+#include <string>
+#include <thread>
+
+struct RPXLoaderAsyncLaunch {
+    bool launch;
+    std::string path;
+    RPXLoaderAsyncOptions options;
+    std::atomic<uint32_t> state{RPX_LOADER_ASYNC_STATE_QUEUED};
+    // Owned by the caller and by the worker until the request has finished.
+    std::atomic<uint32_t> refCount{2};
+    // Written by the worker before finished is set.
+    RPXLoaderStatus result             = RPX_LOADER_RESULT_UNKNOWN_ERROR;
+    RPXLoaderPreflightResult preflight = {RPX_LOADER_PREFLIGHT_OK, RPX_LOADER_PREFLIGHT_NO_INDEX, 0, 0};
+    std::atomic<bool> finished{false};
+    std::mutex mutex;
+    std::condition_variable finishedCondition;
+};
+
+static std::mutex sQueueMutex;
+static std::condition_variable sQueueCondition;
+static std::deque<RPXLoaderAsyncLaunch *> sQueue;
+static std::thread sWorker;
+static bool sStopWorker = false;
+// Request the worker is processing right now, protected by sQueueMutex.
+static RPXLoaderAsyncLaunch *sCurrent = nullptr;
+
+static void Release(RPXLoaderAsyncLaunch *handle) {
+    if (handle->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete handle;
+    }
+}
+
+static bool TryTransition(RPXLoaderAsyncLaunch *handle, RPXLoaderAsyncState from, RPXLoaderAsyncState to) {
+    uint32_t expected = from;
+    return handle->state.compare_exchange_strong(expected, to, std::memory_order_acq_rel);
+}
+
+static void Finish(RPXLoaderAsyncLaunch *handle, RPXLoaderAsyncState from, RPXLoaderStatus result) {
+    // Fails if the request has been cancelled in the meantime.
+    if (result != RPX_LOADER_RESULT_CANCELLED && !TryTransition(handle, from, RPX_LOADER_ASYNC_STATE_COMPLETED)) {
+        result = RPX_LOADER_RESULT_CANCELLED;
+    }
+    handle->result = result;
+    if (handle->options.callback != nullptr) {
+        handle->options.callback(handle, result, handle->options.context);
+    }
+    {
+        std::lock_guard<std::mutex> lock(handle->mutex);
+        handle->finished.store(true, std::memory_order_release);
+    }
+    handle->finishedCondition.notify_all();
+}
+
+static bool PreflightProgress(uint64_t, uint64_t, void *context) {
+    auto handle = (RPXLoaderAsyncLaunch *) context;
+    return handle->state.load(std::memory_order_acquire) != RPX_LOADER_ASYNC_STATE_CANCELLED;
+}
+
+static RPXLoaderStatus Validate(RPXLoaderAsyncLaunch *handle) {
+    if (handle->options.skipPreflight) {
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+    // Only the validation of a launch is traced, not every RPXLoader_PreflightCheck of the app.
+    auto res = LaunchTrace_Measure(RPX_LOADER_TRACE_PHASE_VALIDATION, handle->path.c_str(), [handle]() {
+        return RPXLoader_PreflightCheck(handle->path.c_str(), handle->options.preflightMode, PreflightProgress, handle, &handle->preflight);
+    });
+    if (res != RPX_LOADER_RESULT_SUCCESS) {
+        return res;
+    }
+    switch (handle->preflight.error) {
+        case RPX_LOADER_PREFLIGHT_OK:
+            return RPX_LOADER_RESULT_SUCCESS;
+        case RPX_LOADER_PREFLIGHT_CANCELLED:
+            return RPX_LOADER_RESULT_CANCELLED;
+        default:
+            DEBUG_FUNCTION_LINE_WARN("Preflight check of %s failed: %s", handle->path.c_str(), RPXLoader_GetPreflightErrorStr(handle->preflight.error));
+            return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+}
+
+static void Process(RPXLoaderAsyncLaunch *handle) {
+    if (!TryTransition(handle, RPX_LOADER_ASYNC_STATE_QUEUED, RPX_LOADER_ASYNC_STATE_VALIDATING)) {
+        Finish(handle, RPX_LOADER_ASYNC_STATE_QUEUED, RPX_LOADER_RESULT_CANCELLED);
+        return;
+    }
+    auto res = Validate(handle);
+    if (res != RPX_LOADER_RESULT_SUCCESS) {
+        Finish(handle, RPX_LOADER_ASYNC_STATE_VALIDATING, res);
+        return;
+    }
+    // Point of no return.
+    if (!TryTransition(handle, RPX_LOADER_ASYNC_STATE_VALIDATING, RPX_LOADER_ASYNC_STATE_LAUNCHING)) {
+        Finish(handle, RPX_LOADER_ASYNC_STATE_VALIDATING, RPX_LOADER_RESULT_CANCELLED);
+        return;
+    }
+    if (handle->launch) {
+        res = RPXLoader_LaunchHomebrew(handle->path.c_str());
+    } else {
+        res = RPXLoader_PrepareLaunchFromSD(handle->path.c_str());
+    }
+    Finish(handle, RPX_LOADER_ASYNC_STATE_LAUNCHING, res);
+}
+
+static void WorkerMain() {
+    while (true) {
+        RPXLoaderAsyncLaunch *handle = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(sQueueMutex);
+            sQueueCondition.wait(lock, [] { return sStopWorker || !sQueue.empty(); });
+            if (sQueue.empty()) {
+                return;
+            }
+            handle = sQueue.front();
+            sQueue.pop_front();
+            sCurrent = handle;
+        }
+        Process(handle);
+        {
+            std::lock_guard<std::mutex> lock(sQueueMutex);
+            sCurrent = nullptr;
+        }
+        Release(handle);
+    }
+}
+
+/**
+ * Cancels all pending asynchronous launches and stops the worker thread.
+ * Waits for a launch that already passed the point of no return.
+ */
+static void AsyncLaunch_Shutdown() {
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(sQueueMutex);
+        if (!sWorker.joinable()) {
+            return;
+        }
+        // The worker finishes the queued requests as cancelled, a request that is already launching can't be stopped.
+        for (auto handle : sQueue) {
+            RPXLoader_AsyncCancel(handle);
+        }
+        if (sCurrent != nullptr) {
+            RPXLoader_AsyncCancel(sCurrent);
+        }
+        sStopWorker = true;
+        worker      = std::move(sWorker);
+    }
+    sQueueCondition.notify_all();
+    worker.join();
+}
+
+static RPXLoaderStatus Submit(bool launch, const char *path, const RPXLoaderAsyncOptions *options, RPXLoaderAsyncLaunch **outHandle) {
+    if (path == nullptr || outHandle == nullptr) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    // Report a missing library init or an old module right away instead of via the handle.
+    decltype(&RPXLoader_LaunchHomebrew) func;
+    if (auto res = GetExportFunction(launch ? RL_EXPORT_LAUNCH_HOMEBREW : RL_EXPORT_PREPARE_LAUNCH_FROM_SD, &func); res != RPX_LOADER_RESULT_SUCCESS) {
+        return res;
+    }
+
+    auto handle = new (std::nothrow) RPXLoaderAsyncLaunch;
+    if (handle == nullptr) {
+        return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+    }
+    handle->launch  = launch;
+    handle->path    = path;
+    handle->options = options != nullptr ? *options : RPXLoaderAsyncOptions{RPX_LOADER_PREFLIGHT_MODE_HEADERS_ONLY, 0, nullptr, nullptr};
+
+    {
+        std::lock_guard<std::mutex> lock(sQueueMutex);
+        if (!sWorker.joinable()) {
+            ShutdownHook_Register(RL_SHUTDOWN_HOOK_ASYNC_LAUNCH, AsyncLaunch_Shutdown);
+            sStopWorker = false;
+            sWorker     = std::thread(WorkerMain);
+            if (!sWorker.joinable()) {
+                delete handle;
+                return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+            }
+        }
+        sQueue.push_back(handle);
+    }
+    sQueueCondition.notify_one();
+    *outHandle = handle;
+    return RPX_LOADER_RESULT_SUCCESS;
+}
+
+RPXLoaderStatus RPXLoader_PrepareLaunchFromSDAsync(const char *path, const RPXLoaderAsyncOptions *options, RPXLoaderAsyncLaunch **outHandle) {
+    return Submit(false, path, options, outHandle);
+}
+
+RPXLoaderStatus RPXLoader_LaunchHomebrewAsync(const char *bundle_path, const RPXLoaderAsyncOptions *options, RPXLoaderAsyncLaunch **outHandle) {
+    return Submit(true, bundle_path, options, outHandle);
+}
+
+RPXLoaderStatus RPXLoader_AsyncCancel(RPXLoaderAsyncLaunch *handle) {
+    if (handle == nullptr) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    if (TryTransition(handle, RPX_LOADER_ASYNC_STATE_QUEUED, RPX_LOADER_ASYNC_STATE_CANCELLED) ||
+        TryTransition(handle, RPX_LOADER_ASYNC_STATE_VALIDATING, RPX_LOADER_ASYNC_STATE_CANCELLED)) {
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+    return RPX_LOADER_RESULT_NOT_AVAILABLE;
+}
+
+RPXLoaderAsyncState RPXLoader_AsyncGetState(const RPXLoaderAsyncLaunch *handle) {
+    if (handle == nullptr) {
+        return RPX_LOADER_ASYNC_STATE_CANCELLED;
+    }
+    return (RPXLoaderAsyncState) handle->state.load(std::memory_order_acquire);
+}
+
+RPXLoaderStatus RPXLoader_AsyncGetResult(const RPXLoaderAsyncLaunch *handle, RPXLoaderStatus *outResult, RPXLoaderPreflightResult *outPreflight) {
+    if (handle == nullptr || outResult == nullptr) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    if (!handle->finished.load(std::memory_order_acquire)) {
+        return RPX_LOADER_RESULT_NOT_AVAILABLE;
+    }
+    *outResult = handle->result;
+    if (outPreflight != nullptr) {
+        *outPreflight = handle->preflight;
+    }
+    return RPX_LOADER_RESULT_SUCCESS;
+}
+
+RPXLoaderStatus RPXLoader_AsyncWait(RPXLoaderAsyncLaunch *handle) {
+    if (handle == nullptr) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    std::unique_lock<std::mutex> lock(handle->mutex);
+    handle->finishedCondition.wait(lock, [handle] { return handle->finished.load(std::memory_order_acquire); });
+    return handle->result;
+}
+
+void RPXLoader_AsyncFree(RPXLoaderAsyncLaunch *handle) {
+    if (handle != nullptr) {
+        Release(handle);
+    }
+}
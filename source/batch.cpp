@@ -0,0 +1,152 @@
+#include "dispatch.h"
+#include "launch_trace.h"
+#include "logger.h"
+#include "path_cache.h"
+#include "stats.h"
+#include <rpxloader/rpxloader.h>
+
+// Always stops at the first command that failed, outProcessed includes that command.
+typedef RPXLoaderStatus (*RLExecuteBatchFunction)(RPXLoaderCommand *commands, uint32_t count, uint32_t *outProcessed);
+
+// Commands the module can execute as part of a batch, indexed by RPXLoaderCommandType.
+static constexpr RPXLoaderVersion sBatchCommandMinVersion[] = {
+        4, // RPX_LOADER_COMMAND_GET_VERSION
+        4, // RPX_LOADER_COMMAND_PREPARE_LAUNCH_FROM_SD
+        4, // RPX_LOADER_COMMAND_LAUNCH_PREPARED_HOMEBREW
+        4, // RPX_LOADER_COMMAND_LAUNCH_HOMEBREW
+        4, // RPX_LOADER_COMMAND_ENABLE_CONTENT_REDIRECTION
+        4, // RPX_LOADER_COMMAND_DISABLE_CONTENT_REDIRECTION
+        4, // RPX_LOADER_COMMAND_UNMOUNT_CURRENT_RUNNING_BUNDLE
+        4, // RPX_LOADER_COMMAND_GET_PATH_OF_RUNNING_EXECUTABLE
+        4, // RPX_LOADER_COMMAND_GET_PATH_OF_SAVE_REDIRECTION
+};
+
+static bool IsLaunchCommand(const RPXLoaderCommand &command) {
+    switch (command.type) {
+        case RPX_LOADER_COMMAND_PREPARE_LAUNCH_FROM_SD:
+        case RPX_LOADER_COMMAND_LAUNCH_PREPARED_HOMEBREW:
+        case RPX_LOADER_COMMAND_LAUNCH_HOMEBREW:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool IsBatchCommandSupported(const RPXLoaderCommand &command, RPXLoaderVersion version) {
+    // The module doesn't trace, launch commands have to go through the regular functions while tracing.
+    if (LaunchTrace_IsEnabled() && IsLaunchCommand(command)) {
+        return false;
+    }
+    auto type = (uint32_t) command.type;
+    return type < sizeof(sBatchCommandMinVersion) / sizeof(sBatchCommandMinVersion[0]) && version >= sBatchCommandMinVersion[type];
+}
+
+static bool InvalidatesPathCache(const RPXLoaderCommand &command) {
+    switch (command.type) {
+        case RPX_LOADER_COMMAND_PREPARE_LAUNCH_FROM_SD:
+        case RPX_LOADER_COMMAND_LAUNCH_HOMEBREW:
+        case RPX_LOADER_COMMAND_UNMOUNT_CURRENT_RUNNING_BUNDLE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static RPXLoaderStatus ExecuteCommand(RPXLoaderCommand &command) {
+    switch (command.type) {
+        case RPX_LOADER_COMMAND_GET_VERSION:
+            return RPXLoader_GetVersion(command.args.getVersion.outVersion);
+        case RPX_LOADER_COMMAND_PREPARE_LAUNCH_FROM_SD:
+            return RPXLoader_PrepareLaunchFromSD(command.args.launch.path);
+        case RPX_LOADER_COMMAND_LAUNCH_PREPARED_HOMEBREW:
+            return RPXLoader_LaunchPreparedHomebrew();
+        case RPX_LOADER_COMMAND_LAUNCH_HOMEBREW:
+            return RPXLoader_LaunchHomebrew(command.args.launch.path);
+        case RPX_LOADER_COMMAND_ENABLE_CONTENT_REDIRECTION:
+            return RPXLoader_EnableContentRedirection();
+        case RPX_LOADER_COMMAND_DISABLE_CONTENT_REDIRECTION:
+            return RPXLoader_DisableContentRedirection();
+        case RPX_LOADER_COMMAND_UNMOUNT_CURRENT_RUNNING_BUNDLE:
+            return RPXLoader_UnmountCurrentRunningBundle();
+        case RPX_LOADER_COMMAND_GET_PATH_OF_RUNNING_EXECUTABLE:
+            return RPXLoader_GetPathOfRunningExecutable(command.args.getPath.outBuffer, command.args.getPath.outSize);
+        case RPX_LOADER_COMMAND_GET_PATH_OF_SAVE_REDIRECTION:
+            return RPXLoader_GetPathOfSaveRedirection(command.args.getPath.outBuffer, command.args.getPath.outSize);
+    }
+    return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+}
+
+RPXLoaderStatus RPXLoader_ExecuteBatch(RPXLoaderCommand *commands, uint32_t count, uint32_t flags) {
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_EXECUTE_BATCH, [&]() -> RPXLoaderStatus {
+        auto dispatch = gDispatch.load(std::memory_order_acquire);
+        if (dispatch == nullptr) {
+            return RPX_LOADER_RESULT_LIB_UNINITIALIZED;
+        }
+        if (commands == nullptr || count == 0) {
+            return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+        }
+
+        RLExecuteBatchFunction executeBatch = nullptr;
+        if (GetExportFunction(RL_EXPORT_EXECUTE_BATCH, &executeBatch) != RPX_LOADER_RESULT_SUCCESS) {
+            executeBatch = nullptr;
+        }
+
+        bool stopOnFailure         = (flags & RPX_LOADER_BATCH_FLAG_STOP_ON_FAILURE) != 0;
+        RPXLoaderStatus firstError = RPX_LOADER_RESULT_SUCCESS;
+        uint32_t i                 = 0;
+        while (i < count) {
+            // Hand the longest run of commands the module can batch over in one go.
+            uint32_t runEnd = i;
+            if (executeBatch != nullptr) {
+                while (runEnd < count && IsBatchCommandSupported(commands[runEnd], dispatch->version)) {
+                    runEnd++;
+                }
+            }
+
+            uint32_t failed = count;
+            if (runEnd > i) {
+                uint32_t processed = 0;
+                auto res           = executeBatch(&commands[i], runEnd - i, &processed);
+                if (processed > runEnd - i) {
+                    processed = runEnd - i;
+                }
+                for (uint32_t j = i; j < i + processed; j++) {
+                    if (InvalidatesPathCache(commands[j])) {
+                        PathCache_Invalidate();
+                        break;
+                    }
+                }
+                if (res == RPX_LOADER_RESULT_SUCCESS && processed == runEnd - i) {
+                    i = runEnd;
+                    continue;
+                }
+                if (processed == 0) {
+                    // The module rejected the batch as a whole, don't try to batch again.
+                    executeBatch = nullptr;
+                    continue;
+                }
+                failed = i + processed - 1;
+                if (commands[failed].status == RPX_LOADER_RESULT_UNSUPPORTED_COMMAND) {
+                    // The module knows the batch API but not this command, retry it via the regular function.
+                    commands[failed].status = ExecuteCommand(commands[failed]);
+                }
+            } else {
+                failed                  = i;
+                commands[failed].status = ExecuteCommand(commands[failed]);
+            }
+
+            auto status = commands[failed].status;
+            if (status != RPX_LOADER_RESULT_SUCCESS) {
+                if (firstError == RPX_LOADER_RESULT_SUCCESS) {
+                    firstError = status;
+                }
+                if (stopOnFailure) {
+                    break;
+                }
+            }
+            i = failed + 1;
+        }
+        return firstError;
+    });
+}
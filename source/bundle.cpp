@@ -0,0 +1,279 @@
+#include "bundle_internal.h"
+#include "logger.h"
+#include "romfs.h"
+#include "sd_file.h"
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <rpxloader/bundle.h>
+#include <string>
+#include <vector>
+
+#define BUNDLE_MAX_DEPTH 64
+
+struct BundleFile {
+    uint32_t pathOffset;
+    uint32_t pathLength;
+    uint64_t offset;
+    uint64_t size;
+};
+
+/**
+ * Slot of the open addressing hash table. The hash is stored next to the index, so probing
+ * only touches the slot array until the right entry has been found.
+ */
+struct BundleSlot {
+    uint32_t hash;
+    uint32_t file; // index + 1, 0 marks an empty slot
+};
+
+struct RPXLoaderBundle {
+    SDFile file;
+    RomFSHeader header;
+    std::mutex readMutex;
+    std::vector<char> paths;
+    std::vector<BundleFile> files;
+    std::vector<BundleSlot> slots;
+    uint32_t slotMask;
+};
+
+uint32_t Bundle_HashPath(const char *path, uint32_t length) {
+    // FNV-1a
+    uint32_t hash = 0x811C9DC5;
+    for (uint32_t i = 0; i < length; i++) {
+        hash ^= (uint8_t) path[i];
+        hash *= 0x01000193;
+    }
+    return hash;
+}
+
+namespace {
+    struct IndexBuilder {
+        const RomFSTables &tables;
+        RPXLoaderBundle &bundle;
+        std::string path;
+        // Limits the walk through broken, circular tables.
+        uint32_t remainingEntries;
+
+        bool AddFiles(uint32_t fileOffset) {
+            RomFSFileEntry entry;
+            for (; fileOffset != ROMFS_ENTRY_EMPTY; fileOffset = entry.sibling) {
+                if (remainingEntries-- == 0 || !RomFS_ParseFileEntry(tables.fileTable.data(), tables.fileTable.size(), fileOffset, &entry)) {
+                    return false;
+                }
+                BundleFile file;
+                file.pathOffset = bundle.paths.size();
+                file.pathLength = path.size() + entry.nameLength;
+                file.offset     = tables.header.fileDataOffset + entry.dataOffset;
+                file.size       = entry.dataSize;
+                if (file.offset < tables.header.fileDataOffset || file.offset > bundle.file.GetSize() || file.size > bundle.file.GetSize() - file.offset) {
+                    return false;
+                }
+                bundle.paths.insert(bundle.paths.end(), path.begin(), path.end());
+                bundle.paths.insert(bundle.paths.end(), entry.name, entry.name + entry.nameLength);
+                bundle.paths.push_back('\0');
+                bundle.files.push_back(file);
+            }
+            return true;
+        }
+
+        bool AddDirectory(uint32_t dirOffset, uint32_t depth) {
+            RomFSDirEntry dir;
+            if (depth > BUNDLE_MAX_DEPTH || !RomFS_ParseDirEntry(tables.dirTable.data(), tables.dirTable.size(), dirOffset, &dir)) {
+                return false;
+            }
+            if (!AddFiles(dir.file)) {
+                return false;
+            }
+            auto pathLength = path.size();
+            for (auto child = dir.child; child != ROMFS_ENTRY_EMPTY;) {
+                RomFSDirEntry childEntry;
+                if (remainingEntries-- == 0 || !RomFS_ParseDirEntry(tables.dirTable.data(), tables.dirTable.size(), child, &childEntry)) {
+                    return false;
+                }
+                path.append(childEntry.name, childEntry.nameLength);
+                path.push_back('/');
+                if (!AddDirectory(child, depth + 1)) {
+                    return false;
+                }
+                path.resize(pathLength);
+                child = childEntry.sibling;
+            }
+            return true;
+        }
+    };
+} // namespace
+
+static bool BuildIndex(RPXLoaderBundle &bundle) {
+    RomFSTables tables;
+    if (!RomFS_LoadTables(bundle.file, &tables)) {
+        return false;
+    }
+    bundle.header = tables.header;
+    IndexBuilder builder{tables, bundle, {}, (uint32_t) (tables.dirTable.size() / ROMFS_DIR_ENTRY_SIZE + tables.fileTable.size() / ROMFS_FILE_ENTRY_SIZE)};
+    if (!builder.AddDirectory(0, 0)) {
+        return false;
+    }
+
+    // At most half of the slots are used, this keeps the probe sequences short.
+    uint32_t slotCount = 16;
+    while (slotCount < bundle.files.size() * 2) {
+        slotCount *= 2;
+    }
+    bundle.slots.assign(slotCount, BundleSlot{0, 0});
+    bundle.slotMask = slotCount - 1;
+    for (uint32_t i = 0; i < bundle.files.size(); i++) {
+        auto &file = bundle.files[i];
+        auto hash  = Bundle_HashPath(&bundle.paths[file.pathOffset], file.pathLength);
+        auto slot  = hash & bundle.slotMask;
+        while (bundle.slots[slot].file != 0) {
+            slot = (slot + 1) & bundle.slotMask;
+        }
+        bundle.slots[slot] = {hash, i + 1};
+    }
+    return true;
+}
+
+static RPXLoaderStatus OpenBundle(const char *path, RPXLoaderBundle **outBundle) {
+    std::unique_ptr<RPXLoaderBundle> bundle(new RPXLoaderBundle);
+    if (!bundle->file.Open(path)) {
+        return RPX_LOADER_RESULT_NOT_FOUND;
+    }
+    if (!BuildIndex(*bundle)) {
+        DEBUG_FUNCTION_LINE_WARN("%s is not a valid .wuhb", path);
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    *outBundle = bundle.release();
+    return RPX_LOADER_RESULT_SUCCESS;
+}
+
+RPXLoaderStatus RPXLoader_BundleOpen(const char *path, RPXLoaderBundle **outBundle) {
+    if (path == nullptr || outBundle == nullptr) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    // The index containers throw if the memory runs out, that must not leave this C function.
+    try {
+        return OpenBundle(path, outBundle);
+    } catch (const std::bad_alloc &) {
+        DEBUG_FUNCTION_LINE_ERR("Out of memory while indexing %s", path);
+        return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+    }
+}
+
+RPXLoaderStatus RPXLoader_BundleOpenMounted(RPXLoaderBundle **outBundle) {
+    if (outBundle == nullptr) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    const char *path = nullptr;
+    if (auto res = RPXLoader_GetPathOfRunningExecutableView(&path, nullptr); res != RPX_LOADER_RESULT_SUCCESS) {
+        return res;
+    }
+    auto length = strlen(path);
+    if (length < 5 || strcasecmp(path + length - 5, ".wuhb") != 0) {
+        return RPX_LOADER_RESULT_NOT_AVAILABLE;
+    }
+    return RPXLoader_BundleOpen(path, outBundle);
+}
+
+void RPXLoader_BundleClose(RPXLoaderBundle *bundle) {
+    delete bundle;
+}
+
+uint32_t RPXLoader_BundleGetFileCount(const RPXLoaderBundle *bundle) {
+    return bundle != nullptr ? bundle->files.size() : 0;
+}
+
+static void FillFileInfo(const RPXLoaderBundle *bundle, uint32_t index, RPXLoaderBundleFileInfo *outInfo) {
+    auto &file      = bundle->files[index];
+    outInfo->path   = &bundle->paths[file.pathOffset];
+    outInfo->index  = index;
+    outInfo->offset = file.offset;
+    outInfo->size   = file.size;
+}
+
+RPXLoaderStatus RPXLoader_BundleFindFile(const RPXLoaderBundle *bundle, const char *path, RPXLoaderBundleFileInfo *outInfo) {
+    if (bundle == nullptr || path == nullptr || outInfo == nullptr) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    while (*path == '/') {
+        path++;
+    }
+    uint32_t length = strlen(path);
+    auto hash       = Bundle_HashPath(path, length);
+    for (auto slot = hash & bundle->slotMask; bundle->slots[slot].file != 0; slot = (slot + 1) & bundle->slotMask) {
+        if (bundle->slots[slot].hash != hash) {
+            continue;
+        }
+        auto index = bundle->slots[slot].file - 1;
+        auto &file = bundle->files[index];
+        if (file.pathLength == length && memcmp(&bundle->paths[file.pathOffset], path, length) == 0) {
+            FillFileInfo(bundle, index, outInfo);
+            return RPX_LOADER_RESULT_SUCCESS;
+        }
+    }
+    return RPX_LOADER_RESULT_NOT_FOUND;
+}
+
+RPXLoaderStatus RPXLoader_BundleFindFileByHash(const RPXLoaderBundle *bundle, uint32_t pathHash, RPXLoaderBundleFileInfo *outInfo) {
+    if (bundle == nullptr || outInfo == nullptr) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    for (auto slot = pathHash & bundle->slotMask; bundle->slots[slot].file != 0; slot = (slot + 1) & bundle->slotMask) {
+        if (bundle->slots[slot].hash == pathHash) {
+            FillFileInfo(bundle, bundle->slots[slot].file - 1, outInfo);
+            return RPX_LOADER_RESULT_SUCCESS;
+        }
+    }
+    return RPX_LOADER_RESULT_NOT_FOUND;
+}
+
+uint32_t RPXLoader_BundleHashPath(const char *path) {
+    if (path == nullptr) {
+        return Bundle_HashPath("", 0);
+    }
+    while (*path == '/') {
+        path++;
+    }
+    return Bundle_HashPath(path, strlen(path));
+}
+
+uint32_t Bundle_GetMetadataRanges(const RPXLoaderBundle *bundle, BundleRange *outRanges) {
+    auto &header = bundle->header;
+    outRanges[0] = {0, header.headerSize};
+    outRanges[1] = {header.dirHashTableOffset, header.dirHashTableSize};
+    outRanges[2] = {header.dirTableOffset, header.dirTableSize};
+    outRanges[3] = {header.fileHashTableOffset, header.fileHashTableSize};
+    outRanges[4] = {header.fileTableOffset, header.fileTableSize};
+    return BUNDLE_METADATA_RANGES;
+}
+
+RPXLoaderStatus RPXLoader_BundleGetFileInfo(const RPXLoaderBundle *bundle, uint32_t index, RPXLoaderBundleFileInfo *outInfo) {
+    if (bundle == nullptr || outInfo == nullptr || index >= bundle->files.size()) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    FillFileInfo(bundle, index, outInfo);
+    return RPX_LOADER_RESULT_SUCCESS;
+}
+
+RPXLoaderStatus RPXLoader_BundleReadFile(RPXLoaderBundle *bundle, uint32_t index, uint64_t offset, void *buffer, uint32_t size, uint32_t *outRead) {
+    if (bundle == nullptr || buffer == nullptr || index >= bundle->files.size()) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    auto &file = bundle->files[index];
+    if (offset >= file.size) {
+        size = 0;
+    } else if (size > file.size - offset) {
+        size = file.size - offset;
+    }
+    if (size > 0) {
+        std::lock_guard<std::mutex> lock(bundle->readMutex);
+        if (!bundle->file.ReadAt(file.offset + offset, buffer, size)) {
+            return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+        }
+    }
+    if (outRead != nullptr) {
+        *outRead = size;
+    }
+    return RPX_LOADER_RESULT_SUCCESS;
+}
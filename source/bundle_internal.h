@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <rpxloader/bundle.h>
+
+// Header and the four RomFS tables.
+#define BUNDLE_METADATA_RANGES 5
+
+struct BundleRange {
+    uint64_t offset;
+    uint64_t size;
+};
+
+/**
+ * FNV-1a hash of a path relative to the root of the bundle, the index of a bundle is keyed by it.
+ */
+uint32_t Bundle_HashPath(const char *path, uint32_t length);
+
+/**
+ * Returns the file ranges of the RomFS header and tables, i.e. everything a lookup reads besides the file data.
+ *
+ * @param outRanges array of BUNDLE_METADATA_RANGES entries
+ * @return the number of ranges
+ */
+uint32_t Bundle_GetMetadataRanges(const RPXLoaderBundle *bundle, BundleRange *outRanges);
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+
+// RPX and WUHB files are big endian. These helpers work regardless of the host byte order.
+
+static inline uint16_t LoadBE16(const uint8_t *data) {
+    return (uint16_t) ((data[0] << 8) | data[1]);
+}
+
+static inline uint32_t LoadBE32(const uint8_t *data) {
+    return ((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) | ((uint32_t) data[2] << 8) | (uint32_t) data[3];
+}
+
+static inline uint64_t LoadBE64(const uint8_t *data) {
+    return ((uint64_t) LoadBE32(data) << 32) | LoadBE32(data + 4);
+}
+
+static inline void StoreBE16(uint8_t *data, uint16_t value) {
+    data[0] = (uint8_t) (value >> 8);
+    data[1] = (uint8_t) value;
+}
+
+static inline void StoreBE32(uint8_t *data, uint32_t value) {
+    data[0] = (uint8_t) (value >> 24);
+    data[1] = (uint8_t) (value >> 16);
+    data[2] = (uint8_t) (value >> 8);
+    data[3] = (uint8_t) value;
+}
+
+static inline void StoreBE64(uint8_t *data, uint64_t value) {
+    StoreBE32(data, (uint32_t) (value >> 32));
+    StoreBE32(data + 4, (uint32_t) value);
+}
@@ -0,0 +1,412 @@
+#include "byte_order.h"
+#include "logger.h"
+#include "romfs.h"
+#include "sd_file.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <memory>
+#include <new>
+#include <rpxloader/catalog.h>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+#include <zlib.h>
+
+/*
+ * Cache file layout, all values are big endian:
+ * 0x00 magic, 0x04 version, 0x08 entry count, 0x0C size of the string table, 0x10 crc32 of everything after the header.
+ * Followed by the entries and the string table. String offsets point into the string table, the string at offset 0
+ * is the scanned directory.
+ */
+#define CATALOG_CACHE_MAGIC       0x524C4354 // "RLCT"
+#define CATALOG_CACHE_VERSION     1
+#define CATALOG_CACHE_HEADER_SIZE 0x14
+#define CATALOG_CACHE_ENTRY_SIZE  0x30
+#define CATALOG_CACHE_MAX_SIZE    0x800000
+#define CATALOG_MAX_META_INI_SIZE 0x2000
+#define CATALOG_MAX_PATH          0x280
+
+struct CatalogItem {
+    std::string path;
+    std::string name;
+    std::string author;
+    RPXLoaderCatalogFileType type;
+    uint32_t iconSize;
+    uint64_t iconOffset;
+    uint64_t fileSize;
+    int64_t modificationTime;
+};
+
+struct RPXLoaderCatalog {
+    std::vector<char> strings;
+    std::vector<RPXLoaderCatalogEntry> entries;
+};
+
+static bool ComparePath(const CatalogItem &item, const std::string &path) {
+    return item.path < path;
+}
+
+static bool HasExtension(const char *name, const char *extension) {
+    auto nameLength      = strlen(name);
+    auto extensionLength = strlen(extension);
+    return nameLength > extensionLength && strcasecmp(name + nameLength - extensionLength, extension) == 0;
+}
+
+static std::string GetBaseName(const std::string &path) {
+    auto start = path.find_last_of('/');
+    start      = start == std::string::npos ? 0 : start + 1;
+    auto end   = path.find_last_of('.');
+    return path.substr(start, end == std::string::npos || end < start ? std::string::npos : end - start);
+}
+
+static std::string Trim(const char *start, const char *end) {
+    while (start < end && (*start == ' ' || *start == '\t')) {
+        start++;
+    }
+    while (end > start && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) {
+        end--;
+    }
+    return std::string(start, end);
+}
+
+/**
+ * Reads name and author from the [menu] section. wuhbtool writes longname, shortname and author.
+ */
+static void ParseMetaIni(const char *data, uint32_t size, CatalogItem &item) {
+    std::string longName;
+    std::string shortName;
+    std::string name;
+    bool inMenu = false;
+    for (auto line = data, end = data + size; line < end;) {
+        auto lineEnd = (const char *) memchr(line, '\n', end - line);
+        lineEnd      = lineEnd != nullptr ? lineEnd : end;
+        auto text    = Trim(line, lineEnd);
+        line         = lineEnd + 1;
+
+        if (!text.empty() && text[0] == '[') {
+            inMenu = text == "[menu]";
+            continue;
+        }
+        auto separator = text.find('=');
+        if (!inMenu || separator == std::string::npos) {
+            continue;
+        }
+        auto key   = Trim(text.data(), text.data() + separator);
+        auto value = Trim(text.data() + separator + 1, text.data() + text.size());
+        if (key == "longname") {
+            longName = value;
+        } else if (key == "shortname") {
+            shortName = value;
+        } else if (key == "name") {
+            name = value;
+        } else if (key == "author") {
+            item.author = value;
+        }
+    }
+    if (!longName.empty()) {
+        item.name = longName;
+    } else if (!shortName.empty()) {
+        item.name = shortName;
+    } else if (!name.empty()) {
+        item.name = name;
+    }
+}
+
+/**
+ * metaIni has to be CATALOG_MAX_META_INI_SIZE bytes, it's allocated once per scan.
+ */
+static void ParseBundle(CatalogItem &item, char *metaIni) {
+    SDFile file;
+    RomFSTables tables;
+    if (!file.Open(item.path.c_str()) || !RomFS_LoadTables(file, &tables)) {
+        DEBUG_FUNCTION_LINE_WARN("Failed to read RomFS of %s", item.path.c_str());
+        return;
+    }
+    RomFSFileEntry entry;
+    if (RomFS_FindFile(tables, "meta/meta.ini", &entry) && entry.dataSize <= CATALOG_MAX_META_INI_SIZE) {
+        if (file.ReadAt(tables.header.fileDataOffset + entry.dataOffset, metaIni, entry.dataSize)) {
+            ParseMetaIni(metaIni, entry.dataSize, item);
+        }
+    }
+    if (RomFS_FindFile(tables, "meta/iconTex.tga", &entry) && entry.dataSize <= UINT32_MAX &&
+        tables.header.fileDataOffset + entry.dataOffset + entry.dataSize <= file.GetSize()) {
+        item.iconOffset = tables.header.fileDataOffset + entry.dataOffset;
+        item.iconSize   = entry.dataSize;
+    }
+}
+
+static const char *GetCacheString(const std::vector<uint8_t> &cache, uint32_t stringsOffset, uint32_t offset) {
+    uint32_t stringsSize = cache.size() - stringsOffset;
+    if (offset >= stringsSize || memchr(cache.data() + stringsOffset + offset, '\0', stringsSize - offset) == nullptr) {
+        return nullptr;
+    }
+    return (const char *) cache.data() + stringsOffset + offset;
+}
+
+/**
+ * Loads the entries of the cache file, sorted by path. Returns false if the file is missing, broken or belongs to a different directory.
+ */
+static bool LoadCache(const char *cachePath, const char *directory, std::vector<CatalogItem> *outItems) {
+    SDFile file;
+    if (!file.Open(cachePath) || file.GetSize() < CATALOG_CACHE_HEADER_SIZE || file.GetSize() > CATALOG_CACHE_MAX_SIZE) {
+        return false;
+    }
+    std::vector<uint8_t> cache(file.GetSize());
+    if (!file.ReadAt(0, cache.data(), cache.size())) {
+        return false;
+    }
+    auto count       = LoadBE32(cache.data() + 0x08);
+    auto stringsSize = LoadBE32(cache.data() + 0x0C);
+    if (LoadBE32(cache.data()) != CATALOG_CACHE_MAGIC || LoadBE32(cache.data() + 0x04) != CATALOG_CACHE_VERSION ||
+        count > CATALOG_CACHE_MAX_SIZE / CATALOG_CACHE_ENTRY_SIZE ||
+        (uint64_t) CATALOG_CACHE_HEADER_SIZE + count * CATALOG_CACHE_ENTRY_SIZE + stringsSize != cache.size()) {
+        return false;
+    }
+    if (LoadBE32(cache.data() + 0x10) != crc32(0, cache.data() + CATALOG_CACHE_HEADER_SIZE, cache.size() - CATALOG_CACHE_HEADER_SIZE)) {
+        return false;
+    }
+    uint32_t stringsOffset = CATALOG_CACHE_HEADER_SIZE + count * CATALOG_CACHE_ENTRY_SIZE;
+    auto cachedDirectory   = GetCacheString(cache, stringsOffset, 0);
+    if (cachedDirectory == nullptr || strcmp(cachedDirectory, directory) != 0) {
+        return false;
+    }
+
+    outItems->resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        auto entry  = cache.data() + CATALOG_CACHE_HEADER_SIZE + i * CATALOG_CACHE_ENTRY_SIZE;
+        auto path   = GetCacheString(cache, stringsOffset, LoadBE32(entry + 0x00));
+        auto name   = GetCacheString(cache, stringsOffset, LoadBE32(entry + 0x04));
+        auto author = GetCacheString(cache, stringsOffset, LoadBE32(entry + 0x08));
+        if (path == nullptr || name == nullptr || author == nullptr) {
+            return false;
+        }
+        auto &item            = (*outItems)[i];
+        item.path             = path;
+        item.name             = name;
+        item.author           = author;
+        item.type             = (RPXLoaderCatalogFileType) LoadBE32(entry + 0x0C);
+        item.fileSize         = LoadBE64(entry + 0x10);
+        item.modificationTime = (int64_t) LoadBE64(entry + 0x18);
+        item.iconOffset       = LoadBE64(entry + 0x20);
+        item.iconSize         = LoadBE32(entry + 0x28);
+        if (i > 0 && !((*outItems)[i - 1].path < item.path)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t AddString(std::vector<uint8_t> &strings, const std::string &str) {
+    uint32_t offset = strings.size();
+    strings.insert(strings.end(), str.begin(), str.end());
+    strings.push_back('\0');
+    return offset;
+}
+
+static bool WriteCache(const char *cachePath, const char *directory, const std::vector<CatalogItem> &items) {
+    std::vector<uint8_t> strings;
+    std::vector<uint8_t> cache(CATALOG_CACHE_HEADER_SIZE + items.size() * CATALOG_CACHE_ENTRY_SIZE);
+    AddString(strings, directory);
+    for (uint32_t i = 0; i < items.size(); i++) {
+        auto &item = items[i];
+        auto entry = cache.data() + CATALOG_CACHE_HEADER_SIZE + i * CATALOG_CACHE_ENTRY_SIZE;
+        StoreBE32(entry + 0x00, AddString(strings, item.path));
+        StoreBE32(entry + 0x04, AddString(strings, item.name));
+        StoreBE32(entry + 0x08, AddString(strings, item.author));
+        StoreBE32(entry + 0x0C, item.type);
+        StoreBE64(entry + 0x10, item.fileSize);
+        StoreBE64(entry + 0x18, (uint64_t) item.modificationTime);
+        StoreBE64(entry + 0x20, item.iconOffset);
+        StoreBE32(entry + 0x28, item.iconSize);
+        StoreBE32(entry + 0x2C, 0);
+    }
+    cache.insert(cache.end(), strings.begin(), strings.end());
+    StoreBE32(cache.data() + 0x00, CATALOG_CACHE_MAGIC);
+    StoreBE32(cache.data() + 0x04, CATALOG_CACHE_VERSION);
+    StoreBE32(cache.data() + 0x08, items.size());
+    StoreBE32(cache.data() + 0x0C, strings.size());
+    StoreBE32(cache.data() + 0x10, crc32(0, cache.data() + CATALOG_CACHE_HEADER_SIZE, cache.size() - CATALOG_CACHE_HEADER_SIZE));
+
+    // Write to a temporary file first, so a power loss never leaves a half written cache behind.
+    char fullPath[CATALOG_MAX_PATH];
+    char tmpPath[CATALOG_MAX_PATH + 4];
+    if (!SDFile_BuildPath(fullPath, sizeof(fullPath), cachePath)) {
+        return false;
+    }
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", fullPath);
+    auto file = fopen(tmpPath, "wb");
+    if (file == nullptr) {
+        DEBUG_FUNCTION_LINE_WARN("Failed to create %s", tmpPath);
+        return false;
+    }
+    bool success = fwrite(cache.data(), 1, cache.size(), file) == cache.size();
+    success      = (fclose(file) == 0) && success;
+    if (!success) {
+        remove(tmpPath);
+        return false;
+    }
+    remove(fullPath);
+    return rename(tmpPath, fullPath) == 0;
+}
+
+static void ScanDirectory(const std::string &directory, uint32_t depth, std::vector<CatalogItem> &items) {
+    char fullPath[CATALOG_MAX_PATH];
+    if (!SDFile_BuildPath(fullPath, sizeof(fullPath), directory.c_str())) {
+        return;
+    }
+    auto dir = opendir(fullPath);
+    if (dir == nullptr) {
+        return;
+    }
+    std::vector<std::string> subDirectories;
+    while (auto entry = readdir(dir)) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        bool isRPX  = HasExtension(entry->d_name, ".rpx");
+        bool isWUHB = HasExtension(entry->d_name, ".wuhb");
+        // Scanning the root of the sd card must not produce paths with a leading '/'.
+        auto path   = directory.empty() ? std::string(entry->d_name) : directory + "/" + entry->d_name;
+        struct stat info;
+        if (!SDFile_BuildPath(fullPath, sizeof(fullPath), path.c_str()) || stat(fullPath, &info) != 0) {
+            continue;
+        }
+        if (S_ISDIR(info.st_mode)) {
+            if (depth + 1 < RPX_LOADER_CATALOG_MAX_DEPTH) {
+                subDirectories.push_back(std::move(path));
+            }
+        } else if (isRPX || isWUHB) {
+            CatalogItem item{};
+            item.path             = std::move(path);
+            item.type             = isWUHB ? RPX_LOADER_CATALOG_FILE_TYPE_WUHB : RPX_LOADER_CATALOG_FILE_TYPE_RPX;
+            item.fileSize         = info.st_size;
+            item.modificationTime = info.st_mtime;
+            items.push_back(std::move(item));
+        }
+    }
+    closedir(dir);
+    for (auto &subDirectory : subDirectories) {
+        ScanDirectory(subDirectory, depth + 1, items);
+    }
+}
+
+static RPXLoaderCatalog *CreateCatalog(const std::vector<CatalogItem> &items) {
+    std::unique_ptr<RPXLoaderCatalog> catalog(new RPXLoaderCatalog);
+    size_t stringsSize = 0;
+    for (auto &item : items) {
+        stringsSize += item.path.size() + item.name.size() + item.author.size() + 3;
+    }
+    // Reserve everything upfront, the entries point into the string table.
+    catalog->strings.reserve(stringsSize);
+    catalog->entries.reserve(items.size());
+    auto addString = [&catalog](const std::string &str) {
+        auto start = catalog->strings.data() + catalog->strings.size();
+        catalog->strings.insert(catalog->strings.end(), str.begin(), str.end());
+        catalog->strings.push_back('\0');
+        return (const char *) start;
+    };
+    for (auto &item : items) {
+        RPXLoaderCatalogEntry entry;
+        entry.path             = addString(item.path);
+        entry.name             = addString(item.name);
+        entry.author           = addString(item.author);
+        entry.type             = item.type;
+        entry.iconSize         = item.iconSize;
+        entry.iconOffset       = item.iconOffset;
+        entry.fileSize         = item.fileSize;
+        entry.modificationTime = item.modificationTime;
+        catalog->entries.push_back(entry);
+    }
+    return catalog.release();
+}
+
+static RPXLoaderStatus ScanCatalog(const char *directory, const char *cachePath, RPXLoaderCatalog **outCatalog, RPXLoaderCatalogStats *outStats) {
+    std::string root = directory;
+    while (!root.empty() && root.front() == '/') {
+        root.erase(0, 1);
+    }
+    while (!root.empty() && root.back() == '/') {
+        root.pop_back();
+    }
+    char fullPath[CATALOG_MAX_PATH];
+    struct stat info;
+    if (!SDFile_BuildPath(fullPath, sizeof(fullPath), root.c_str()) || stat(fullPath, &info) != 0 || !S_ISDIR(info.st_mode)) {
+        return RPX_LOADER_RESULT_NOT_FOUND;
+    }
+
+    RPXLoaderCatalogStats stats{};
+    std::vector<CatalogItem> cached;
+    if (cachePath != nullptr) {
+        stats.cacheLoaded = LoadCache(cachePath, root.c_str(), &cached);
+        if (!stats.cacheLoaded) {
+            cached.clear();
+        }
+    }
+
+    std::vector<CatalogItem> items;
+    std::vector<char> metaIni(CATALOG_MAX_META_INI_SIZE);
+    ScanDirectory(root, 0, items);
+    std::sort(items.begin(), items.end(), [](const CatalogItem &a, const CatalogItem &b) { return a.path < b.path; });
+
+    uint32_t known = 0;
+    for (auto &item : items) {
+        auto it      = std::lower_bound(cached.begin(), cached.end(), item.path, ComparePath);
+        bool isKnown = it != cached.end() && it->path == item.path;
+        known += isKnown;
+        if (isKnown && it->fileSize == item.fileSize && it->modificationTime == item.modificationTime && it->type == item.type) {
+            item.name       = std::move(it->name);
+            item.author     = std::move(it->author);
+            item.iconOffset = it->iconOffset;
+            item.iconSize   = it->iconSize;
+            stats.reused++;
+            continue;
+        }
+        item.name = GetBaseName(item.path);
+        if (item.type == RPX_LOADER_CATALOG_FILE_TYPE_WUHB) {
+            ParseBundle(item, metaIni.data());
+        }
+        stats.parsed++;
+    }
+    stats.entries = items.size();
+    stats.removed = cached.size() - known;
+
+    if (cachePath != nullptr && (stats.parsed > 0 || stats.removed > 0 || !stats.cacheLoaded)) {
+        stats.cacheWritten = WriteCache(cachePath, root.c_str(), items);
+    }
+
+    *outCatalog = CreateCatalog(items);
+    if (outStats != nullptr) {
+        *outStats = stats;
+    }
+    return RPX_LOADER_RESULT_SUCCESS;
+}
+
+RPXLoaderStatus RPXLoader_CatalogScan(const char *directory, const char *cachePath, RPXLoaderCatalog **outCatalog, RPXLoaderCatalogStats *outStats) {
+    if (directory == nullptr || outCatalog == nullptr) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    // The containers of a scan throw if the memory runs out, that must not leave this C function.
+    try {
+        return ScanCatalog(directory, cachePath, outCatalog, outStats);
+    } catch (const std::bad_alloc &) {
+        DEBUG_FUNCTION_LINE_ERR("Out of memory while scanning %s", directory);
+        return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+    }
+}
+
+uint32_t RPXLoader_CatalogGetCount(const RPXLoaderCatalog *catalog) {
+    return catalog != nullptr ? catalog->entries.size() : 0;
+}
+
+const RPXLoaderCatalogEntry *RPXLoader_CatalogGetEntry(const RPXLoaderCatalog *catalog, uint32_t index) {
+    if (catalog == nullptr || index >= catalog->entries.size()) {
+        return nullptr;
+    }
+    return &catalog->entries[index];
+}
+
+void RPXLoader_CatalogFree(RPXLoaderCatalog *catalog) {
+    delete catalog;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <coreinit/dynload.h>
+#include <rpxloader/rpxloader.h>
+
+enum RPXLoaderExportSlot {
+    RL_EXPORT_PREPARE_LAUNCH_FROM_SD,
+    RL_EXPORT_LAUNCH_PREPARED_HOMEBREW,
+    RL_EXPORT_LAUNCH_HOMEBREW,
+    RL_EXPORT_DISABLE_CONTENT_REDIRECTION,
+    RL_EXPORT_ENABLE_CONTENT_REDIRECTION,
+    RL_EXPORT_UNMOUNT_CURRENT_RUNNING_BUNDLE,
+    RL_EXPORT_GET_PATH_OF_RUNNING_EXECUTABLE,
+    RL_EXPORT_GET_PATH_OF_SAVE_REDIRECTION,
+    RL_EXPORT_EXECUTE_BATCH,
+    RL_EXPORT_PREFETCH_BUNDLE,
+    RL_EXPORT_GET_LAUNCH_TIMELINE,
+    RL_EXPORT_SET_ACCESS_LOG,
+    RL_EXPORT_COUNT,
+};
+
+struct RPXLoaderExport {
+    const char *name;
+    RPXLoaderVersion minVersion;
+};
+
+// Indexed by RPXLoaderExportSlot. Exports are only looked up the first time the matching function is called.
+inline constexpr RPXLoaderExport gExportTable[] = {
+        {"RL_PrepareLaunchFromSD", 1},
+        {"RL_LaunchPreparedHomebrew", 1},
+        {"RL_LaunchHomebrew", 1},
+        {"RL_DisableContentRedirection", 1},
+        {"RL_EnableContentRedirection", 1},
+        {"RL_UnmountCurrentRunningBundle", 1},
+        {"RL_GetPathOfRunningExecutable", 2},
+        {"RL_GetPathOfSaveRedirection", 3},
+        {"RL_ExecuteBatch", 4},
+        {"RL_PrefetchBundle", 5},
+        {"RL_GetLaunchTimeline", 6},
+        {"RL_SetAccessLog", 7},
+};
+static_assert(sizeof(gExportTable) / sizeof(gExportTable[0]) == RL_EXPORT_COUNT, "gExportTable and RPXLoaderExportSlot are out of sync");
+
+/**
+ * Everything the wrappers need to call into the module. RPXLoader_InitLibrary allocates and fills a new one every
+ * time before it's published via gDispatch, it's never reused or freed. Afterwards only the export slots change: each
+ * goes from nullptr (not looked up yet) to its address or a "missing" marker exactly once. Concurrent first calls may
+ * both look the export up, but they store the same value. Slots of a dispatch that is no longer published are not
+ * looked up anymore.
+ */
+struct RPXLoaderDispatch {
+    OSDynLoad_Module module;
+    RPXLoaderVersion version;
+    RPXLoaderStatus (*getVersion)(RPXLoaderVersion *outVersion);
+    std::atomic<void *> exports[RL_EXPORT_COUNT];
+};
+
+extern std::atomic<RPXLoaderDispatch *> gDispatch;
+
+/**
+ * Returns the address of the export or nullptr if the module doesn't provide it.
+ */
+void *ResolveExport(RPXLoaderDispatch *dispatch, RPXLoaderExportSlot slot);
+
+template<typename T>
+RPXLoaderStatus GetExportFunction(RPXLoaderExportSlot slot, T *outFunction) {
+    auto dispatch = gDispatch.load(std::memory_order_acquire);
+    if (dispatch == nullptr) {
+        return RPX_LOADER_RESULT_LIB_UNINITIALIZED;
+    }
+    if (dispatch->version < gExportTable[slot].minVersion) {
+        return RPX_LOADER_RESULT_UNSUPPORTED_COMMAND;
+    }
+    auto address = ResolveExport(dispatch, slot);
+    if (address == nullptr) {
+        return RPX_LOADER_RESULT_UNSUPPORTED_COMMAND;
+    }
+    *outFunction = reinterpret_cast<T>(address);
+    return RPX_LOADER_RESULT_SUCCESS;
+}
@@ -0,0 +1,249 @@
+#include "dispatch.h"
+#include "launch_trace.h"
+#include "logger.h"
+#include "sd_file.h"
+#include "stats.h"
+#include "trace_format.h"
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+// Serializes the writes, the launch functions may be called from the async worker and the app at the same time.
+static std::mutex sTraceMutex;
+static char sTracePath[0x280];
+static uint32_t sLaunchId;
+static char sLaunchName[TRACE_NAME_SIZE];
+
+// The ticks keep counting across the title switch, which makes them unique enough to tell launches apart.
+static uint32_t NewLaunchId() {
+    auto time = (uint64_t) OSGetTime();
+    auto id   = (uint32_t) time ^ (uint32_t) (time >> 32);
+    return id != 0 ? id : 1;
+}
+
+static void SetLaunchName(const char *path) {
+    auto name = strrchr(path, '/');
+    name      = name != nullptr ? name + 1 : path;
+    strncpy(sLaunchName, name, sizeof(sLaunchName) - 1);
+    sLaunchName[sizeof(sLaunchName) - 1] = '\0';
+}
+
+static uint32_t GetModuleVersion() {
+    auto dispatch = gDispatch.load(std::memory_order_acquire);
+    return dispatch != nullptr ? dispatch->version : 0;
+}
+
+// Records are always written with the layout of this version, so only files that use the same one can be continued.
+static bool IsAppendable(const TraceHeader &header) {
+    return header.version == TRACE_FILE_VERSION && header.recordSize == TRACE_RECORD_SIZE;
+}
+
+// The file is closed after every append, so nothing is lost when the title switch ends the process.
+// Has to be called with sTraceMutex held.
+static bool AppendRecords(const TraceRecord *records, uint32_t count) {
+    char fullPath[0x280];
+    if (!SDFile_BuildPath(fullPath, sizeof(fullPath), sTracePath)) {
+        return false;
+    }
+    auto file = fopen(fullPath, "r+b");
+    if (file == nullptr) {
+        return false;
+    }
+    uint8_t data[TRACE_RECORD_SIZE];
+    static_assert(sizeof(data) >= TRACE_HEADER_SIZE);
+    TraceHeader header;
+    bool success = fread(data, TRACE_HEADER_SIZE, 1, file) == 1 && TraceFile_LoadHeader(data, &header) && IsAppendable(header) &&
+                   fseeko(file, 0, SEEK_END) == 0;
+    auto size = success ? ftello(file) : -1;
+    // An append that was cut off leaves a partial record at the end. It's overwritten, so the stride of all following
+    // records stays intact.
+    success = success && size >= TRACE_HEADER_SIZE && fseeko(file, size - (size - TRACE_HEADER_SIZE) % TRACE_RECORD_SIZE, SEEK_SET) == 0;
+    for (uint32_t i = 0; i < count && success; i++) {
+        TraceFile_StoreRecord(data, records[i]);
+        success = fwrite(data, sizeof(data), 1, file) == 1;
+    }
+    return fclose(file) == 0 && success;
+}
+
+static bool IsEnabled() {
+    return gLaunchTraceRecorder.load(std::memory_order_relaxed) != nullptr;
+}
+
+// The LaunchTraceRecorder that is set while tracing is enabled.
+static void RecordPhase(RPXLoaderTracePhase phase, uint64_t begin, uint64_t end, RPXLoaderStatus status, const char *path) {
+    std::lock_guard<std::mutex> lock(sTraceMutex);
+    if (!IsEnabled()) {
+        return;
+    }
+    if (sLaunchId == 0) {
+        sLaunchId      = NewLaunchId();
+        sLaunchName[0] = '\0';
+    }
+    if (path != nullptr) {
+        SetLaunchName(path);
+    }
+
+    TraceRecord record   = {};
+    record.launchId      = sLaunchId;
+    record.phase         = phase;
+    record.source        = TRACE_SOURCE_LIB;
+    record.begin         = begin;
+    record.end           = end;
+    record.moduleVersion = GetModuleVersion();
+    record.status        = status;
+    memcpy(record.name, sLaunchName, sizeof(record.name));
+    if (!AppendRecords(&record, 1)) {
+        DEBUG_FUNCTION_LINE_WARN("Failed to write the launch trace %s", sTracePath);
+    }
+
+    if (phase == RPX_LOADER_TRACE_PHASE_LAUNCH_REQUESTED && status == RPX_LOADER_RESULT_SUCCESS) {
+        sLaunchId = 0;
+    }
+}
+
+/**
+ * Reads the header and all records of the trace file. Returns false if the file is not a trace file,
+ * a missing or empty file has no records.
+ */
+static bool ReadTraceFile(const char *path, bool *outExists, TraceHeader *outHeader, std::vector<TraceRecord> &outRecords) {
+    SDFile file;
+    *outExists = file.Open(path) && file.GetSize() > 0;
+    if (!*outExists) {
+        return true;
+    }
+    uint8_t data[TRACE_HEADER_SIZE];
+    auto &header = *outHeader;
+    if (!file.ReadAt(0, data, sizeof(data)) || !TraceFile_LoadHeader(data, &header)) {
+        return false;
+    }
+    auto count = (file.GetSize() - TRACE_HEADER_SIZE) / header.recordSize;
+    std::vector<uint8_t> records(count * header.recordSize);
+    if (count > 0 && !file.ReadAt(TRACE_HEADER_SIZE, records.data(), records.size())) {
+        return false;
+    }
+    outRecords.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        TraceFile_LoadRecord(&records[i * header.recordSize], &outRecords[i]);
+    }
+    return true;
+}
+
+RPXLoaderStatus RPXLoader_EnableLaunchTrace(const char *path) {
+    char fullPath[sizeof(sTracePath)];
+    if (path == nullptr || strlen(path) >= sizeof(sTracePath) || !SDFile_BuildPath(fullPath, sizeof(fullPath), path)) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(sTraceMutex);
+    bool exists = false;
+    TraceHeader header;
+    std::vector<TraceRecord> records;
+    if (!ReadTraceFile(path, &exists, &header, records)) {
+        DEBUG_FUNCTION_LINE_ERR("%s is not a launch trace", path);
+        return RPX_LOADER_RESULT_NOT_FOUND;
+    }
+    if (exists && !IsAppendable(header)) {
+        DEBUG_FUNCTION_LINE_ERR("%s has been written by another version of this lib", path);
+        return RPX_LOADER_RESULT_NOT_FOUND;
+    }
+    if (!exists) {
+        auto file = fopen(fullPath, "wb");
+        if (file == nullptr) {
+            DEBUG_FUNCTION_LINE_ERR("Failed to create the launch trace %s", path);
+            return RPX_LOADER_RESULT_NOT_FOUND;
+        }
+        uint8_t data[TRACE_HEADER_SIZE];
+        TraceFile_StoreHeader(data, {TRACE_FILE_MAGIC, TRACE_FILE_VERSION, TRACE_RECORD_SIZE, (uint32_t) OSTimerClockSpeed});
+        bool success = fwrite(data, sizeof(data), 1, file) == 1;
+        if (fclose(file) != 0 || !success) {
+            return RPX_LOADER_RESULT_NOT_FOUND;
+        }
+    }
+
+    strcpy(sTracePath, path);
+    sLaunchId = 0;
+    gLaunchTraceRecorder.store(RecordPhase, std::memory_order_relaxed);
+    return RPX_LOADER_RESULT_SUCCESS;
+}
+
+void RPXLoader_DisableLaunchTrace() {
+    std::lock_guard<std::mutex> lock(sTraceMutex);
+    gLaunchTraceRecorder.store(nullptr, std::memory_order_relaxed);
+    sLaunchId = 0;
+}
+
+RPXLoaderStatus RPXLoader_CollectLaunchTrace(uint32_t *outWritten) {
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_COLLECT_LAUNCH_TRACE, [&]() -> RPXLoaderStatus {
+        if (outWritten != nullptr) {
+            *outWritten = 0;
+        }
+        RPXLoaderStatus (*func)(RPXLoaderTraceSpan *, uint32_t);
+        if (auto res = GetExportFunction(RL_EXPORT_GET_LAUNCH_TIMELINE, &func); res != RPX_LOADER_RESULT_SUCCESS) {
+            return res;
+        }
+
+        std::lock_guard<std::mutex> lock(sTraceMutex);
+        if (!IsEnabled()) {
+            return RPX_LOADER_RESULT_NOT_AVAILABLE;
+        }
+        bool exists = false;
+        TraceHeader header;
+        std::vector<TraceRecord> records;
+        if (!ReadTraceFile(sTracePath, &exists, &header, records)) {
+            return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+        }
+
+        // The last successful launch request and the module phases that have already been collected for it.
+        const TraceRecord *launch = nullptr;
+        uint32_t collected        = 0;
+        for (auto &record : records) {
+            // Phases of a newer lib version or a damaged file.
+            if (record.phase >= RPX_LOADER_TRACE_PHASE_COUNT) {
+                continue;
+            }
+            if (record.phase == RPX_LOADER_TRACE_PHASE_LAUNCH_REQUESTED && record.status == RPX_LOADER_RESULT_SUCCESS) {
+                launch    = &record;
+                collected = 0;
+            } else if (launch != nullptr && record.launchId == launch->launchId && record.source == TRACE_SOURCE_MODULE) {
+                collected |= 1u << record.phase;
+            }
+        }
+        if (launch == nullptr) {
+            return RPX_LOADER_RESULT_NOT_FOUND;
+        }
+
+        RPXLoaderTraceSpan spans[RPX_LOADER_TRACE_PHASE_COUNT] = {};
+        if (auto res = func(spans, RPX_LOADER_TRACE_PHASE_COUNT); res != RPX_LOADER_RESULT_SUCCESS) {
+            return res;
+        }
+
+        TraceRecord newRecords[RPX_LOADER_TRACE_PHASE_COUNT];
+        uint32_t count = 0;
+        for (uint32_t phase = RPX_LOADER_TRACE_PHASE_WRAPPER_STARTED; phase < RPX_LOADER_TRACE_PHASE_COUNT; phase++) {
+            auto &span = spans[phase];
+            // Spans from before the request belong to an earlier launch that hasn't been traced.
+            if (span.begin == 0 || span.begin < launch->begin || (collected & (1u << phase)) != 0) {
+                continue;
+            }
+            auto &record         = newRecords[count++];
+            record               = {};
+            record.launchId      = launch->launchId;
+            record.phase         = phase;
+            record.source        = TRACE_SOURCE_MODULE;
+            record.begin         = span.begin;
+            record.end           = span.end >= span.begin ? span.end : span.begin;
+            record.moduleVersion = GetModuleVersion();
+            record.status        = RPX_LOADER_RESULT_SUCCESS;
+            memcpy(record.name, launch->name, sizeof(record.name));
+        }
+        if (count > 0 && !AppendRecords(newRecords, count)) {
+            DEBUG_FUNCTION_LINE_ERR("Failed to write the launch trace %s", sTracePath);
+            return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+        }
+        if (outWritten != nullptr) {
+            *outWritten = count;
+        }
+        return RPX_LOADER_RESULT_SUCCESS;
+    });
+}
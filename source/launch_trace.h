@@ -0,0 +1,38 @@
+#pragma once
+#include <atomic>
+#include <coreinit/time.h>
+#include <rpxloader/trace.h>
+
+/**
+ * Appends a phase of the current launch to the trace file, a new launch is started if there is none.
+ * A successful RPX_LOADER_TRACE_PHASE_LAUNCH_REQUESTED ends the current launch.
+ *
+ * @param path (optional) path of the launched file, its name is stored with this and all following phases of the launch
+ */
+using LaunchTraceRecorder = void (*)(RPXLoaderTracePhase phase, uint64_t begin, uint64_t end, RPXLoaderStatus status, const char *path);
+
+/**
+ * Set while tracing is enabled. Defined in rpxloader.cpp, the wrappers only reach the trace code through this pointer
+ * so apps that never enable tracing don't link it.
+ */
+extern std::atomic<LaunchTraceRecorder> gLaunchTraceRecorder;
+
+static inline bool LaunchTrace_IsEnabled() {
+    return gLaunchTraceRecorder.load(std::memory_order_relaxed) != nullptr;
+}
+
+/**
+ * Calls func and records its duration and result as the given phase if tracing is enabled.
+ * Otherwise this is nothing but the call of func.
+ */
+template<typename Func>
+static inline RPXLoaderStatus LaunchTrace_Measure(RPXLoaderTracePhase phase, const char *path, Func &&func) {
+    auto record = gLaunchTraceRecorder.load(std::memory_order_relaxed);
+    if (record == nullptr) {
+        return func();
+    }
+    auto begin = (uint64_t) OSGetTime();
+    auto res   = func();
+    record(phase, begin, (uint64_t) OSGetTime(), res, path);
+    return res;
+}
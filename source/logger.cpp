@@ -0,0 +1,110 @@
+#include "logger.h"
+#include <coreinit/time.h>
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+
+#define LOG_RING_MASK (RPX_LOADER_LOG_BUFFER_RECORDS - 1)
+static_assert((RPX_LOADER_LOG_BUFFER_RECORDS & LOG_RING_MASK) == 0, "RPX_LOADER_LOG_BUFFER_RECORDS has to be a power of two");
+
+std::atomic<uint32_t> gLogLevel{RPX_LOADER_LOG_LEVEL_WARN};
+
+// Zero initialized: every slot starts out writable at the ring position of its index.
+static LogSlot sSlots[RPX_LOADER_LOG_BUFFER_RECORDS];
+static std::atomic<uint32_t> sWritePosition{0};
+static std::atomic<uint32_t> sDropped{0};
+// Only the drain reads from the ring, writers never take this mutex.
+static std::mutex sDrainMutex;
+static uint32_t sReadPosition = 0;
+
+LogSlot *Log_Reserve() {
+    auto position = sWritePosition.load(std::memory_order_relaxed);
+    while (true) {
+        uint32_t index = position & LOG_RING_MASK;
+        auto &slot     = sSlots[index];
+        auto diff      = (int32_t) (slot.sequence.load(std::memory_order_acquire) + index - position);
+        if (diff == 0) {
+            if (sWritePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                slot.position = position;
+                return &slot;
+            }
+        } else if (diff < 0) {
+            // The slot still holds a record of the previous round, the ring is full.
+            sDropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            position = sWritePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Log_Commit(LogSlot *slot, const LogSite *site, LogFormatFunction formatArgs, uint32_t argsSize) {
+    slot->tick       = (uint32_t) OSGetSystemTick();
+    slot->site       = site;
+    slot->formatArgs = formatArgs;
+    slot->argsSize   = argsSize;
+    slot->sequence.store(slot->position + 1 - (uint32_t) (slot - sSlots), std::memory_order_release);
+}
+
+uint32_t Log_Format(char *out, uint32_t size, const char *fmt, ...) {
+    if (size == 0) {
+        return 0;
+    }
+    va_list va;
+    va_start(va, fmt);
+    auto length = vsnprintf(out, size, fmt, va);
+    va_end(va);
+    if (length < 0) {
+        out[0] = '\0';
+        return 0;
+    }
+    return (uint32_t) length < size ? (uint32_t) length : size - 1;
+}
+
+void RPXLoader_SetLogLevel(RPXLoaderLogLevel level) {
+    gLogLevel.store(level, std::memory_order_relaxed);
+}
+
+RPXLoaderLogLevel RPXLoader_GetLogLevel() {
+    return (RPXLoaderLogLevel) gLogLevel.load(std::memory_order_relaxed);
+}
+
+uint32_t RPXLoader_DrainLog(RPXLoaderLogSink sink, void *context) {
+    std::lock_guard<std::mutex> lock(sDrainMutex);
+    uint32_t count = 0;
+    char line[512];
+    while (true) {
+        uint32_t index = sReadPosition & LOG_RING_MASK;
+        auto &slot     = sSlots[index];
+        if (slot.sequence.load(std::memory_order_acquire) + index != sReadPosition + 1) {
+            break;
+        }
+        auto site = slot.site;
+        auto tick = slot.tick;
+        // Same layout the messages had when they were written via OSReport directly. Keeps room for the newline.
+        auto length = Log_Format(line, sizeof(line) - 1, "[(%s)%18s][%23s]%30s@L%04d: %s", LOG_APP_TYPE, LOG_APP_NAME, site->file, site->function, (int) site->line, site->levelPrefix);
+        length += slot.formatArgs(site->format, slot.args, line + length, sizeof(line) - 1 - length);
+        line[length++] = '\n';
+        line[length]   = '\0';
+
+        // Hands the slot back to the writers of the next round.
+        slot.sequence.store(sReadPosition + RPX_LOADER_LOG_BUFFER_RECORDS - index, std::memory_order_release);
+        sReadPosition++;
+
+        if (sink != nullptr) {
+            sink(site->level, tick, line, context);
+        } else {
+            OSReport("%s", line);
+        }
+        count++;
+    }
+    return count;
+}
+
+uint32_t RPXLoader_FlushLog() {
+    return RPXLoader_DrainLog(nullptr, nullptr);
+}
+
+uint32_t RPXLoader_GetDroppedLogCount() {
+    return sDropped.load(std::memory_order_relaxed);
+}
@@ -1,23 +1,172 @@
 #pragma once
+
+#include <atomic>
 #include <coreinit/debug.h>
+#include <cstdint>
 #include <cstring>
-
-#define __FILENAME__ ({                                \
-    const char *__filename = __FILE__;                 \
-    const char *__pos      = strrchr(__filename, '/'); \
-    if (!__pos) __pos = strrchr(__filename, '\\');     \
-    __pos ? __pos + 1 : __filename;                    \
-})
+#include <rpxloader/log.h>
+#include <tuple>
+#include <type_traits>
 
 #define LOG_APP_TYPE "L"
 #define LOG_APP_NAME "librpxloader"
 
-#define LOG_EX(FILENAME, FUNCTION, LINE, LOG_FUNC, LOG_LEVEL, LINE_END, FMT, ARGS...)                                                        \
-    do {                                                                                                                                     \
-        LOG_FUNC("[(%s)%18s][%23s]%30s@L%04d: " LOG_LEVEL "" FMT "" LINE_END, LOG_APP_TYPE, LOG_APP_NAME, FILENAME, FUNCTION, LINE, ##ARGS); \
+// Space for the arguments of one message. Strings are truncated to fit.
+#define LOG_ARGS_SIZE 96
+
+typedef uint32_t (*LogFormatFunction)(const char *fmt, const uint8_t *args, char *out, uint32_t size);
+
+/**
+ * Everything about a log statement that is known at compile time. Its address identifies the message in a record.
+ */
+struct LogSite {
+    RPXLoaderLogLevel level;
+    const char *levelPrefix;
+    const char *file;
+    const char *function;
+    uint32_t line;
+    const char *format;
+};
+
+struct LogSlot {
+    // The slot can be written at ring position (sequence + index) and read at ring position (sequence + index - 1).
+    std::atomic<uint32_t> sequence;
+    uint32_t position;
+    uint32_t tick;
+    uint32_t argsSize;
+    const LogSite *site;
+    LogFormatFunction formatArgs;
+    uint8_t args[LOG_ARGS_SIZE];
+};
+
+extern std::atomic<uint32_t> gLogLevel;
+
+/**
+ * Claims the next free slot of the ring buffer, returns nullptr (and counts the message as dropped) if it is full.
+ */
+LogSlot *Log_Reserve();
+
+void Log_Commit(LogSlot *slot, const LogSite *site, LogFormatFunction formatArgs, uint32_t argsSize);
+
+/**
+ * vsnprintf that returns the number of characters that have actually been written to out.
+ */
+uint32_t Log_Format(char *out, uint32_t size, const char *fmt, ...);
+
+// Never called, only lets the compiler check the format string against the arguments.
+static inline void Log_CheckFormat(const char *, ...) __attribute__((format(printf, 1, 2)));
+static inline void Log_CheckFormat(const char *, ...) {}
+
+constexpr const char *Log_FileName(const char *path) {
+    auto name = path;
+    for (auto cur = path; *cur != '\0'; cur++) {
+        if (*cur == '/' || *cur == '\\') {
+            name = cur + 1;
+        }
+    }
+    return name;
+}
+
+/**
+ * Type an argument is stored as: strings are copied, other pointers are stored as address and
+ * numbers with the type printf receives them as.
+ */
+template<typename T>
+using LogArg = std::conditional_t<std::is_same_v<std::decay_t<T>, char *> || std::is_same_v<std::decay_t<T>, const char *>, const char *,
+                                  std::conditional_t<std::is_pointer_v<std::decay_t<T>>, const void *,
+                                                      std::conditional_t<std::is_floating_point_v<T>, double, decltype(+std::declval<T>())>>>;
+
+template<typename... Args>
+constexpr uint32_t Log_StringBudget() {
+    constexpr uint32_t strings   = (0 + ... + (std::is_same_v<Args, const char *> ? 1 : 0));
+    constexpr uint32_t fixedSize = (0 + ... + (std::is_same_v<Args, const char *> ? 0 : sizeof(Args)));
+    static_assert(fixedSize + strings * 8 <= LOG_ARGS_SIZE, "Too many arguments for a log message");
+    return strings > 0 ? (LOG_ARGS_SIZE - fixedSize) / strings : 0;
+}
+
+struct LogArgWriter {
+    uint8_t *data;
+    uint32_t stringBudget;
+    uint32_t size = 0;
+
+    template<typename T>
+    void Write(T value) {
+        memcpy(data + size, &value, sizeof(T));
+        size += sizeof(T);
+    }
+
+    void Write(const char *value) {
+        uint32_t length = value != nullptr ? strnlen(value, stringBudget - 1) : 0;
+        memcpy(data + size, value, length);
+        data[size + length] = '\0';
+        size += length + 1;
+    }
+};
+
+struct LogArgReader {
+    const uint8_t *data;
+
+    template<typename T>
+    T Read() {
+        T value;
+        memcpy(&value, data, sizeof(T));
+        data += sizeof(T);
+        return value;
+    }
+};
+
+template<>
+inline const char *LogArgReader::Read<const char *>() {
+    auto value = (const char *) data;
+    data += strlen(value) + 1;
+    return value;
+}
+
+template<typename... Args>
+uint32_t Log_FormatArgs(const char *fmt, const uint8_t *args, char *out, uint32_t size) {
+    [[maybe_unused]] LogArgReader reader{args};
+    // Braced initialization reads the arguments from left to right.
+    std::tuple<Args...> values{reader.Read<Args>()...};
+    return std::apply([&](Args... values) { return Log_Format(out, size, fmt, values...); }, values);
+}
+
+template<typename... Args>
+inline void Log_Write(const LogSite &site, Args... args) {
+    auto slot = Log_Reserve();
+    if (slot == nullptr) {
+        return;
+    }
+    [[maybe_unused]] LogArgWriter writer{slot->args, Log_StringBudget<LogArg<Args>...>()};
+    (writer.Write((LogArg<Args>) args), ...);
+    Log_Commit(slot, &site, &Log_FormatArgs<LogArg<Args>...>, writer.size);
+}
+
+/**
+ * Function name of the log sites that aren't inside a LOG_FUNCTION_NAME() scope.
+ */
+static constexpr const char *sLogFunctionName = nullptr;
+
+/**
+ * Inside a lambda __FUNCTION__ is "operator()". Functions whose body is a lambda (e.g. via Stats_Measure) use this so
+ * the log sites inside it report the name of the function instead.
+ */
+#define LOG_FUNCTION_NAME() [[maybe_unused]] static constexpr const char *sLogFunctionName = __FUNCTION__
+
+/**
+ * Records a message in the log ring buffer, see <rpxloader/log.h>. The arguments are only evaluated if the level is enabled.
+ */
+#define LOG_DEFERRED(LEVEL, LEVEL_PREFIX, FMT, ARGS...)                                                                          \
+    do {                                                                                                                         \
+        if (gLogLevel.load(std::memory_order_relaxed) >= LEVEL) {                                                                \
+            static constexpr LogSite __logSite = {LEVEL, LEVEL_PREFIX, Log_FileName(__FILE__),                                   \
+                                                  sLogFunctionName != nullptr ? sLogFunctionName : __FUNCTION__, __LINE__, FMT}; \
+            Log_Write(__logSite, ##ARGS);                                                                                        \
+        }                                                                                                                        \
+        if (false) {                                                                                                             \
+            Log_CheckFormat(FMT, ##ARGS);                                                                                        \
+        }                                                                                                                        \
     } while (0)
 
-#define LOG_EX_DEFAULT(LOG_FUNC, LOG_LEVEL, LINE_END, FMT, ARGS...) LOG_EX(__FILENAME__, __FUNCTION__, __LINE__, LOG_FUNC, LOG_LEVEL, LINE_END, FMT, ##ARGS)
+#define DEBUG_FUNCTION_LINE_ERR(FMT, ARGS...)  LOG_DEFERRED(RPX_LOADER_LOG_LEVEL_ERROR, "##ERROR## ", FMT, ##ARGS)
 
-#define DEBUG_FUNCTION_LINE_ERR(FMT, ARGS...)                       LOG_EX_DEFAULT(OSReport, "##ERROR## ", "\n", FMT, ##ARGS)
-#define DEBUG_FUNCTION_LINE_WARN(FMT, ARGS...)                      LOG_EX_DEFAULT(OSReport, "##WARNING## ", "\n", FMT, ##ARGS)
+#define DEBUG_FUNCTION_LINE_WARN(FMT, ARGS...) LOG_DEFERRED(RPX_LOADER_LOG_LEVEL_WARN, "##WARNING## ", FMT, ##ARGS)
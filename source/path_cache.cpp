@@ -0,0 +1,141 @@
+#include "path_cache.h"
+#include "dispatch.h"
+#include "logger.h"
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+/**
+ * Everything but the generation is immutable once the entry has been published. An entry is only freed by
+ * PathCache_Shutdown, so a path handed out earlier stays valid even if the cache has been refilled since.
+ */
+struct PathCacheEntry {
+    std::atomic<uint32_t> generation;
+    RPXLoaderStatus status;
+    uint32_t length;
+    char *path;
+    PathCacheEntry *previous;
+};
+
+/**
+ * Readers only load "current" and compare its generation, they never lock. Refills are serialized. If the module
+ * returns the same path as before, the current entry is just marked as up-to-date, otherwise a new entry is published.
+ */
+struct PathCache {
+    std::mutex refillMutex;
+    std::atomic<PathCacheEntry *> current{nullptr};
+};
+
+using PathGetter = decltype(&RPXLoader_GetPathOfRunningExecutable);
+
+static constexpr RPXLoaderExportSlot sPathCacheExports[RL_PATH_COUNT] = {
+        RL_EXPORT_GET_PATH_OF_RUNNING_EXECUTABLE,
+        RL_EXPORT_GET_PATH_OF_SAVE_REDIRECTION,
+};
+
+// Entries are valid only if their generation matches. Starts at 1 so new entries are never valid by accident.
+static std::atomic<uint32_t> sGeneration{1};
+static PathCache sPathCaches[RL_PATH_COUNT];
+
+void PathCache_Invalidate() {
+    sGeneration.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void PathCache_Shutdown() {
+    PathCache_Invalidate();
+    for (auto &cache : sPathCaches) {
+        std::lock_guard<std::mutex> lock(cache.refillMutex);
+        auto entry = cache.current.exchange(nullptr, std::memory_order_acq_rel);
+        while (entry != nullptr) {
+            auto previous = entry->previous;
+            delete[] entry->path;
+            delete entry;
+            entry = previous;
+        }
+    }
+}
+
+/**
+ * The module truncates paths that don't fit into the buffer, so the buffer is grown until the path doesn't fill it
+ * completely.
+ */
+static RPXLoaderStatus QueryPath(PathGetter func, char **outPath, uint32_t *outLength) {
+    for (uint32_t size = RPX_LOADER_PATH_CACHE_SIZE; size <= RPX_LOADER_PATH_CACHE_MAX_SIZE; size *= 2) {
+        auto buffer = new (std::nothrow) char[size];
+        if (buffer == nullptr) {
+            return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+        }
+        buffer[0] = '\0';
+        auto res  = func(buffer, size);
+        if (res != RPX_LOADER_RESULT_SUCCESS) {
+            delete[] buffer;
+            return res;
+        }
+        buffer[size - 1] = '\0';
+        auto length      = strlen(buffer);
+        if (length < size - 1) {
+            *outPath   = buffer;
+            *outLength = length;
+            return RPX_LOADER_RESULT_SUCCESS;
+        }
+        delete[] buffer;
+    }
+    DEBUG_FUNCTION_LINE_ERR("The path is longer than %d bytes.", RPX_LOADER_PATH_CACHE_MAX_SIZE - 1);
+    return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+}
+
+static RPXLoaderStatus RefillPathCache(RPXLoaderPathKind kind, uint32_t generation, PathCacheEntry **outEntry) {
+    PathGetter func;
+    if (auto res = GetExportFunction(sPathCacheExports[kind], &func); res != RPX_LOADER_RESULT_SUCCESS) {
+        return res;
+    }
+
+    auto &cache = sPathCaches[kind];
+    std::lock_guard<std::mutex> lock(cache.refillMutex);
+    auto current = cache.current.load(std::memory_order_relaxed);
+    if (current != nullptr && current->generation.load(std::memory_order_relaxed) == generation) {
+        *outEntry = current;
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+
+    char *path      = nullptr;
+    uint32_t length = 0;
+    auto res        = QueryPath(func, &path, &length);
+    if (res != RPX_LOADER_RESULT_SUCCESS && res != RPX_LOADER_RESULT_NOT_AVAILABLE) {
+        return res;
+    }
+    // If the cache was invalidated while the module was queried, the entry is already outdated and will be refilled on the next call.
+    if (current != nullptr && current->status == res && (res != RPX_LOADER_RESULT_SUCCESS || (current->length == length && memcmp(current->path, path, length) == 0))) {
+        delete[] path;
+        current->generation.store(generation, std::memory_order_release);
+        *outEntry = current;
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+
+    auto entry = new (std::nothrow) PathCacheEntry{{generation}, res, length, path, current};
+    if (entry == nullptr) {
+        delete[] path;
+        return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+    }
+    cache.current.store(entry, std::memory_order_release);
+
+    *outEntry = entry;
+    return RPX_LOADER_RESULT_SUCCESS;
+}
+
+RPXLoaderStatus PathCache_Get(RPXLoaderPathKind kind, const char **outPath, uint32_t *outLength) {
+    auto generation = sGeneration.load(std::memory_order_acquire);
+    auto entry      = sPathCaches[kind].current.load(std::memory_order_acquire);
+    if (entry == nullptr || entry->generation.load(std::memory_order_acquire) != generation) {
+        if (auto res = RefillPathCache(kind, generation, &entry); res != RPX_LOADER_RESULT_SUCCESS) {
+            return res;
+        }
+    }
+    if (entry->status != RPX_LOADER_RESULT_SUCCESS) {
+        return entry->status;
+    }
+    *outPath   = entry->path;
+    *outLength = entry->length;
+    return RPX_LOADER_RESULT_SUCCESS;
+}
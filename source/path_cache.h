@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <rpxloader/rpxloader.h>
+
+// Initial size of the buffer a path is queried into, it's doubled up to the max size if the path doesn't fit.
+#define RPX_LOADER_PATH_CACHE_SIZE     0x200
+#define RPX_LOADER_PATH_CACHE_MAX_SIZE 0x1000
+
+enum RPXLoaderPathKind {
+    RL_PATH_RUNNING_EXECUTABLE,
+    RL_PATH_SAVE_REDIRECTION,
+    RL_PATH_COUNT,
+};
+
+/**
+ * Drops all cached paths. Has to be called after every call into the module that may change them.
+ */
+void PathCache_Invalidate();
+
+/**
+ * Frees all cached paths, must not be called while other threads may use them.
+ */
+void PathCache_Shutdown();
+
+/**
+ * Returns the cached path, the module is only queried if the cache is empty or outdated.
+ * RPX_LOADER_RESULT_NOT_AVAILABLE is cached as well. Paths that don't fit into RPX_LOADER_PATH_CACHE_MAX_SIZE
+ * return RPX_LOADER_RESULT_UNKNOWN_ERROR instead of being truncated.<br>
+ * <br>
+ * outPath stays valid (and unchanged) until PathCache_Shutdown, even if the cache has been invalidated since.
+ */
+RPXLoaderStatus PathCache_Get(RPXLoaderPathKind kind, const char **outPath, uint32_t *outLength);
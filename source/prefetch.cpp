@@ -0,0 +1,155 @@
+#include "bundle_internal.h"
+#include "dispatch.h"
+#include "logger.h"
+#include "stats.h"
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <rpxloader/prefetch.h>
+#include <vector>
+
+static uint64_t GetGap(const RPXLoaderPrefetchRange &first, const RPXLoaderPrefetchRange &second) {
+    auto end = first.offset + first.size;
+    return second.offset > end ? second.offset - end : 0;
+}
+
+namespace {
+    /**
+     * Collects the ranges that should be prefetched. They are kept sorted by offset and close ones are merged right
+     * away, so the budget covers what is really read: merged gaps count against it, overlapping files and hints only
+     * once. Files and hints that don't fit into the budget or RPX_LOADER_PREFETCH_MAX_RANGES anymore are skipped, so
+     * earlier ones take precedence.
+     */
+    struct PrefetchPlan {
+        std::vector<RPXLoaderPrefetchRange> ranges;
+        RPXLoaderPrefetchStats stats{};
+        uint64_t budget;
+        uint64_t fileBytes = 0;
+
+        // The tables are needed for every lookup, they are always included and don't count against the budget.
+        void AddMetadata(uint64_t offset, uint64_t size) {
+            uint64_t added;
+            Insert({offset, size}, UINT64_MAX, &added);
+        }
+
+        void AddFile(RPXLoaderStatus findResult, const RPXLoaderBundleFileInfo &info, uint64_t offset, uint64_t length) {
+            if (findResult != RPX_LOADER_RESULT_SUCCESS || offset > info.size) {
+                stats.missing++;
+                return;
+            }
+            if (length == 0 || length > info.size - offset) {
+                length = info.size - offset;
+            }
+            uint64_t added = 0;
+            if (length > 0 && !Insert({info.offset + offset, length}, budget - fileBytes, &added)) {
+                stats.skipped++;
+                return;
+            }
+            fileBytes += added;
+            stats.files++;
+        }
+
+        /**
+         * Merges the range with all ranges that overlap it or are at most RPX_LOADER_PREFETCH_MERGE_GAP away. Nothing
+         * is changed if that would read more than maxAdded additional bytes or exceed RPX_LOADER_PREFETCH_MAX_RANGES.
+         */
+        bool Insert(RPXLoaderPrefetchRange range, uint64_t maxAdded, uint64_t *outAdded) {
+            // The ranges don't overlap, so their ends are sorted as well.
+            auto first = std::lower_bound(ranges.begin(), ranges.end(), range, [](const RPXLoaderPrefetchRange &existing, const RPXLoaderPrefetchRange &value) {
+                return GetGap(existing, value) > RPX_LOADER_PREFETCH_MERGE_GAP;
+            });
+            auto last         = first;
+            uint64_t start    = range.offset;
+            uint64_t end      = range.offset + range.size;
+            uint64_t existing = 0;
+            for (; last != ranges.end() && GetGap(range, *last) <= RPX_LOADER_PREFETCH_MERGE_GAP; ++last) {
+                start = std::min(start, last->offset);
+                end   = std::max(end, last->offset + last->size);
+                existing += last->size;
+            }
+            *outAdded = end - start - existing;
+            if (*outAdded > maxAdded || (first == last && ranges.size() >= RPX_LOADER_PREFETCH_MAX_RANGES)) {
+                return false;
+            }
+            if (first == last) {
+                ranges.insert(first, {start, end - start});
+            } else {
+                *first = {start, end - start};
+                ranges.erase(first + 1, last);
+            }
+            return true;
+        }
+    };
+} // namespace
+
+/**
+ * Resolves the hot files and hints to ranges of the bundle and adds them to the plan.
+ */
+static RPXLoaderStatus BuildPlan(const char *bundlePath, const RPXLoaderPrefetchOptions *options, PrefetchPlan &plan) {
+    RPXLoaderBundle *openedBundle = nullptr;
+    if (auto res = RPXLoader_BundleOpen(bundlePath, &openedBundle); res != RPX_LOADER_RESULT_SUCCESS) {
+        return res;
+    }
+    std::unique_ptr<RPXLoaderBundle, decltype(&RPXLoader_BundleClose)> bundle(openedBundle, &RPXLoader_BundleClose);
+    // Insert never exceeds the limit, so this is the only allocation of the plan.
+    plan.ranges.reserve(RPX_LOADER_PREFETCH_MAX_RANGES);
+
+    BundleRange metadata[BUNDLE_METADATA_RANGES];
+    auto metadataCount = Bundle_GetMetadataRanges(bundle.get(), metadata);
+    for (uint32_t i = 0; i < metadataCount; i++) {
+        if (metadata[i].size > 0) {
+            plan.AddMetadata(metadata[i].offset, metadata[i].size);
+        }
+    }
+
+    RPXLoaderBundleFileInfo info;
+    if (options != nullptr && options->hotFiles != nullptr) {
+        for (uint32_t i = 0; i < options->hotFileCount; i++) {
+            auto res = options->hotFiles[i] != nullptr ? RPXLoader_BundleFindFile(bundle.get(), options->hotFiles[i], &info) : RPX_LOADER_RESULT_NOT_FOUND;
+            plan.AddFile(res, info, 0, 0);
+        }
+    }
+    if (options != nullptr && options->hints != nullptr) {
+        for (uint32_t i = 0; i < options->hintCount; i++) {
+            auto &hint = options->hints[i];
+            plan.AddFile(RPXLoader_BundleFindFileByHash(bundle.get(), hint.pathHash, &info), info, hint.offset, hint.length);
+        }
+    }
+    return RPX_LOADER_RESULT_SUCCESS;
+}
+
+RPXLoaderStatus RPXLoader_PrefetchBundle(const char *bundlePath, const RPXLoaderPrefetchOptions *options, RPXLoaderPrefetchStats *outStats) {
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_PREFETCH_BUNDLE, [&]() -> RPXLoaderStatus {
+        RPXLoaderStatus (*func)(const char *, const RPXLoaderPrefetchRange *, uint32_t);
+        // Checked first, building the plan is pointless if the module can't use it.
+        if (auto res = GetExportFunction(RL_EXPORT_PREFETCH_BUNDLE, &func); res != RPX_LOADER_RESULT_SUCCESS) {
+            return res;
+        }
+        if (bundlePath == nullptr) {
+            return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+        }
+
+        PrefetchPlan plan;
+        plan.budget = options != nullptr && options->maxBytes != 0 ? options->maxBytes : RPX_LOADER_PREFETCH_DEFAULT_BUDGET;
+        // The plan throws if the memory runs out, that must not leave this C function.
+        try {
+            if (auto res = BuildPlan(bundlePath, options, plan); res != RPX_LOADER_RESULT_SUCCESS) {
+                return res;
+            }
+        } catch (const std::bad_alloc &) {
+            DEBUG_FUNCTION_LINE_ERR("Out of memory while planning the prefetch of %s", bundlePath);
+            return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+        }
+
+        plan.stats.ranges = plan.ranges.size();
+        for (auto &range : plan.ranges) {
+            plan.stats.bytes += range.size;
+        }
+        auto res = func(bundlePath, plan.ranges.data(), plan.ranges.size());
+        if (res == RPX_LOADER_RESULT_SUCCESS && outStats != nullptr) {
+            *outStats = plan.stats;
+        }
+        return res;
+    });
+}
@@ -0,0 +1,452 @@
+#include "byte_order.h"
+#include "romfs.h"
+#include "sd_file.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <rpxloader/preflight.h>
+#include <vector>
+#include <zlib.h>
+
+#define ELF_HEADER_SIZE         0x34
+#define ELF_SECTION_HEADER_SIZE 0x28
+#define ELF_TYPE_RPL            0xFE01
+#define ELF_MACHINE_PPC         0x14
+#define ELF_OSABI_CAFE          0xCA
+#define ELF_ABIVERSION_CAFE     0xFE
+
+#define SHT_NULL         0x00000000
+#define SHT_NOBITS       0x00000008
+#define SHT_RPL_CRCS     0x80000003
+#define SHT_RPL_FILEINFO 0x80000004
+#define SHF_RPL_ZLIB     0x08000000
+
+static const uint8_t sElfMagic[] = {0x7F, 'E', 'L', 'F'};
+
+struct PreflightContext {
+    SDFile file;
+    RPXLoaderPreflightMode mode;
+    RPXLoaderPreflightProgressCallback callback;
+    void *callbackContext;
+    RPXLoaderPreflightResult *result;
+    uint64_t bytesTotal = 0;
+    bool outOfMemory    = false;
+    std::unique_ptr<uint8_t, decltype(&free)> chunk{nullptr, &free};
+    std::unique_ptr<uint8_t, decltype(&free)> inflateBuffer{nullptr, &free};
+
+    bool Fail(RPXLoaderPreflightError error, uint32_t index, uint64_t offset) {
+        result->error  = error;
+        result->index  = index;
+        result->offset = offset;
+        return false;
+    }
+
+    bool Read(uint64_t offset, void *buffer, uint32_t size, uint32_t index = RPX_LOADER_PREFLIGHT_NO_INDEX) {
+        if (offset > file.GetSize() || size > file.GetSize() - offset) {
+            return Fail(RPX_LOADER_PREFLIGHT_TRUNCATED, index, offset);
+        }
+        if (!file.ReadAt(offset, buffer, size)) {
+            return Fail(RPX_LOADER_PREFLIGHT_IO_ERROR, index, offset);
+        }
+        result->bytesRead += size;
+        return true;
+    }
+
+    bool ReportProgress() {
+        if (callback != nullptr && !callback(result->bytesRead, bytesTotal, callbackContext)) {
+            return Fail(RPX_LOADER_PREFLIGHT_CANCELLED, RPX_LOADER_PREFLIGHT_NO_INDEX, result->bytesRead);
+        }
+        return true;
+    }
+
+    bool AllocChunkBuffers(bool needInflateBuffer) {
+        chunk.reset((uint8_t *) SDFile_AllocBuffer(RPX_LOADER_IO_CHUNK_SIZE));
+        if (needInflateBuffer) {
+            inflateBuffer.reset((uint8_t *) malloc(RPX_LOADER_IO_CHUNK_SIZE));
+        }
+        outOfMemory = !chunk || (needInflateBuffer && !inflateBuffer);
+        return !outOfMemory;
+    }
+};
+
+struct RPLSection {
+    uint32_t index;
+    uint32_t type;
+    uint32_t flags;
+    uint32_t offset;
+    uint32_t size;
+};
+
+static bool HasFileData(const RPLSection &section) {
+    return section.type != SHT_NULL && section.type != SHT_NOBITS && section.size != 0;
+}
+
+static bool CheckSectionData(PreflightContext &ctx, const RPLSection &section, uint32_t expectedCRC) {
+    bool compressed = (section.flags & SHF_RPL_ZLIB) != 0;
+    uLong crc       = crc32(0, Z_NULL, 0);
+
+    z_stream stream{};
+    if (compressed && inflateInit(&stream) != Z_OK) {
+        return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_SECTION_DATA, section.index, section.offset);
+    }
+    // Make sure the zlib state is freed on every return path.
+    std::unique_ptr<z_stream, decltype(&inflateEnd)> streamGuard(compressed ? &stream : nullptr, &inflateEnd);
+
+    uint32_t inflatedSize = 0;
+    bool streamEnd        = false;
+    for (uint32_t pos = 0; pos < section.size;) {
+        uint32_t chunkSize = std::min<uint32_t>(RPX_LOADER_IO_CHUNK_SIZE, section.size - pos);
+        if (!ctx.Read(section.offset + pos, ctx.chunk.get(), chunkSize, section.index)) {
+            return false;
+        }
+        uint8_t *data = ctx.chunk.get();
+        uint32_t size = chunkSize;
+        if (!compressed) {
+            crc = crc32(crc, data, size);
+        } else {
+            if (pos == 0) {
+                // Compressed sections start with the size of the inflated data.
+                inflatedSize = LoadBE32(data);
+                data += 4;
+                size -= 4;
+            }
+            stream.next_in  = data;
+            stream.avail_in = size;
+            while (!streamEnd && (stream.avail_in > 0 || stream.avail_out == 0)) {
+                stream.next_out  = ctx.inflateBuffer.get();
+                stream.avail_out = RPX_LOADER_IO_CHUNK_SIZE;
+                auto res         = inflate(&stream, Z_NO_FLUSH);
+                if (res == Z_STREAM_END) {
+                    streamEnd = true;
+                } else if (res == Z_BUF_ERROR && stream.avail_in == 0) {
+                    // Output was flushed completely, needs the next chunk.
+                    break;
+                } else if (res != Z_OK) {
+                    return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_SECTION_DATA, section.index, section.offset + pos);
+                }
+                crc = crc32(crc, ctx.inflateBuffer.get(), RPX_LOADER_IO_CHUNK_SIZE - stream.avail_out);
+            }
+        }
+        pos += chunkSize;
+        if (!ctx.ReportProgress()) {
+            return false;
+        }
+    }
+
+    if (compressed && (!streamEnd || stream.total_out != inflatedSize)) {
+        return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_SECTION_DATA, section.index, section.offset);
+    }
+    if ((uint32_t) crc != expectedCRC) {
+        return ctx.Fail(RPX_LOADER_PREFLIGHT_CRC_MISMATCH, section.index, section.offset);
+    }
+    return true;
+}
+
+static bool CheckRPX(PreflightContext &ctx) {
+    uint8_t header[ELF_HEADER_SIZE];
+    if (!ctx.Read(0, header, sizeof(header))) {
+        return false;
+    }
+    if (header[4] != 1 /* 32 bit */ || header[5] != 2 /* big endian */ || header[6] != 1 || header[7] != ELF_OSABI_CAFE || header[8] != ELF_ABIVERSION_CAFE ||
+        LoadBE16(header + 0x10) != ELF_TYPE_RPL || LoadBE16(header + 0x12) != ELF_MACHINE_PPC || LoadBE32(header + 0x14) != 1) {
+        return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_HEADER, RPX_LOADER_PREFLIGHT_NO_INDEX, 0);
+    }
+
+    uint32_t shoff     = LoadBE32(header + 0x20);
+    uint16_t shentsize = LoadBE16(header + 0x2E);
+    uint16_t shnum     = LoadBE16(header + 0x30);
+    uint16_t shstrndx  = LoadBE16(header + 0x32);
+    if (shentsize != ELF_SECTION_HEADER_SIZE || shnum == 0 || shstrndx >= shnum) {
+        return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_HEADER, RPX_LOADER_PREFLIGHT_NO_INDEX, 0);
+    }
+
+    // shnum is 16 bit, so the section table, the sections and the CRCs are at most 2.5 MiB. Still, nothing is allocated
+    // for a table that doesn't even fit into the file.
+    if ((uint64_t) shoff + (uint64_t) shnum * ELF_SECTION_HEADER_SIZE > ctx.file.GetSize()) {
+        return ctx.Fail(RPX_LOADER_PREFLIGHT_TRUNCATED, RPX_LOADER_PREFLIGHT_NO_INDEX, shoff);
+    }
+    std::vector<uint8_t> sectionTable((size_t) shnum * ELF_SECTION_HEADER_SIZE);
+    if (!ctx.Read(shoff, sectionTable.data(), sectionTable.size())) {
+        return false;
+    }
+
+    std::vector<RPLSection> sections(shnum);
+    uint32_t crcIndex      = RPX_LOADER_PREFLIGHT_NO_INDEX;
+    uint32_t fileInfoIndex = RPX_LOADER_PREFLIGHT_NO_INDEX;
+    for (uint32_t i = 0; i < shnum; i++) {
+        auto entry       = sectionTable.data() + i * ELF_SECTION_HEADER_SIZE;
+        auto &section    = sections[i];
+        section.index    = i;
+        section.type     = LoadBE32(entry + 0x04);
+        section.flags    = LoadBE32(entry + 0x08);
+        section.offset   = LoadBE32(entry + 0x10);
+        section.size     = LoadBE32(entry + 0x14);
+        uint64_t fileEnd = (uint64_t) section.offset + section.size;
+        if (HasFileData(section) && fileEnd > ctx.file.GetSize()) {
+            return ctx.Fail(RPX_LOADER_PREFLIGHT_TRUNCATED, i, section.offset);
+        }
+        if (HasFileData(section) && (section.flags & SHF_RPL_ZLIB) && section.size < 4) {
+            return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_SECTION_TABLE, i, shoff + i * ELF_SECTION_HEADER_SIZE);
+        }
+        if (section.type == SHT_RPL_CRCS) {
+            crcIndex = i;
+        } else if (section.type == SHT_RPL_FILEINFO) {
+            fileInfoIndex = i;
+        }
+    }
+
+    if (crcIndex == RPX_LOADER_PREFLIGHT_NO_INDEX || fileInfoIndex == RPX_LOADER_PREFLIGHT_NO_INDEX) {
+        return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_SECTION_TABLE, RPX_LOADER_PREFLIGHT_NO_INDEX, shoff);
+    }
+    auto &crcSection = sections[crcIndex];
+    if (crcSection.size != shnum * 4u || (crcSection.flags & SHF_RPL_ZLIB)) {
+        return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_SECTION_TABLE, crcIndex, shoff + crcIndex * ELF_SECTION_HEADER_SIZE);
+    }
+    std::vector<uint8_t> crcs(crcSection.size);
+    if (!ctx.Read(crcSection.offset, crcs.data(), crcs.size(), crcIndex)) {
+        return false;
+    }
+
+    if (ctx.mode == RPX_LOADER_PREFLIGHT_MODE_HEADERS_ONLY) {
+        ctx.bytesTotal = ctx.result->bytesRead;
+        return ctx.ReportProgress();
+    }
+
+    // Read the sections in the order they are stored in the file to keep the reads sequential.
+    std::vector<RPLSection> dataSections;
+    ctx.bytesTotal = ctx.result->bytesRead;
+    for (auto &section : sections) {
+        if (HasFileData(section) && section.index != crcIndex) {
+            dataSections.push_back(section);
+            ctx.bytesTotal += section.size;
+        }
+    }
+    std::sort(dataSections.begin(), dataSections.end(), [](const RPLSection &a, const RPLSection &b) { return a.offset < b.offset; });
+
+    if (!ctx.AllocChunkBuffers(true)) {
+        return false;
+    }
+    for (auto &section : dataSections) {
+        if (!CheckSectionData(ctx, section, LoadBE32(crcs.data() + section.index * 4))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool IsTableReference(const std::vector<bool> &entryStarts, uint32_t offset) {
+    return offset % 4 == 0 && offset / 4 < entryStarts.size() && entryStarts[offset / 4];
+}
+
+static bool IsOptionalTableReference(const std::vector<bool> &entryStarts, uint32_t offset) {
+    return offset == ROMFS_ENTRY_EMPTY || IsTableReference(entryStarts, offset);
+}
+
+static bool IsInHashChain(const std::vector<uint8_t> &hashTable, uint32_t bucket, uint32_t offset, uint32_t maxEntries, uint32_t (*getNext)(const std::vector<uint8_t> &, uint32_t), const std::vector<uint8_t> &table) {
+    uint32_t cur = LoadBE32(hashTable.data() + bucket * 4);
+    for (uint32_t steps = 0; cur != ROMFS_ENTRY_EMPTY && steps <= maxEntries; steps++) {
+        if (cur == offset) {
+            return true;
+        }
+        cur = getNext(table, cur);
+    }
+    return false;
+}
+
+static uint32_t GetDirHashNext(const std::vector<uint8_t> &table, uint32_t offset) {
+    RomFSDirEntry entry;
+    return RomFS_ParseDirEntry(table.data(), table.size(), offset, &entry) ? entry.hashNext : ROMFS_ENTRY_EMPTY;
+}
+
+static uint32_t GetFileHashNext(const std::vector<uint8_t> &table, uint32_t offset) {
+    RomFSFileEntry entry;
+    return RomFS_ParseFileEntry(table.data(), table.size(), offset, &entry) ? entry.hashNext : ROMFS_ENTRY_EMPTY;
+}
+
+static bool CheckWUHB(PreflightContext &ctx) {
+    uint8_t rawHeader[ROMFS_HEADER_SIZE];
+    if (!ctx.Read(0, rawHeader, sizeof(rawHeader))) {
+        return false;
+    }
+    RomFSHeader header;
+    RomFS_ParseHeader(rawHeader, &header);
+    if (!RomFS_IsHeaderValid(header, UINT64_MAX)) {
+        return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_HEADER, RPX_LOADER_PREFLIGHT_NO_INDEX, 0);
+    }
+    if (!RomFS_IsHeaderValid(header, ctx.file.GetSize())) {
+        return ctx.Fail(RPX_LOADER_PREFLIGHT_TRUNCATED, RPX_LOADER_PREFLIGHT_NO_INDEX, 0);
+    }
+    // Same limit as RomFS_LoadTables, the module couldn't use larger tables either.
+    if (header.dirHashTableSize > ROMFS_MAX_TABLE_SIZE || header.dirTableSize > ROMFS_MAX_TABLE_SIZE ||
+        header.fileHashTableSize > ROMFS_MAX_TABLE_SIZE || header.fileTableSize > ROMFS_MAX_TABLE_SIZE) {
+        return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE, RPX_LOADER_PREFLIGHT_NO_INDEX, 0);
+    }
+
+    std::vector<uint8_t> dirHashTable(header.dirHashTableSize);
+    std::vector<uint8_t> dirTable(header.dirTableSize);
+    std::vector<uint8_t> fileHashTable(header.fileHashTableSize);
+    std::vector<uint8_t> fileTable(header.fileTableSize);
+    ctx.bytesTotal = ctx.result->bytesRead + dirHashTable.size() + dirTable.size() + fileHashTable.size() + fileTable.size();
+    if (!ctx.Read(header.dirHashTableOffset, dirHashTable.data(), dirHashTable.size()) ||
+        !ctx.Read(header.dirTableOffset, dirTable.data(), dirTable.size()) ||
+        !ctx.Read(header.fileHashTableOffset, fileHashTable.data(), fileHashTable.size()) ||
+        !ctx.Read(header.fileTableOffset, fileTable.data(), fileTable.size()) ||
+        !ctx.ReportProgress()) {
+        return false;
+    }
+
+    // First pass: find all entry starts, so references can be checked against them.
+    std::vector<bool> dirStarts(dirTable.size() / 4 + 1);
+    std::vector<bool> fileStarts(fileTable.size() / 4 + 1);
+    uint32_t dirCount  = 0;
+    uint32_t fileCount = 0;
+    for (uint32_t offset = 0; offset < dirTable.size(); dirCount++) {
+        RomFSDirEntry entry;
+        if (!RomFS_ParseDirEntry(dirTable.data(), dirTable.size(), offset, &entry)) {
+            return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE, offset, header.dirTableOffset + offset);
+        }
+        dirStarts[offset / 4] = true;
+        offset += RomFS_EntrySize(ROMFS_DIR_ENTRY_SIZE, entry.nameLength);
+    }
+    for (uint32_t offset = 0; offset < fileTable.size(); fileCount++) {
+        RomFSFileEntry entry;
+        if (!RomFS_ParseFileEntry(fileTable.data(), fileTable.size(), offset, &entry)) {
+            return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE, offset, header.fileTableOffset + offset);
+        }
+        fileStarts[offset / 4] = true;
+        offset += RomFS_EntrySize(ROMFS_FILE_ENTRY_SIZE, entry.nameLength);
+    }
+
+    for (uint32_t i = 0; i < dirHashTable.size() / 4; i++) {
+        if (!IsOptionalTableReference(dirStarts, LoadBE32(dirHashTable.data() + i * 4))) {
+            return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE, RPX_LOADER_PREFLIGHT_NO_INDEX, header.dirHashTableOffset + i * 4);
+        }
+    }
+    for (uint32_t i = 0; i < fileHashTable.size() / 4; i++) {
+        if (!IsOptionalTableReference(fileStarts, LoadBE32(fileHashTable.data() + i * 4))) {
+            return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE, RPX_LOADER_PREFLIGHT_NO_INDEX, header.fileHashTableOffset + i * 4);
+        }
+    }
+
+    // Second pass: all references and the hash chains.
+    uint32_t dirBuckets  = dirHashTable.size() / 4;
+    uint32_t fileBuckets = fileHashTable.size() / 4;
+    for (uint32_t offset = 0; offset < dirTable.size();) {
+        RomFSDirEntry entry;
+        RomFS_ParseDirEntry(dirTable.data(), dirTable.size(), offset, &entry);
+        if (!IsTableReference(dirStarts, entry.parent) || !IsOptionalTableReference(dirStarts, entry.sibling) ||
+            !IsOptionalTableReference(dirStarts, entry.child) || !IsOptionalTableReference(fileStarts, entry.file) ||
+            !IsOptionalTableReference(dirStarts, entry.hashNext) ||
+            !IsInHashChain(dirHashTable, RomFS_CalcHash(entry.parent, entry.name, entry.nameLength, dirBuckets), offset, dirCount, &GetDirHashNext, dirTable)) {
+            return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE, offset, header.dirTableOffset + offset);
+        }
+        offset += RomFS_EntrySize(ROMFS_DIR_ENTRY_SIZE, entry.nameLength);
+    }
+
+    uint64_t dataEnd = header.fileDataOffset;
+    for (uint32_t offset = 0; offset < fileTable.size();) {
+        RomFSFileEntry entry;
+        RomFS_ParseFileEntry(fileTable.data(), fileTable.size(), offset, &entry);
+        if (!IsTableReference(dirStarts, entry.parent) || !IsOptionalTableReference(fileStarts, entry.sibling) ||
+            !IsOptionalTableReference(fileStarts, entry.hashNext) ||
+            !IsInHashChain(fileHashTable, RomFS_CalcHash(entry.parent, entry.name, entry.nameLength, fileBuckets), offset, fileCount, &GetFileHashNext, fileTable)) {
+            return ctx.Fail(RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE, offset, header.fileTableOffset + offset);
+        }
+        uint64_t available = ctx.file.GetSize() - header.fileDataOffset;
+        if (entry.dataOffset > available || entry.dataSize > available - entry.dataOffset) {
+            return ctx.Fail(RPX_LOADER_PREFLIGHT_TRUNCATED, offset, header.fileDataOffset + entry.dataOffset);
+        }
+        dataEnd = std::max(dataEnd, header.fileDataOffset + entry.dataOffset + entry.dataSize);
+        offset += RomFS_EntrySize(ROMFS_FILE_ENTRY_SIZE, entry.nameLength);
+    }
+    if (ctx.mode == RPX_LOADER_PREFLIGHT_MODE_HEADERS_ONLY) {
+        return true;
+    }
+
+    // The bundle has no checksums, but reading all file data at least catches unreadable sectors.
+    ctx.bytesTotal += dataEnd - header.fileDataOffset;
+    if (!ctx.AllocChunkBuffers(false)) {
+        return false;
+    }
+    for (uint64_t pos = header.fileDataOffset; pos < dataEnd;) {
+        uint32_t chunkSize = (uint32_t) std::min<uint64_t>(RPX_LOADER_IO_CHUNK_SIZE, dataEnd - pos);
+        if (!ctx.Read(pos, ctx.chunk.get(), chunkSize) || !ctx.ReportProgress()) {
+            return false;
+        }
+        pos += chunkSize;
+    }
+    return true;
+}
+
+const char *RPXLoader_GetPreflightErrorStr(RPXLoaderPreflightError error) {
+    switch (error) {
+        case RPX_LOADER_PREFLIGHT_OK:
+            return "RPX_LOADER_PREFLIGHT_OK";
+        case RPX_LOADER_PREFLIGHT_UNKNOWN_FORMAT:
+            return "RPX_LOADER_PREFLIGHT_UNKNOWN_FORMAT";
+        case RPX_LOADER_PREFLIGHT_IO_ERROR:
+            return "RPX_LOADER_PREFLIGHT_IO_ERROR";
+        case RPX_LOADER_PREFLIGHT_TRUNCATED:
+            return "RPX_LOADER_PREFLIGHT_TRUNCATED";
+        case RPX_LOADER_PREFLIGHT_BAD_HEADER:
+            return "RPX_LOADER_PREFLIGHT_BAD_HEADER";
+        case RPX_LOADER_PREFLIGHT_BAD_SECTION_TABLE:
+            return "RPX_LOADER_PREFLIGHT_BAD_SECTION_TABLE";
+        case RPX_LOADER_PREFLIGHT_BAD_SECTION_DATA:
+            return "RPX_LOADER_PREFLIGHT_BAD_SECTION_DATA";
+        case RPX_LOADER_PREFLIGHT_CRC_MISMATCH:
+            return "RPX_LOADER_PREFLIGHT_CRC_MISMATCH";
+        case RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE:
+            return "RPX_LOADER_PREFLIGHT_BAD_ROMFS_TABLE";
+        case RPX_LOADER_PREFLIGHT_CANCELLED:
+            return "RPX_LOADER_PREFLIGHT_CANCELLED";
+    }
+    return "RPX_LOADER_PREFLIGHT_UNKNOWN_ERROR";
+}
+
+static RPXLoaderStatus CheckFile(const char *path, RPXLoaderPreflightMode mode, RPXLoaderPreflightProgressCallback callback, void *context, RPXLoaderPreflightResult *outResult) {
+    outResult->error     = RPX_LOADER_PREFLIGHT_OK;
+    outResult->index     = RPX_LOADER_PREFLIGHT_NO_INDEX;
+    outResult->offset    = 0;
+    outResult->bytesRead = 0;
+
+    PreflightContext ctx;
+    ctx.mode            = mode;
+    ctx.callback        = callback;
+    ctx.callbackContext = context;
+    ctx.result          = outResult;
+    if (!ctx.file.Open(path)) {
+        return RPX_LOADER_RESULT_NOT_FOUND;
+    }
+
+    uint8_t magic[4];
+    if (!ctx.Read(0, magic, sizeof(magic))) {
+        return RPX_LOADER_RESULT_SUCCESS;
+    }
+    if (memcmp(magic, sElfMagic, sizeof(sElfMagic)) == 0) {
+        CheckRPX(ctx);
+    } else if (LoadBE32(magic) == ROMFS_WUHB_MAGIC) {
+        CheckWUHB(ctx);
+    } else {
+        ctx.Fail(RPX_LOADER_PREFLIGHT_UNKNOWN_FORMAT, RPX_LOADER_PREFLIGHT_NO_INDEX, 0);
+    }
+
+    if (ctx.outOfMemory) {
+        return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+    }
+    return RPX_LOADER_RESULT_SUCCESS;
+}
+
+RPXLoaderStatus RPXLoader_PreflightCheck(const char *path, RPXLoaderPreflightMode mode, RPXLoaderPreflightProgressCallback callback, void *context, RPXLoaderPreflightResult *outResult) {
+    auto modeValue = (uint32_t) mode;
+    if (path == nullptr || outResult == nullptr || (modeValue != RPX_LOADER_PREFLIGHT_MODE_HEADERS_ONLY && modeValue != RPX_LOADER_PREFLIGHT_MODE_FULL)) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    try {
+        return CheckFile(path, mode, callback, context, outResult);
+    } catch (const std::bad_alloc &) {
+        return RPX_LOADER_RESULT_UNKNOWN_ERROR;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "byte_order.h"
+#include <cstdint>
+#include <rpxloader/profile.h>
+
+// Layout of an exported access profile, all values are big endian. Also used by host/tools/profile.cpp.
+// The header is followed by the records and the file table. Entries of the file table have a variable size.
+
+#define PROFILE_FILE_MAGIC      0x524C4150 // "RLAP"
+#define PROFILE_FILE_VERSION    1
+#define PROFILE_HEADER_SIZE     0x20
+#define PROFILE_RECORD_SIZE     0x18
+#define PROFILE_FILE_ENTRY_SIZE 0x18 // without path
+
+struct ProfileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    // Frequency of the record times.
+    uint32_t ticksPerSecond;
+    uint32_t recordCount;
+    uint32_t dropped;
+    uint32_t fileCount;
+};
+
+struct ProfileFileEntry {
+    uint32_t pathHash;
+    uint32_t pathLength;
+    // Offset of the file data inside the .wuhb.
+    uint64_t offset;
+    uint64_t size;
+    // Followed by the path (not null terminated), padded to a multiple of 4 bytes.
+};
+
+static inline uint32_t ProfileFile_GetEntrySize(uint32_t pathLength) {
+    return PROFILE_FILE_ENTRY_SIZE + ((pathLength + 3) & ~3u);
+}
+
+static inline void ProfileFile_StoreHeader(uint8_t *data, const ProfileHeader &header) {
+    StoreBE32(data, header.magic);
+    StoreBE16(data + 0x04, header.version);
+    StoreBE16(data + 0x06, header.recordSize);
+    StoreBE32(data + 0x08, header.ticksPerSecond);
+    StoreBE32(data + 0x0C, header.recordCount);
+    StoreBE32(data + 0x10, header.dropped);
+    StoreBE32(data + 0x14, header.fileCount);
+    StoreBE64(data + 0x18, 0);
+}
+
+/**
+ * Returns false if the data isn't the header of a profile this code can read.
+ */
+static inline bool ProfileFile_LoadHeader(const uint8_t *data, ProfileHeader *outHeader) {
+    outHeader->magic          = LoadBE32(data);
+    outHeader->version        = LoadBE16(data + 0x04);
+    outHeader->recordSize     = LoadBE16(data + 0x06);
+    outHeader->ticksPerSecond = LoadBE32(data + 0x08);
+    outHeader->recordCount    = LoadBE32(data + 0x0C);
+    outHeader->dropped        = LoadBE32(data + 0x10);
+    outHeader->fileCount      = LoadBE32(data + 0x14);
+    return outHeader->magic == PROFILE_FILE_MAGIC && outHeader->version >= PROFILE_FILE_VERSION &&
+           outHeader->recordSize >= PROFILE_RECORD_SIZE && outHeader->ticksPerSecond != 0;
+}
+
+static inline void ProfileFile_StoreRecord(uint8_t *data, const RPXLoaderAccessRecord &record) {
+    StoreBE64(data, record.time);
+    StoreBE32(data + 0x08, record.pathHash);
+    StoreBE32(data + 0x0C, record.offset);
+    StoreBE32(data + 0x10, record.length);
+    StoreBE32(data + 0x14, record.type);
+}
+
+static inline void ProfileFile_LoadRecord(const uint8_t *data, RPXLoaderAccessRecord *outRecord) {
+    outRecord->time     = LoadBE64(data);
+    outRecord->pathHash = LoadBE32(data + 0x08);
+    outRecord->offset   = LoadBE32(data + 0x0C);
+    outRecord->length   = LoadBE32(data + 0x10);
+    outRecord->type     = LoadBE32(data + 0x14);
+}
+
+static inline void ProfileFile_StoreFileEntry(uint8_t *data, const ProfileFileEntry &entry) {
+    StoreBE32(data, entry.pathHash);
+    StoreBE32(data + 0x04, entry.pathLength);
+    StoreBE64(data + 0x08, entry.offset);
+    StoreBE64(data + 0x10, entry.size);
+}
+
+static inline void ProfileFile_LoadFileEntry(const uint8_t *data, ProfileFileEntry *outEntry) {
+    outEntry->pathHash   = LoadBE32(data);
+    outEntry->pathLength = LoadBE32(data + 0x04);
+    outEntry->offset     = LoadBE64(data + 0x08);
+    outEntry->size       = LoadBE64(data + 0x10);
+}
@@ -0,0 +1,174 @@
+#include "romfs.h"
+#include "byte_order.h"
+#include <cstring>
+
+void RomFS_ParseHeader(const uint8_t *data, RomFSHeader *outHeader) {
+    outHeader->magic               = LoadBE32(data + 0x00);
+    outHeader->headerSize          = LoadBE32(data + 0x04);
+    outHeader->dirHashTableOffset  = LoadBE64(data + 0x08);
+    outHeader->dirHashTableSize    = LoadBE64(data + 0x10);
+    outHeader->dirTableOffset      = LoadBE64(data + 0x18);
+    outHeader->dirTableSize        = LoadBE64(data + 0x20);
+    outHeader->fileHashTableOffset = LoadBE64(data + 0x28);
+    outHeader->fileHashTableSize   = LoadBE64(data + 0x30);
+    outHeader->fileTableOffset     = LoadBE64(data + 0x38);
+    outHeader->fileTableSize       = LoadBE64(data + 0x40);
+    outHeader->fileDataOffset      = LoadBE64(data + 0x48);
+}
+
+void RomFS_WriteHeader(uint8_t *data, const RomFSHeader &header) {
+    StoreBE32(data + 0x00, header.magic);
+    StoreBE32(data + 0x04, header.headerSize);
+    StoreBE64(data + 0x08, header.dirHashTableOffset);
+    StoreBE64(data + 0x10, header.dirHashTableSize);
+    StoreBE64(data + 0x18, header.dirTableOffset);
+    StoreBE64(data + 0x20, header.dirTableSize);
+    StoreBE64(data + 0x28, header.fileHashTableOffset);
+    StoreBE64(data + 0x30, header.fileHashTableSize);
+    StoreBE64(data + 0x38, header.fileTableOffset);
+    StoreBE64(data + 0x40, header.fileTableSize);
+    StoreBE64(data + 0x48, header.fileDataOffset);
+}
+
+static bool IsRangeValid(uint64_t offset, uint64_t size, uint64_t fileSize) {
+    return offset >= ROMFS_HEADER_SIZE && offset <= fileSize && size <= fileSize - offset;
+}
+
+bool RomFS_IsHeaderValid(const RomFSHeader &header, uint64_t fileSize) {
+    if (header.magic != ROMFS_WUHB_MAGIC || header.headerSize != ROMFS_HEADER_SIZE) {
+        return false;
+    }
+    // Tables are loaded into memory as a whole, anything above 4 GiB can't be valid anyway.
+    if (header.dirHashTableSize > UINT32_MAX || header.dirTableSize > UINT32_MAX || header.fileHashTableSize > UINT32_MAX || header.fileTableSize > UINT32_MAX) {
+        return false;
+    }
+    if ((header.dirHashTableSize % 4) != 0 || (header.fileHashTableSize % 4) != 0 || header.dirHashTableSize == 0 || header.fileHashTableSize == 0) {
+        return false;
+    }
+    if (header.dirTableSize < ROMFS_DIR_ENTRY_SIZE) {
+        return false;
+    }
+    return IsRangeValid(header.dirHashTableOffset, header.dirHashTableSize, fileSize) &&
+           IsRangeValid(header.dirTableOffset, header.dirTableSize, fileSize) &&
+           IsRangeValid(header.fileHashTableOffset, header.fileHashTableSize, fileSize) &&
+           IsRangeValid(header.fileTableOffset, header.fileTableSize, fileSize) &&
+           IsRangeValid(header.fileDataOffset, 0, fileSize);
+}
+
+bool RomFS_ParseDirEntry(const uint8_t *table, uint32_t tableSize, uint32_t offset, RomFSDirEntry *outEntry) {
+    if (offset > tableSize || tableSize - offset < ROMFS_DIR_ENTRY_SIZE || (offset % 4) != 0) {
+        return false;
+    }
+    auto entry           = table + offset;
+    outEntry->parent     = LoadBE32(entry + 0x00);
+    outEntry->sibling    = LoadBE32(entry + 0x04);
+    outEntry->child      = LoadBE32(entry + 0x08);
+    outEntry->file       = LoadBE32(entry + 0x0C);
+    outEntry->hashNext   = LoadBE32(entry + 0x10);
+    outEntry->nameLength = LoadBE32(entry + 0x14);
+    outEntry->name       = (const char *) entry + ROMFS_DIR_ENTRY_SIZE;
+    return outEntry->nameLength <= tableSize - offset - ROMFS_DIR_ENTRY_SIZE;
+}
+
+bool RomFS_ParseFileEntry(const uint8_t *table, uint32_t tableSize, uint32_t offset, RomFSFileEntry *outEntry) {
+    if (offset > tableSize || tableSize - offset < ROMFS_FILE_ENTRY_SIZE || (offset % 4) != 0) {
+        return false;
+    }
+    auto entry           = table + offset;
+    outEntry->parent     = LoadBE32(entry + 0x00);
+    outEntry->sibling    = LoadBE32(entry + 0x04);
+    outEntry->dataOffset = LoadBE64(entry + 0x08);
+    outEntry->dataSize   = LoadBE64(entry + 0x10);
+    outEntry->hashNext   = LoadBE32(entry + 0x18);
+    outEntry->nameLength = LoadBE32(entry + 0x1C);
+    outEntry->name       = (const char *) entry + ROMFS_FILE_ENTRY_SIZE;
+    return outEntry->nameLength <= tableSize - offset - ROMFS_FILE_ENTRY_SIZE;
+}
+
+uint32_t RomFS_CalcHash(uint32_t parent, const char *name, uint32_t nameLength, uint32_t bucketCount) {
+    uint32_t hash = parent ^ 123456789;
+    for (uint32_t i = 0; i < nameLength; i++) {
+        hash = (hash >> 5) | (hash << 27);
+        hash ^= (uint8_t) name[i];
+    }
+    return hash % bucketCount;
+}
+
+static bool LoadTable(SDFile &file, uint64_t offset, uint64_t size, std::vector<uint8_t> *outTable) {
+    if (size > ROMFS_MAX_TABLE_SIZE) {
+        return false;
+    }
+    outTable->resize(size);
+    return file.ReadAt(offset, outTable->data(), size);
+}
+
+bool RomFS_LoadTables(SDFile &file, RomFSTables *outTables) {
+    uint8_t header[ROMFS_HEADER_SIZE];
+    if (!file.ReadAt(0, header, sizeof(header))) {
+        return false;
+    }
+    auto &h = outTables->header;
+    RomFS_ParseHeader(header, &h);
+    if (!RomFS_IsHeaderValid(h, file.GetSize())) {
+        return false;
+    }
+    return LoadTable(file, h.dirHashTableOffset, h.dirHashTableSize, &outTables->dirHashTable) &&
+           LoadTable(file, h.dirTableOffset, h.dirTableSize, &outTables->dirTable) &&
+           LoadTable(file, h.fileHashTableOffset, h.fileHashTableSize, &outTables->fileHashTable) &&
+           LoadTable(file, h.fileTableOffset, h.fileTableSize, &outTables->fileTable);
+}
+
+static bool IsEntryName(const char *entryName, uint32_t entryNameLength, const char *name, uint32_t nameLength) {
+    return entryNameLength == nameLength && memcmp(entryName, name, nameLength) == 0;
+}
+
+bool RomFS_FindFile(const RomFSTables &tables, const char *path, RomFSFileEntry *outEntry) {
+    uint32_t dirBuckets  = tables.dirHashTable.size() / 4;
+    uint32_t fileBuckets = tables.fileHashTable.size() / 4;
+    // Limits the walk through broken, circular hash chains.
+    uint32_t maxDirSteps  = tables.dirTable.size() / ROMFS_DIR_ENTRY_SIZE;
+    uint32_t maxFileSteps = tables.fileTable.size() / ROMFS_FILE_ENTRY_SIZE;
+
+    while (*path == '/') {
+        path++;
+    }
+    uint32_t parent = 0;
+    while (true) {
+        auto separator = strchr(path, '/');
+        if (separator == nullptr) {
+            break;
+        }
+        uint32_t nameLength = separator - path;
+        auto bucket         = RomFS_CalcHash(parent, path, nameLength, dirBuckets);
+        auto offset         = LoadBE32(tables.dirHashTable.data() + bucket * 4);
+        RomFSDirEntry dir;
+        uint32_t steps = 0;
+        for (; offset != ROMFS_ENTRY_EMPTY; offset = dir.hashNext) {
+            if (steps++ > maxDirSteps || !RomFS_ParseDirEntry(tables.dirTable.data(), tables.dirTable.size(), offset, &dir)) {
+                return false;
+            }
+            if (dir.parent == parent && IsEntryName(dir.name, dir.nameLength, path, nameLength)) {
+                break;
+            }
+        }
+        if (offset == ROMFS_ENTRY_EMPTY) {
+            return false;
+        }
+        parent = offset;
+        path   = separator + 1;
+    }
+
+    uint32_t nameLength = strlen(path);
+    auto bucket         = RomFS_CalcHash(parent, path, nameLength, fileBuckets);
+    auto offset         = LoadBE32(tables.fileHashTable.data() + bucket * 4);
+    uint32_t steps      = 0;
+    for (; offset != ROMFS_ENTRY_EMPTY; offset = outEntry->hashNext) {
+        if (steps++ > maxFileSteps || !RomFS_ParseFileEntry(tables.fileTable.data(), tables.fileTable.size(), offset, outEntry)) {
+            return false;
+        }
+        if (outEntry->parent == parent && IsEntryName(outEntry->name, outEntry->nameLength, path, nameLength)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "sd_file.h"
+#include <cstdint>
+#include <vector>
+
+// Layout of the RomFS inside a .wuhb, all values are big endian.
+
+#define ROMFS_WUHB_MAGIC      0x57554842 // "WUHB"
+#define ROMFS_HEADER_SIZE     0x50
+#define ROMFS_ENTRY_EMPTY     0xFFFFFFFF
+#define ROMFS_DIR_ENTRY_SIZE  0x18 // without name
+#define ROMFS_FILE_ENTRY_SIZE 0x20 // without name
+
+struct RomFSHeader {
+    uint32_t magic;
+    uint32_t headerSize;
+    uint64_t dirHashTableOffset;
+    uint64_t dirHashTableSize;
+    uint64_t dirTableOffset;
+    uint64_t dirTableSize;
+    uint64_t fileHashTableOffset;
+    uint64_t fileHashTableSize;
+    uint64_t fileTableOffset;
+    uint64_t fileTableSize;
+    // Offsets in RomFSFileEntry are relative to this.
+    uint64_t fileDataOffset;
+};
+
+struct RomFSDirEntry {
+    uint32_t parent;
+    uint32_t sibling;
+    uint32_t child;
+    uint32_t file;
+    uint32_t hashNext;
+    uint32_t nameLength;
+    const char *name; // not null terminated, points into the table
+};
+
+struct RomFSFileEntry {
+    uint32_t parent;
+    uint32_t sibling;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+    uint32_t hashNext;
+    uint32_t nameLength;
+    const char *name; // not null terminated, points into the table
+};
+
+static inline uint32_t RomFS_EntrySize(uint32_t baseSize, uint32_t nameLength) {
+    return baseSize + ((nameLength + 3) & ~3u);
+}
+
+void RomFS_ParseHeader(const uint8_t *data, RomFSHeader *outHeader);
+
+void RomFS_WriteHeader(uint8_t *data, const RomFSHeader &header);
+
+/**
+ * Checks magic, header size and that all tables and the data partition start lie within a file of the given size.
+ */
+bool RomFS_IsHeaderValid(const RomFSHeader &header, uint64_t fileSize);
+
+/**
+ * Parses the entry at the given table offset. Returns false if it doesn't fit into the table.
+ */
+bool RomFS_ParseDirEntry(const uint8_t *table, uint32_t tableSize, uint32_t offset, RomFSDirEntry *outEntry);
+
+bool RomFS_ParseFileEntry(const uint8_t *table, uint32_t tableSize, uint32_t offset, RomFSFileEntry *outEntry);
+
+/**
+ * Hash used to place dir/file entries into the hash table buckets.
+ */
+uint32_t RomFS_CalcHash(uint32_t parent, const char *name, uint32_t nameLength, uint32_t bucketCount);
+
+/**
+ * Header and the four lookup tables of a RomFS, loaded into memory.
+ */
+struct RomFSTables {
+    RomFSHeader header;
+    std::vector<uint8_t> dirHashTable;
+    std::vector<uint8_t> dirTable;
+    std::vector<uint8_t> fileHashTable;
+    std::vector<uint8_t> fileTable;
+};
+
+// Upper limit for a single table that is loaded into memory.
+#define ROMFS_MAX_TABLE_SIZE 0x1000000
+
+/**
+ * Reads and checks the header and loads all tables. Returns false if the file isn't a valid RomFS.
+ */
+bool RomFS_LoadTables(SDFile &file, RomFSTables *outTables);
+
+/**
+ * Looks up a file via the hash tables, e.g. "meta/meta.ini". The path is relative to the root of the RomFS.
+ */
+bool RomFS_FindFile(const RomFSTables &tables, const char *path, RomFSFileEntry *outEntry);
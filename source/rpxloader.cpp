@@ -1,21 +1,33 @@
+#include "dispatch.h"
+#include "launch_trace.h"
 #include "logger.h"
+#include "path_cache.h"
+#include "shutdown_hooks.h"
+#include "stats.h"
 #include <coreinit/debug.h>
 #include <coreinit/dynload.h>
+#include <cstring>
+#include <mutex>
+#include <new>
 #include <rpxloader/rpxloader.h>
 
-static OSDynLoad_Module sModuleHandle = nullptr;
-
-static RPXLoaderVersion (*sRLGetVersion)(uint32_t *version) = nullptr;
-
-static RPXLoaderStatus (*sRLPrepareLaunchFromSD)(const char *path)   = nullptr;
-static RPXLoaderStatus (*sRLLaunchPreparedHomebrew)()                = nullptr;
-static RPXLoaderStatus (*sRLLaunchHomebrew)(const char *bundle_path) = nullptr;
-
-static RPXLoaderStatus (*sRLDisableContentRedirection)()                                    = nullptr;
-static RPXLoaderStatus (*sRLEnableContentRedirection)()                                     = nullptr;
-static RPXLoaderStatus (*sRLUnmountCurrentRunningBundle)()                                  = nullptr;
-static RPXLoaderStatus (*sRL_GetPathOfRunningExecutable)(char *outBuffer, uint32_t outSize) = nullptr;
-static RPXLoaderStatus (*sRL_GetPathOfSaveRedirection)(char *outBuffer, uint32_t outSize)   = nullptr;
+static char sExportMissing;
+
+/**
+ * Every successful RPXLoader_InitLibrary publishes a new dispatch, a published one is never reused. They are kept in
+ * this list and never freed, so a thread that loaded gDispatch just before RPXLoader_DeInitLibrary still reads valid
+ * (and unchanged) memory. That costs one small allocation per init/deinit cycle.
+ */
+struct PublishedDispatch {
+    RPXLoaderDispatch dispatch;
+    PublishedDispatch *next;
+};
+static PublishedDispatch *sPublishedDispatches = nullptr;
+std::atomic<RPXLoaderDispatch *> gDispatch{nullptr};
+std::atomic<LaunchTraceRecorder> gLaunchTraceRecorder{nullptr};
+static std::atomic<void (*)()> sShutdownHooks[RL_SHUTDOWN_HOOK_COUNT];
+// Only serializes RPXLoader_InitLibrary/RPXLoader_DeInitLibrary, the wrappers never take it.
+static std::mutex sInitMutex;
 
 const char *RPXLoader_GetStatusStr(RPXLoaderStatus status) {
     switch (status) {
@@ -39,175 +51,298 @@ const char *RPXLoader_GetStatusStr(RPXLoaderStatus status) {
             return "RPX_LOADER_RESULT_UNSUPPORTED_COMMAND";
         case RPX_LOADER_RESULT_NOT_AVAILABLE:
             return "RPX_LOADER_RESULT_NOT_AVAILABLE";
+        case RPX_LOADER_RESULT_CANCELLED:
+            return "RPX_LOADER_RESULT_CANCELLED";
     }
     return "RPX_LOADER_RESULT_UNKNOWN_ERROR";
 }
 
-static RPXLoaderVersion rpxLoaderVersion = RPX_LOADER_MODULE_VERSION_ERROR;
-
-RPXLoaderStatus RPXLoader_InitLibrary() {
-    if (OSDynLoad_Acquire("homebrew_rpx_loader", &sModuleHandle) != OS_DYNLOAD_OK) {
-        DEBUG_FUNCTION_LINE_ERR("OSDynLoad_Acquire homebrew_rpx_loader failed.");
-        return RPX_LOADER_RESULT_MODULE_NOT_FOUND;
+void *ResolveExport(RPXLoaderDispatch *dispatch, RPXLoaderExportSlot slot) {
+    auto address = dispatch->exports[slot].load(std::memory_order_acquire);
+    if (address == nullptr) {
+        // The module of a retired dispatch has been released, it must not be searched anymore.
+        if (gDispatch.load(std::memory_order_acquire) != dispatch) {
+            return nullptr;
+        }
+        if (OSDynLoad_FindExport(dispatch->module, OS_DYNLOAD_EXPORT_FUNC, gExportTable[slot].name, &address) != OS_DYNLOAD_OK || address == nullptr) {
+            DEBUG_FUNCTION_LINE_WARN("FindExport %s failed.", gExportTable[slot].name);
+            address = &sExportMissing;
+        }
+        dispatch->exports[slot].store(address, std::memory_order_release);
     }
+    return address != &sExportMissing ? address : nullptr;
+}
 
-    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "RL_GetVersion", (void **) &sRLGetVersion) != OS_DYNLOAD_OK) {
-        DEBUG_FUNCTION_LINE_ERR("FindExport RL_GetVersion failed.");
-        return RPX_LOADER_RESULT_MODULE_MISSING_EXPORT;
-    }
+void ShutdownHook_Register(RPXLoaderShutdownHook hook, void (*func)()) {
+    sShutdownHooks[hook].store(func, std::memory_order_release);
+}
 
-    auto res = RPXLoader_GetVersion(&rpxLoaderVersion);
-    if (res != RPX_LOADER_RESULT_SUCCESS) {
-        return RPX_LOADER_RESULT_UNSUPPORTED_API_VERSION;
-    }
+RPXLoaderStatus RPXLoader_InitLibrary() {
+    return RPXLoader_InitLibraryEx(nullptr);
+}
 
-    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "RL_PrepareLaunchFromSD", (void **) &sRLPrepareLaunchFromSD) != OS_DYNLOAD_OK) {
-        DEBUG_FUNCTION_LINE_WARN("FindExport RL_PrepareLaunchFromSD failed.");
-        sRLPrepareLaunchFromSD = nullptr;
+RPXLoaderStatus RPXLoader_InitLibraryEx(bool *outInitialized) {
+    if (outInitialized != nullptr) {
+        *outInitialized = false;
     }
-    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "RL_LaunchPreparedHomebrew", (void **) &sRLLaunchPreparedHomebrew) != OS_DYNLOAD_OK) {
-        DEBUG_FUNCTION_LINE_WARN("FindExport RL_LaunchPreparedHomebrew failed.");
-        sRLLaunchPreparedHomebrew = nullptr;
-    }
-    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "RL_LaunchHomebrew", (void **) &sRLLaunchHomebrew) != OS_DYNLOAD_OK) {
-        DEBUG_FUNCTION_LINE_WARN("FindExport RL_LaunchHomebrew failed.");
-        sRLLaunchHomebrew = nullptr;
+    if (gDispatch.load(std::memory_order_acquire) != nullptr) {
+        return RPX_LOADER_RESULT_SUCCESS;
     }
 
-    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "RL_DisableContentRedirection", (void **) &sRLDisableContentRedirection) != OS_DYNLOAD_OK) {
-        DEBUG_FUNCTION_LINE_WARN("FindExport RL_DisableContentRedirection failed.");
-        sRLDisableContentRedirection = nullptr;
+    std::lock_guard<std::mutex> lock(sInitMutex);
+    if (gDispatch.load(std::memory_order_relaxed) != nullptr) {
+        return RPX_LOADER_RESULT_SUCCESS;
     }
 
-    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "RL_EnableContentRedirection", (void **) &sRLEnableContentRedirection) != OS_DYNLOAD_OK) {
-        DEBUG_FUNCTION_LINE_WARN("FindExport RL_EnableContentRedirection failed.");
-        sRLEnableContentRedirection = nullptr;
+    auto entry = new (std::nothrow) PublishedDispatch{};
+    if (entry == nullptr) {
+        DEBUG_FUNCTION_LINE_ERR("Failed to allocate the dispatch.");
+        return RPX_LOADER_RESULT_UNKNOWN_ERROR;
     }
-
-    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "RL_UnmountCurrentRunningBundle", (void **) &sRLUnmountCurrentRunningBundle) != OS_DYNLOAD_OK) {
-        DEBUG_FUNCTION_LINE_WARN("FindExport RL_UnmountCurrentRunningBundle failed.");
-        sRLUnmountCurrentRunningBundle = nullptr;
+    auto &dispatch = entry->dispatch;
+    if (OSDynLoad_Acquire("homebrew_rpx_loader", &dispatch.module) != OS_DYNLOAD_OK) {
+        DEBUG_FUNCTION_LINE_ERR("OSDynLoad_Acquire homebrew_rpx_loader failed.");
+        delete entry;
+        return RPX_LOADER_RESULT_MODULE_NOT_FOUND;
     }
 
-    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "RL_GetPathOfRunningExecutable", (void **) &sRL_GetPathOfRunningExecutable) != OS_DYNLOAD_OK) {
-        DEBUG_FUNCTION_LINE_WARN("FindExport RL_GetPathOfRunningExecutable failed.");
-        sRL_GetPathOfRunningExecutable = nullptr;
+    if (OSDynLoad_FindExport(dispatch.module, OS_DYNLOAD_EXPORT_FUNC, "RL_GetVersion", (void **) &dispatch.getVersion) != OS_DYNLOAD_OK) {
+        DEBUG_FUNCTION_LINE_ERR("FindExport RL_GetVersion failed.");
+        OSDynLoad_Release(dispatch.module);
+        delete entry;
+        return RPX_LOADER_RESULT_MODULE_MISSING_EXPORT;
     }
 
-    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "RL_GetPathOfSaveRedirection", (void **) &sRL_GetPathOfSaveRedirection) != OS_DYNLOAD_OK) {
-        DEBUG_FUNCTION_LINE_WARN("FindExport RL_GetPathOfSaveRedirection failed.");
-        sRL_GetPathOfSaveRedirection = nullptr;
+    if (dispatch.getVersion(&dispatch.version) != RPX_LOADER_RESULT_SUCCESS || dispatch.version == RPX_LOADER_MODULE_VERSION_ERROR) {
+        OSDynLoad_Release(dispatch.module);
+        delete entry;
+        return RPX_LOADER_RESULT_UNSUPPORTED_API_VERSION;
     }
 
+    entry->next          = sPublishedDispatches;
+    sPublishedDispatches = entry;
+    gDispatch.store(&dispatch, std::memory_order_release);
+    if (outInitialized != nullptr) {
+        *outInitialized = true;
+    }
     return RPX_LOADER_RESULT_SUCCESS;
 }
 
 RPXLoaderStatus RPXLoader_DeInitLibrary() {
+    // Has to happen before the module is released, e.g. a launch that is already in progress still needs it.
+    for (auto &hook : sShutdownHooks) {
+        if (auto func = hook.load(std::memory_order_acquire); func != nullptr) {
+            func();
+        }
+    }
+    std::lock_guard<std::mutex> lock(sInitMutex);
+    auto dispatch = gDispatch.exchange(nullptr, std::memory_order_acq_rel);
+    if (dispatch != nullptr) {
+        OSDynLoad_Release(dispatch->module);
+    }
+    PathCache_Shutdown();
+    RPXLoader_FlushLog();
     return RPX_LOADER_RESULT_SUCCESS;
 }
 
+RPXLoaderStatus RPXLoader_ResolveAllExports() {
+    auto dispatch = gDispatch.load(std::memory_order_acquire);
+    if (dispatch == nullptr) {
+        return RPX_LOADER_RESULT_LIB_UNINITIALIZED;
+    }
+    RPXLoaderStatus res = RPX_LOADER_RESULT_SUCCESS;
+    for (int i = 0; i < RL_EXPORT_COUNT; i++) {
+        auto slot = (RPXLoaderExportSlot) i;
+        if (dispatch->version >= gExportTable[slot].minVersion && ResolveExport(dispatch, slot) == nullptr) {
+            res = RPX_LOADER_RESULT_MODULE_MISSING_EXPORT;
+        }
+    }
+    return res;
+}
+
 RPXLoaderStatus RPXLoader_GetVersion(uint32_t *version) {
-    if (sRLGetVersion == nullptr) {
-        if (OSDynLoad_Acquire("homebrew_rpx_loader", &sModuleHandle) != OS_DYNLOAD_OK) {
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_GET_VERSION, [&]() -> RPXLoaderStatus {
+        if (auto dispatch = gDispatch.load(std::memory_order_acquire); dispatch != nullptr) {
+            if (version == nullptr) {
+                return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+            }
+            return dispatch->getVersion(version);
+        }
+
+        // Not initialized: look the module up without touching the shared state.
+        OSDynLoad_Module module = nullptr;
+        if (OSDynLoad_Acquire("homebrew_rpx_loader", &module) != OS_DYNLOAD_OK) {
             DEBUG_FUNCTION_LINE_WARN("OSDynLoad_Acquire failed.");
             return RPX_LOADER_RESULT_MODULE_NOT_FOUND;
         }
 
-        if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "RL_GetVersion", (void **) &sRLGetVersion) != OS_DYNLOAD_OK) {
+        decltype(&RPXLoader_GetVersion) getVersion = nullptr;
+        if (OSDynLoad_FindExport(module, OS_DYNLOAD_EXPORT_FUNC, "RL_GetVersion", (void **) &getVersion) != OS_DYNLOAD_OK) {
             DEBUG_FUNCTION_LINE_WARN("FindExport RL_GetVersion failed.");
+            OSDynLoad_Release(module);
             return RPX_LOADER_RESULT_MODULE_MISSING_EXPORT;
         }
-    }
-    if (version == nullptr) {
-        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
-    }
 
-    return reinterpret_cast<decltype(&RPXLoader_GetVersion)>(sRLGetVersion)(version);
+        RPXLoaderStatus res = RPX_LOADER_RESULT_INVALID_ARGUMENT;
+        if (version != nullptr) {
+            res = getVersion(version);
+        }
+        OSDynLoad_Release(module);
+        return res;
+    });
 }
 
 RPXLoaderStatus RPXLoader_PrepareLaunchFromSD(const char *path) {
-    if (rpxLoaderVersion == RPX_LOADER_MODULE_VERSION_ERROR) {
-        return RPX_LOADER_RESULT_LIB_UNINITIALIZED;
-    }
-    if (sRLPrepareLaunchFromSD == nullptr || rpxLoaderVersion < 1) {
-        return RPX_LOADER_RESULT_UNSUPPORTED_COMMAND;
-    }
-    if (path == nullptr) {
-        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
-    }
-    return reinterpret_cast<decltype(&RPXLoader_PrepareLaunchFromSD)>(sRLPrepareLaunchFromSD)(path);
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_PREPARE_LAUNCH_FROM_SD, [&]() -> RPXLoaderStatus {
+        decltype(&RPXLoader_PrepareLaunchFromSD) func;
+        if (auto res = GetExportFunction(RL_EXPORT_PREPARE_LAUNCH_FROM_SD, &func); res != RPX_LOADER_RESULT_SUCCESS) {
+            return res;
+        }
+        if (path == nullptr) {
+            return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+        }
+        auto res = LaunchTrace_Measure(RPX_LOADER_TRACE_PHASE_PREPARE, path, [&]() { return func(path); });
+        PathCache_Invalidate();
+        return res;
+    });
 }
 
 RPXLoaderStatus RPXLoader_LaunchPreparedHomebrew() {
-    if (rpxLoaderVersion == RPX_LOADER_MODULE_VERSION_ERROR) {
-        return RPX_LOADER_RESULT_LIB_UNINITIALIZED;
-    }
-    if (sRLLaunchPreparedHomebrew == nullptr || rpxLoaderVersion < 1) {
-        return RPX_LOADER_RESULT_UNSUPPORTED_COMMAND;
-    }
-    return reinterpret_cast<decltype(&RPXLoader_LaunchPreparedHomebrew)>(sRLLaunchPreparedHomebrew)();
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_LAUNCH_PREPARED_HOMEBREW, [&]() -> RPXLoaderStatus {
+        decltype(&RPXLoader_LaunchPreparedHomebrew) func;
+        if (auto res = GetExportFunction(RL_EXPORT_LAUNCH_PREPARED_HOMEBREW, &func); res != RPX_LOADER_RESULT_SUCCESS) {
+            return res;
+        }
+        return LaunchTrace_Measure(RPX_LOADER_TRACE_PHASE_LAUNCH_REQUESTED, nullptr, func);
+    });
 }
 
 RPXLoaderStatus RPXLoader_LaunchHomebrew(const char *bundle_path) {
-    if (rpxLoaderVersion == RPX_LOADER_MODULE_VERSION_ERROR) {
-        return RPX_LOADER_RESULT_LIB_UNINITIALIZED;
-    }
-    if (sRLLaunchHomebrew == nullptr || rpxLoaderVersion < 1) {
-        return RPX_LOADER_RESULT_UNSUPPORTED_COMMAND;
-    }
-    return reinterpret_cast<decltype(&RPXLoader_LaunchHomebrew)>(sRLLaunchHomebrew)(bundle_path);
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_LAUNCH_HOMEBREW, [&]() -> RPXLoaderStatus {
+        decltype(&RPXLoader_LaunchHomebrew) func;
+        if (auto res = GetExportFunction(RL_EXPORT_LAUNCH_HOMEBREW, &func); res != RPX_LOADER_RESULT_SUCCESS) {
+            return res;
+        }
+        auto res = LaunchTrace_Measure(RPX_LOADER_TRACE_PHASE_LAUNCH_REQUESTED, bundle_path, [&]() { return func(bundle_path); });
+        PathCache_Invalidate();
+        return res;
+    });
 }
 
 RPXLoaderStatus RPXLoader_EnableContentRedirection() {
-    if (rpxLoaderVersion == RPX_LOADER_MODULE_VERSION_ERROR) {
-        return RPX_LOADER_RESULT_LIB_UNINITIALIZED;
-    }
-    if (sRLEnableContentRedirection == nullptr || rpxLoaderVersion < 1) {
-        return RPX_LOADER_RESULT_UNSUPPORTED_COMMAND;
-    }
-
-    return reinterpret_cast<decltype(&RPXLoader_EnableContentRedirection)>(sRLEnableContentRedirection)();
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_ENABLE_CONTENT_REDIRECTION, [&]() -> RPXLoaderStatus {
+        decltype(&RPXLoader_EnableContentRedirection) func;
+        if (auto res = GetExportFunction(RL_EXPORT_ENABLE_CONTENT_REDIRECTION, &func); res != RPX_LOADER_RESULT_SUCCESS) {
+            return res;
+        }
+        return func();
+    });
 }
 
 RPXLoaderStatus RPXLoader_DisableContentRedirection() {
-    if (rpxLoaderVersion == RPX_LOADER_MODULE_VERSION_ERROR) {
-        return RPX_LOADER_RESULT_LIB_UNINITIALIZED;
-    }
-    if (sRLDisableContentRedirection == nullptr || rpxLoaderVersion < 1) {
-        return RPX_LOADER_RESULT_UNSUPPORTED_COMMAND;
-    }
-    return reinterpret_cast<decltype(&RPXLoader_DisableContentRedirection)>(sRLDisableContentRedirection)();
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_DISABLE_CONTENT_REDIRECTION, [&]() -> RPXLoaderStatus {
+        decltype(&RPXLoader_DisableContentRedirection) func;
+        if (auto res = GetExportFunction(RL_EXPORT_DISABLE_CONTENT_REDIRECTION, &func); res != RPX_LOADER_RESULT_SUCCESS) {
+            return res;
+        }
+        return func();
+    });
 }
 
 RPXLoaderStatus RPXLoader_UnmountCurrentRunningBundle() {
-    if (rpxLoaderVersion == RPX_LOADER_MODULE_VERSION_ERROR) {
-        return RPX_LOADER_RESULT_LIB_UNINITIALIZED;
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_UNMOUNT_CURRENT_RUNNING_BUNDLE, [&]() -> RPXLoaderStatus {
+        decltype(&RPXLoader_UnmountCurrentRunningBundle) func;
+        if (auto res = GetExportFunction(RL_EXPORT_UNMOUNT_CURRENT_RUNNING_BUNDLE, &func); res != RPX_LOADER_RESULT_SUCCESS) {
+            return res;
+        }
+        auto res = func();
+        PathCache_Invalidate();
+        return res;
+    });
+}
+
+static RPXLoaderStatus CopyCachedPath(RPXLoaderPathKind kind, char *outBuffer, uint32_t outSize, uint32_t *outRequiredSize, bool truncate) {
+    const char *path = nullptr;
+    uint32_t length  = 0;
+    if (auto res = PathCache_Get(kind, &path, &length); res != RPX_LOADER_RESULT_SUCCESS) {
+        return res;
     }
-    if (sRLUnmountCurrentRunningBundle == nullptr || rpxLoaderVersion < 1) {
-        return RPX_LOADER_RESULT_UNSUPPORTED_COMMAND;
+    if (outRequiredSize != nullptr) {
+        *outRequiredSize = length + 1;
+        if (outBuffer == nullptr && outSize == 0) {
+            return RPX_LOADER_RESULT_SUCCESS;
+        }
     }
-
-    return reinterpret_cast<decltype(&RPXLoader_UnmountCurrentRunningBundle)>(sRLUnmountCurrentRunningBundle)();
+    if (outBuffer == nullptr || outSize == 0 || (!truncate && outSize <= length)) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    auto copySize = length < outSize ? length : outSize - 1;
+    memcpy(outBuffer, path, copySize);
+    outBuffer[copySize] = '\0';
+    return RPX_LOADER_RESULT_SUCCESS;
 }
 
-RPXLoaderStatus RPXLoader_GetPathOfRunningExecutable(char *outBuffer, uint32_t outSize) {
-    if (rpxLoaderVersion == RPX_LOADER_MODULE_VERSION_ERROR) {
-        return RPX_LOADER_RESULT_LIB_UNINITIALIZED;
+static RPXLoaderStatus GetCachedPathView(RPXLoaderPathKind kind, const char **outPath, uint32_t *outLength) {
+    if (outPath == nullptr) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    const char *path = nullptr;
+    uint32_t length  = 0;
+    if (auto res = PathCache_Get(kind, &path, &length); res != RPX_LOADER_RESULT_SUCCESS) {
+        return res;
     }
-    if (sRL_GetPathOfRunningExecutable == nullptr || rpxLoaderVersion < 2) {
-        return RPX_LOADER_RESULT_UNSUPPORTED_COMMAND;
+    *outPath = path;
+    if (outLength != nullptr) {
+        *outLength = length;
     }
+    return RPX_LOADER_RESULT_SUCCESS;
+}
 
-    return reinterpret_cast<decltype(&RPXLoader_GetPathOfRunningExecutable)>(sRL_GetPathOfRunningExecutable)(outBuffer, outSize);
+RPXLoaderStatus RPXLoader_GetPathOfRunningExecutable(char *outBuffer, uint32_t outSize) {
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_GET_PATH_OF_RUNNING_EXECUTABLE, [&]() -> RPXLoaderStatus {
+        return CopyCachedPath(RL_PATH_RUNNING_EXECUTABLE, outBuffer, outSize, nullptr, true);
+    });
+}
+
+RPXLoaderStatus RPXLoader_GetPathOfRunningExecutableEx(char *outBuffer, uint32_t outSize, uint32_t *outRequiredSize) {
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_GET_PATH_OF_RUNNING_EXECUTABLE, [&]() -> RPXLoaderStatus {
+        return CopyCachedPath(RL_PATH_RUNNING_EXECUTABLE, outBuffer, outSize, outRequiredSize, false);
+    });
+}
+
+RPXLoaderStatus RPXLoader_GetPathOfRunningExecutableView(const char **outPath, uint32_t *outLength) {
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_GET_PATH_OF_RUNNING_EXECUTABLE, [&]() -> RPXLoaderStatus {
+        return GetCachedPathView(RL_PATH_RUNNING_EXECUTABLE, outPath, outLength);
+    });
 }
 
 RPXLoaderStatus RPXLoader_GetPathOfSaveRedirection(char *outBuffer, uint32_t outSize) {
-    if (rpxLoaderVersion == RPX_LOADER_MODULE_VERSION_ERROR) {
-        return RPX_LOADER_RESULT_LIB_UNINITIALIZED;
-    }
-    if (sRL_GetPathOfSaveRedirection == nullptr || rpxLoaderVersion < 3) {
-        return RPX_LOADER_RESULT_UNSUPPORTED_COMMAND;
-    }
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_GET_PATH_OF_SAVE_REDIRECTION, [&]() -> RPXLoaderStatus {
+        return CopyCachedPath(RL_PATH_SAVE_REDIRECTION, outBuffer, outSize, nullptr, true);
+    });
+}
+
+RPXLoaderStatus RPXLoader_GetPathOfSaveRedirectionEx(char *outBuffer, uint32_t outSize, uint32_t *outRequiredSize) {
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_GET_PATH_OF_SAVE_REDIRECTION, [&]() -> RPXLoaderStatus {
+        return CopyCachedPath(RL_PATH_SAVE_REDIRECTION, outBuffer, outSize, outRequiredSize, false);
+    });
+}
 
-    return reinterpret_cast<decltype(&RPXLoader_GetPathOfSaveRedirection)>(sRL_GetPathOfSaveRedirection)(outBuffer, outSize);
+RPXLoaderStatus RPXLoader_GetPathOfSaveRedirectionView(const char **outPath, uint32_t *outLength) {
+    LOG_FUNCTION_NAME();
+    return Stats_Measure(RPX_LOADER_STATS_API_GET_PATH_OF_SAVE_REDIRECTION, [&]() -> RPXLoaderStatus {
+        return GetCachedPathView(RL_PATH_SAVE_REDIRECTION, outPath, outLength);
+    });
 }
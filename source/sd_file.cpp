@@ -0,0 +1,77 @@
+#include "sd_file.h"
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <sys/types.h>
+
+// .wuhb files can be larger than 2 GiB, long based seeking would cut them off on PPC.
+static_assert(sizeof(off_t) >= sizeof(uint64_t), "SDFile needs a 64 bit off_t");
+
+bool SDFile_BuildPath(char *outPath, uint32_t outSize, const char *path) {
+    while (*path == '/') {
+        path++;
+    }
+    auto rootLength = strlen(RPX_LOADER_SD_ROOT);
+    auto pathLength = strlen(path);
+    if (rootLength + pathLength + 1 > outSize) {
+        return false;
+    }
+    memcpy(outPath, RPX_LOADER_SD_ROOT, rootLength);
+    memcpy(outPath + rootLength, path, pathLength + 1);
+    return true;
+}
+
+void *SDFile_AllocBuffer(uint32_t size) {
+    return memalign(RPX_LOADER_IO_ALIGNMENT, (size + RPX_LOADER_IO_ALIGNMENT - 1) & ~(RPX_LOADER_IO_ALIGNMENT - 1));
+}
+
+bool SDFile::Open(const char *path) {
+    Close();
+    char fullPath[0x280];
+    if (!SDFile_BuildPath(fullPath, sizeof(fullPath), path)) {
+        return false;
+    }
+    mFile = fopen(fullPath, "rb");
+    if (mFile == nullptr) {
+        return false;
+    }
+    // We only ever read big chunks into our own buffers, the stdio buffer would just add a copy.
+    setvbuf(mFile, nullptr, _IONBF, 0);
+    if (fseeko(mFile, 0, SEEK_END) != 0) {
+        Close();
+        return false;
+    }
+    auto size = ftello(mFile);
+    if (size < 0 || fseeko(mFile, 0, SEEK_SET) != 0) {
+        Close();
+        return false;
+    }
+    mSize     = (uint64_t) size;
+    mPosition = 0;
+    return true;
+}
+
+void SDFile::Close() {
+    if (mFile != nullptr) {
+        fclose(mFile);
+        mFile = nullptr;
+    }
+    mSize     = 0;
+    mPosition = 0;
+}
+
+bool SDFile::ReadAt(uint64_t offset, void *buffer, uint32_t size) {
+    if (mFile == nullptr || offset > mSize || size > mSize - offset) {
+        return false;
+    }
+    if (offset != mPosition) {
+        if (fseeko(mFile, (off_t) offset, SEEK_SET) != 0) {
+            mPosition = UINT64_MAX;
+            return false;
+        }
+        mPosition = offset;
+    }
+    auto read = fread(buffer, 1, size, mFile);
+    mPosition += read;
+    return read == size;
+}
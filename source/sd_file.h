@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+
+// All paths passed to this lib are relative to the root of the sd card.
+#ifndef RPX_LOADER_SD_ROOT
+#define RPX_LOADER_SD_ROOT "fs:/vol/external01/"
+#endif
+
+// Reads of this size and alignment can be DMA'd into the target buffer directly by the FS.
+#define RPX_LOADER_IO_ALIGNMENT  0x40
+#define RPX_LOADER_IO_CHUNK_SIZE 0x20000
+
+/**
+ * Prepends RPX_LOADER_SD_ROOT to the given path. Returns false if outPath is too small.
+ */
+bool SDFile_BuildPath(char *outPath, uint32_t outSize, const char *path);
+
+/**
+ * Allocates a RPX_LOADER_IO_ALIGNMENT aligned buffer, has to be freed via free().
+ */
+void *SDFile_AllocBuffer(uint32_t size);
+
+/**
+ * Unbuffered read-only file on the sd card.
+ */
+class SDFile {
+public:
+    SDFile() = default;
+
+    ~SDFile() {
+        Close();
+    }
+
+    SDFile(const SDFile &)            = delete;
+    SDFile &operator=(const SDFile &) = delete;
+
+    /**
+     * @param path path relative to the root of the sd card
+     */
+    bool Open(const char *path);
+
+    void Close();
+
+    bool IsOpen() const {
+        return mFile != nullptr;
+    }
+
+    uint64_t GetSize() const {
+        return mSize;
+    }
+
+    /**
+     * Reads exactly size bytes at the given offset. Returns false on errors and short reads.
+     */
+    bool ReadAt(uint64_t offset, void *buffer, uint32_t size);
+
+private:
+    FILE *mFile        = nullptr;
+    uint64_t mSize     = 0;
+    uint64_t mPosition = 0;
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+enum RPXLoaderShutdownHook {
+    RL_SHUTDOWN_HOOK_ASYNC_LAUNCH,
+    RL_SHUTDOWN_HOOK_ACCESS_PROFILE,
+    RL_SHUTDOWN_HOOK_COUNT,
+};
+
+/**
+ * Makes RPXLoader_DeInitLibrary call func before the module is released, hooks run in the order of
+ * RPXLoaderShutdownHook. Optional features register their hook the first time they're used, so rpxloader.cpp doesn't
+ * reference them and apps that never use them don't link them (and their dependencies like zlib or threads).
+ */
+void ShutdownHook_Register(RPXLoaderShutdownHook hook, void (*func)());
@@ -0,0 +1,117 @@
+#include "stats.h"
+#include <atomic>
+#include <coreinit/core.h>
+#include <cstring>
+
+RPXLoaderStatsStatus RPXLoader_GetStatsStatus(RPXLoaderStatus status) {
+    switch (status) {
+        case RPX_LOADER_RESULT_SUCCESS:
+            return RPX_LOADER_STATS_STATUS_SUCCESS;
+        case RPX_LOADER_RESULT_INVALID_ARGUMENT:
+            return RPX_LOADER_STATS_STATUS_INVALID_ARGUMENT;
+        case RPX_LOADER_RESULT_NOT_FOUND:
+            return RPX_LOADER_STATS_STATUS_NOT_FOUND;
+        case RPX_LOADER_RESULT_UNSUPPORTED_API_VERSION:
+            return RPX_LOADER_STATS_STATUS_UNSUPPORTED_API_VERSION;
+        case RPX_LOADER_RESULT_UNSUPPORTED_COMMAND:
+            return RPX_LOADER_STATS_STATUS_UNSUPPORTED_COMMAND;
+        case RPX_LOADER_RESULT_LIB_UNINITIALIZED:
+            return RPX_LOADER_STATS_STATUS_LIB_UNINITIALIZED;
+        case RPX_LOADER_RESULT_MODULE_NOT_FOUND:
+            return RPX_LOADER_STATS_STATUS_MODULE_NOT_FOUND;
+        case RPX_LOADER_RESULT_MODULE_MISSING_EXPORT:
+            return RPX_LOADER_STATS_STATUS_MODULE_MISSING_EXPORT;
+        case RPX_LOADER_RESULT_NOT_AVAILABLE:
+            return RPX_LOADER_STATS_STATUS_NOT_AVAILABLE;
+        case RPX_LOADER_RESULT_CANCELLED:
+            return RPX_LOADER_STATS_STATUS_CANCELLED;
+        case RPX_LOADER_RESULT_UNKNOWN_ERROR:
+            break;
+    }
+    return RPX_LOADER_STATS_STATUS_OTHER;
+}
+
+#ifdef RPX_LOADER_ENABLE_STATS
+struct StatsCounters {
+    std::atomic<uint32_t> calls;
+    std::atomic<uint32_t> statusCounts[RPX_LOADER_STATS_STATUS_COUNT];
+    std::atomic<uint32_t> latencyHistogram[RPX_LOADER_STATS_LATENCY_BUCKETS];
+};
+
+// Every core only writes its own counters, the alignment keeps them in separate cache lines.
+struct alignas(64) StatsCore {
+    StatsCounters apis[RPX_LOADER_STATS_API_COUNT];
+};
+
+static StatsCore sStatsCores[RPX_LOADER_STATS_CORE_COUNT];
+
+static uint32_t GetLatencyBucket(uint32_t ticks) {
+    if (ticks == 0) {
+        return 0;
+    }
+    uint32_t bucket = 32 - __builtin_clz(ticks);
+    return bucket < RPX_LOADER_STATS_LATENCY_BUCKETS ? bucket : RPX_LOADER_STATS_LATENCY_BUCKETS - 1;
+}
+
+void Stats_Record(RPXLoaderStatsAPI api, uint32_t ticks, RPXLoaderStatus status) {
+    auto core = OSGetCoreId();
+    if (core >= RPX_LOADER_STATS_CORE_COUNT) {
+        core = 0;
+    }
+    // The atomics only protect against a thread being preempted by another one on the same core.
+    auto &counters = sStatsCores[core].apis[api];
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.statusCounts[RPXLoader_GetStatsStatus(status)].fetch_add(1, std::memory_order_relaxed);
+    counters.latencyHistogram[GetLatencyBucket(ticks)].fetch_add(1, std::memory_order_relaxed);
+}
+
+RPXLoaderStatus RPXLoader_GetStats(RPXLoaderStats *outStats) {
+    if (outStats == nullptr) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    memset(outStats, 0, sizeof(*outStats));
+    outStats->ticksPerSecond = OSTimerClockSpeed;
+    for (uint32_t core = 0; core < RPX_LOADER_STATS_CORE_COUNT; core++) {
+        for (uint32_t api = 0; api < RPX_LOADER_STATS_API_COUNT; api++) {
+            auto &counters = sStatsCores[core].apis[api];
+            auto &out      = outStats->apis[api];
+            auto calls     = counters.calls.load(std::memory_order_relaxed);
+            out.calls += calls;
+            out.callsPerCore[core] = calls;
+            for (uint32_t i = 0; i < RPX_LOADER_STATS_STATUS_COUNT; i++) {
+                out.statusCounts[i] += counters.statusCounts[i].load(std::memory_order_relaxed);
+            }
+            for (uint32_t i = 0; i < RPX_LOADER_STATS_LATENCY_BUCKETS; i++) {
+                out.latencyHistogram[i] += counters.latencyHistogram[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    return RPX_LOADER_RESULT_SUCCESS;
+}
+
+RPXLoaderStatus RPXLoader_ResetStats() {
+    for (auto &core : sStatsCores) {
+        for (auto &counters : core.apis) {
+            counters.calls.store(0, std::memory_order_relaxed);
+            for (auto &count : counters.statusCounts) {
+                count.store(0, std::memory_order_relaxed);
+            }
+            for (auto &count : counters.latencyHistogram) {
+                count.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+    return RPX_LOADER_RESULT_SUCCESS;
+}
+#else
+RPXLoaderStatus RPXLoader_GetStats(RPXLoaderStats *outStats) {
+    if (outStats == nullptr) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+    return RPX_LOADER_RESULT_NOT_AVAILABLE;
+}
+
+RPXLoaderStatus RPXLoader_ResetStats() {
+    return RPX_LOADER_RESULT_NOT_AVAILABLE;
+}
+#endif
@@ -0,0 +1,25 @@
+#pragma once
+#include <rpxloader/stats.h>
+
+#ifdef RPX_LOADER_ENABLE_STATS
+#include <coreinit/time.h>
+
+void Stats_Record(RPXLoaderStatsAPI api, uint32_t ticks, RPXLoaderStatus status);
+#endif
+
+/**
+ * Calls func and records its result and duration for the given API.
+ * Without RPX_LOADER_ENABLE_STATS this is nothing but the call of func. <br>
+ * The calling function should declare LOG_FUNCTION_NAME(), otherwise log sites in func report "operator()".
+ */
+template<typename Func>
+static inline RPXLoaderStatus Stats_Measure([[maybe_unused]] RPXLoaderStatsAPI api, Func &&func) {
+#ifdef RPX_LOADER_ENABLE_STATS
+    auto start = OSGetSystemTick();
+    auto res   = func();
+    Stats_Record(api, (uint32_t) (OSGetSystemTick() - start), res);
+    return res;
+#else
+    return func();
+#endif
+}
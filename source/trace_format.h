@@ -0,0 +1,84 @@
+#pragma once
+#include "byte_order.h"
+#include <cstdint>
+#include <cstring>
+
+// Layout of the launch trace file, all values are big endian. Also used by host/tools/trace2json.cpp.
+// A header is followed by fixed size records, every process that traces a launch appends its records.
+
+#define TRACE_FILE_MAGIC   0x524C5452 // "RLTR"
+#define TRACE_FILE_VERSION 1
+#define TRACE_HEADER_SIZE  0x10
+#define TRACE_RECORD_SIZE  0x40
+#define TRACE_NAME_SIZE    0x20
+
+enum TraceSource {
+    TRACE_SOURCE_LIB    = 0,
+    TRACE_SOURCE_MODULE = 1,
+};
+
+struct TraceHeader {
+    uint32_t magic;
+    uint16_t version;
+    // Readers have to use this as stride, newer versions may append fields to a record.
+    uint16_t recordSize;
+    // Frequency of the ticks in the records.
+    uint32_t ticksPerSecond;
+};
+
+struct TraceRecord {
+    // Identifies the launch the phase belongs to, the same in the launcher and the relaunched app.
+    uint32_t launchId;
+    uint16_t phase;
+    uint16_t source;
+    uint64_t begin;
+    uint64_t end;
+    // 0 if the lib wasn't initialized.
+    uint32_t moduleVersion;
+    int32_t status;
+    // File name of the launched .rpx/.wuhb, null terminated.
+    char name[TRACE_NAME_SIZE];
+};
+
+static inline void TraceFile_StoreHeader(uint8_t *data, const TraceHeader &header) {
+    StoreBE32(data, header.magic);
+    StoreBE16(data + 0x04, header.version);
+    StoreBE16(data + 0x06, header.recordSize);
+    StoreBE32(data + 0x08, header.ticksPerSecond);
+    StoreBE32(data + 0x0C, 0);
+}
+
+/**
+ * Returns false if the data isn't the header of a trace file this code can read.
+ */
+static inline bool TraceFile_LoadHeader(const uint8_t *data, TraceHeader *outHeader) {
+    outHeader->magic          = LoadBE32(data);
+    outHeader->version        = LoadBE16(data + 0x04);
+    outHeader->recordSize     = LoadBE16(data + 0x06);
+    outHeader->ticksPerSecond = LoadBE32(data + 0x08);
+    return outHeader->magic == TRACE_FILE_MAGIC && outHeader->version >= TRACE_FILE_VERSION &&
+           outHeader->recordSize >= TRACE_RECORD_SIZE && outHeader->ticksPerSecond != 0;
+}
+
+static inline void TraceFile_StoreRecord(uint8_t *data, const TraceRecord &record) {
+    StoreBE32(data, record.launchId);
+    StoreBE16(data + 0x04, record.phase);
+    StoreBE16(data + 0x06, record.source);
+    StoreBE64(data + 0x08, record.begin);
+    StoreBE64(data + 0x10, record.end);
+    StoreBE32(data + 0x18, record.moduleVersion);
+    StoreBE32(data + 0x1C, (uint32_t) record.status);
+    memcpy(data + 0x20, record.name, TRACE_NAME_SIZE);
+}
+
+static inline void TraceFile_LoadRecord(const uint8_t *data, TraceRecord *outRecord) {
+    outRecord->launchId      = LoadBE32(data);
+    outRecord->phase         = LoadBE16(data + 0x04);
+    outRecord->source        = LoadBE16(data + 0x06);
+    outRecord->begin         = LoadBE64(data + 0x08);
+    outRecord->end           = LoadBE64(data + 0x10);
+    outRecord->moduleVersion = LoadBE32(data + 0x18);
+    outRecord->status        = (int32_t) LoadBE32(data + 0x1C);
+    memcpy(outRecord->name, data + 0x20, TRACE_NAME_SIZE);
+    outRecord->name[TRACE_NAME_SIZE - 1] = '\0';
+}
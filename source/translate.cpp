@@ -0,0 +1,127 @@
+#include "dispatch.h"
+#include "path_cache.h"
+#include <cstring>
+#include <rpxloader/translate.h>
+#include <strings.h>
+
+namespace {
+    /**
+     * Where a volume is redirected to, looked up at most once per call.
+     */
+    struct VolumeTarget {
+        bool loaded = false;
+        RPXLoaderStatus status;
+        RPXLoaderPathLocation location;
+        const char *prefix;
+        uint32_t prefixLength;
+    };
+} // namespace
+
+static void LoadSaveTarget(VolumeTarget &target) {
+    target.location = RPX_LOADER_PATH_LOCATION_SD;
+    target.status   = PathCache_Get(RL_PATH_SAVE_REDIRECTION, &target.prefix, &target.prefixLength);
+    // "dir/" + "file" must not become "dir//file".
+    while (target.status == RPX_LOADER_RESULT_SUCCESS && target.prefixLength > 0 && target.prefix[target.prefixLength - 1] == '/') {
+        target.prefixLength--;
+    }
+}
+
+static void LoadContentTarget(VolumeTarget &target) {
+    target.location = RPX_LOADER_PATH_LOCATION_BUNDLE;
+    const char *path;
+    uint32_t length;
+    target.status = PathCache_Get(RL_PATH_RUNNING_EXECUTABLE, &path, &length);
+    // /vol/content is only redirected for bundles.
+    if (target.status == RPX_LOADER_RESULT_SUCCESS && (length < 5 || strcasecmp(path + length - 5, ".wuhb") != 0)) {
+        target.status = RPX_LOADER_RESULT_NOT_AVAILABLE;
+    }
+    target.prefix       = "content";
+    target.prefixLength = 7;
+}
+
+/**
+ * Checks if path is the volume itself or a path inside it and returns the part after the volume.
+ */
+static bool MatchVolume(const char *path, const char *volume, uint32_t volumeLength, const char **outRest) {
+    if (strncmp(path, volume, volumeLength) != 0 || (path[volumeLength] != '\0' && path[volumeLength] != '/')) {
+        return false;
+    }
+    auto rest = path + volumeLength;
+    while (*rest == '/') {
+        rest++;
+    }
+    *outRest = rest;
+    return true;
+}
+
+RPXLoaderStatus RPXLoader_TranslatePaths(const char *const *paths, uint32_t count, char *arena, uint32_t arenaSize, RPXLoaderTranslatedPath *outPaths, uint32_t *outRequiredSize) {
+    if (gDispatch.load(std::memory_order_acquire) == nullptr) {
+        return RPX_LOADER_RESULT_LIB_UNINITIALIZED;
+    }
+    if (paths == nullptr || outPaths == nullptr || (arena == nullptr && arenaSize != 0)) {
+        return RPX_LOADER_RESULT_INVALID_ARGUMENT;
+    }
+
+    VolumeTarget save;
+    VolumeTarget content;
+    RPXLoaderStatus result = RPX_LOADER_RESULT_SUCCESS;
+    uint32_t required      = 0;
+    bool arenaFull         = false;
+    for (uint32_t i = 0; i < count; i++) {
+        auto &out    = outPaths[i];
+        out.path     = nullptr;
+        out.length   = 0;
+        out.location = RPX_LOADER_PATH_LOCATION_SD;
+
+        auto path            = paths[i];
+        const char *rest     = nullptr;
+        VolumeTarget *target = nullptr;
+        if (path != nullptr && MatchVolume(path, "/vol/save", 9, &rest)) {
+            target = &save;
+            if (!save.loaded) {
+                LoadSaveTarget(save);
+                save.loaded = true;
+            }
+        } else if (path != nullptr && MatchVolume(path, "/vol/content", 12, &rest)) {
+            target = &content;
+            if (!content.loaded) {
+                LoadContentTarget(content);
+                content.loaded = true;
+            }
+        }
+
+        if (target == nullptr) {
+            out.status = RPX_LOADER_RESULT_INVALID_ARGUMENT;
+        } else if (target->status != RPX_LOADER_RESULT_SUCCESS) {
+            out.status   = target->status;
+            out.location = target->location;
+        } else {
+            uint32_t restLength = strlen(rest);
+            uint32_t length     = target->prefixLength + (restLength > 0 ? 1 + restLength : 0);
+            required += length + 1;
+            out.location = target->location;
+            if (arenaFull || arenaSize - (required - length - 1) < length + 1) {
+                arenaFull  = true;
+                out.status = RPX_LOADER_RESULT_INVALID_ARGUMENT;
+            } else {
+                auto dest = arena + required - length - 1;
+                memcpy(dest, target->prefix, target->prefixLength);
+                if (restLength > 0) {
+                    dest[target->prefixLength] = '/';
+                    memcpy(dest + target->prefixLength + 1, rest, restLength);
+                }
+                dest[length] = '\0';
+                out.path     = dest;
+                out.length   = length;
+                out.status   = RPX_LOADER_RESULT_SUCCESS;
+            }
+        }
+        if (out.status != RPX_LOADER_RESULT_SUCCESS && result == RPX_LOADER_RESULT_SUCCESS) {
+            result = out.status;
+        }
+    }
+    if (outRequiredSize != nullptr) {
+        *outRequiredSize = required;
+    }
+    return result;
+}